@@ -1,21 +1,70 @@
 #include "Application.hpp"
 
+#include <array>
 #include <chrono>
+#include <stdexcept>
+#include <string>
+#include <string_view>
 
+#include "helper.hpp"
 #include "resource/SceneLoader.hpp"
 
-Application::Application()
+ApplicationOptions ApplicationOptions::parse(std::span<char*> arguments)
 {
-	auto scene = SceneLoader::loadScene(ASSETS_DIR "/teapot.gltf");
+	ApplicationOptions options;
+	for (size_t i = 1; i < arguments.size(); i++) {
+		std::string_view argument = arguments[i];
+
+		// options taking a value read the argument after them
+		auto value = [&]() -> std::string {
+			if (++i == arguments.size())
+				throw std::runtime_error("missing value for option: " + std::string(argument));
+			return arguments[i];
+		};
+
+		if (argument == "--stats")
+			options.statistics = true;
+		else if (argument == "--no-prepass")
+			options.depth_prepass = false;
+		else if (argument == "--benchmark")
+			options.benchmark = true;
+		else if (argument == "--self-test")
+			options.self_test = true;
+		else if (argument == "--static-batching")
+			options.static_batching = true;
+		else if (argument == "--vertex-pulling")
+			options.vertex_pulling = true;
+		else if (argument == "--lod-threshold")
+			options.lod_threshold = std::stof(value());
+		else
+			throw std::runtime_error("unknown option: " + std::string(argument));
+	}
+
+	return options;
+}
+
+Application::Application(const ApplicationOptions& options)
+    : options(options)
+{
+	auto scene = SceneLoader::loadScene(ASSETS_DIR "/teapot.gltf", {.meshlets = true, .lods = true});
 	window = std::make_unique<Window>("VKEngine", 2560, 1440);
 	level = std::make_unique<Level>();
 	level->setActiveScene(std::move(scene));
 	renderer = std::make_unique<Renderer>(*window);
+	renderer->setDepthPrepass(options.depth_prepass);
+	renderer->setStaticBatching(options.static_batching);
+	renderer->setVertexPulling(options.vertex_pulling);
+	renderer->setLodThreshold(options.lod_threshold);
 	renderer->setActiveLevel(*level);
 }
 
 void Application::run()
 {
+	if (options.benchmark) {
+		constexpr std::array<uint32_t, 3> draw_counts = {1000, 10000, 100000};
+		printDrawBenchmark(renderer->benchmarkDrawSubmission(draw_counts));
+	}
+
 	while (!window->shouldClose()) {
 		elapseTime();
 
@@ -35,6 +84,7 @@ void Application::elapseTime()
 void Application::tickGui(float dt)
 {
 	window->pollEvents();
+	handleKeys();
 }
 
 void Application::tickLogic(float dt)
@@ -45,8 +95,60 @@ void Application::tickLogic(float dt)
 
 void Application::tickRender(float dt)
 {
-	if (renderer)
-		renderer->tick(dt);
+	if (!renderer)
+		return;
+
+	renderer->tick(dt);
+
+	report_time += dt;
+	if (options.statistics && report_time >= 1.0f) {
+		report_time = 0.0f;
+		report();
+	}
+}
+
+// P toggles the depth pre-pass, V vertex pulling, M meshlet culling, L levels of detail, R the
+// statistics report
+void Application::handleKeys()
+{
+	for (auto key : window->getPressedKeys()) {
+		switch (key) {
+		case SDLK_P:
+			renderer->setDepthPrepass(!renderer->depth_prepass);
+			std::println("Depth pre-pass: {}", renderer->depth_prepass ? "on" : "off");
+			break;
+		case SDLK_V:
+			renderer->setVertexPulling(!renderer->vertex_pulling);
+			std::println("Vertex pulling: {}", renderer->vertex_pulling ? "on" : "off");
+			break;
+		case SDLK_M:
+			renderer->setMeshletCulling(!renderer->meshlet_culling);
+			std::println("Meshlet culling: {}", renderer->meshlet_culling ? "on" : "off");
+			break;
+		case SDLK_L:
+			renderer->setLodThreshold(renderer->lod_threshold > 0.0f ? 0.0f : options.lod_threshold);
+			std::println("Level of detail threshold: {} px", renderer->lod_threshold);
+			break;
+		case SDLK_R:
+			options.statistics = !options.statistics;
+			report_time = 0.0f;
+			break;
+		}
+	}
+}
+
+void Application::report()
+{
+	printPipelineStatistics(renderer->prepass_statistics, renderer->main_statistics);
+	if (renderer->render_scene) {
+		const auto& scene = *renderer->render_scene;
+		auto        count = scene.isGpuCulled() ? scene.getClusterCount() : scene.getInstanceCount();
+		printCullStatistics(renderer->cull_statistics, count, scene.isGpuCulled());
+	}
+	if (renderer->dynamic_rendering) {
+		printRenderGraph(renderer->render_graph);
+		printTransientMemory(*renderer->transient_pool);
+	}
 }
 
 void Application::loadLevel(std::unique_ptr<Level>&& new_level)
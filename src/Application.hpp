@@ -1,22 +1,38 @@
 #pragma once
 
 #include <memory>
+#include <span>
 
 #include "gui/Window.hpp"
 #include "render/Renderer.hpp"
 #include "scene/Level.hpp"
 
+struct ApplicationOptions {
+	bool  statistics{};          // --stats, reports the renderer's statistics once a second
+	bool  depth_prepass{true};   // --no-prepass
+	bool  benchmark{};           // --benchmark, compares direct and indirect draw recording first
+	bool  self_test{};           // --self-test, checks the CPU culling paths and exits
+	bool  static_batching{};     // --static-batching
+	bool  vertex_pulling{};      // --vertex-pulling
+	float lod_threshold{1.0f};   // --lod-threshold <pixels>, 0 keeps every mesh in full detail
+
+	static auto parse(std::span<char*> arguments) -> ApplicationOptions;
+};
+
 class Application {
 private:
 	std::unique_ptr<Window>   window;
 	std::unique_ptr<Level>    level;
 	std::unique_ptr<Renderer> renderer;
 
+	ApplicationOptions options;
+
 	float last_time{0.0f};
 	float delta_time{0.0f};
+	float report_time{0.0f};
 
 public:
-	Application();
+	Application(const ApplicationOptions& options = {});
 	~Application() = default;
 
 	Application(const Application&) = delete;
@@ -32,6 +48,9 @@ public:
 	void tickLogic(float dt);
 	void tickRender(float dt);
 
+	void handleKeys();
+	void report();
+
 	void loadLevel(std::unique_ptr<Level>&& level);
 	void loadRenderer(std::unique_ptr<Renderer>&& renderer);
 };
@@ -0,0 +1,53 @@
+#include "SelfTest.hpp"
+
+#include <cstdio>
+#include <memory>
+#include <print>
+#include <vector>
+
+#include "render/RenderSelfTest.hpp"
+#include "render/culling/CullingSelfTest.hpp"
+#include "scene/spatial/SpatialSelfTest.hpp"
+
+SelfTest::SelfTest(std::string_view name) :
+    name(name)
+{}
+
+void SelfTest::check(std::string_view description, bool passed)
+{
+	std::println("  {:6} {}", passed ? "ok" : "FAIL", description);
+	failures += !passed;
+}
+
+std::string_view SelfTest::getName() const
+{
+	return name;
+}
+
+uint32_t SelfTest::getFailures() const
+{
+	return failures;
+}
+
+uint32_t SelfTest::runAll()
+{
+	std::vector<std::unique_ptr<SelfTest>> tests;
+	tests.push_back(std::make_unique<CullingSelfTest>());
+	tests.push_back(std::make_unique<RenderSelfTest>());
+	tests.push_back(std::make_unique<SpatialSelfTest>());
+
+	std::println("\n=================== Self Test ===================");
+
+	uint32_t failures = 0;
+	for (const auto& test : tests) {
+		std::println("{}", test->getName());
+		test->run();
+		failures += test->getFailures();
+	}
+
+	std::println("{} failed", failures);
+	std::println("=================================================\n");
+	std::fflush(stdout);
+
+	return failures;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+// checks against cases whose answers are known, needing neither a window nor a GPU; each area
+// derives its own, and --self-test runs them all
+class SelfTest {
+private:
+	std::string_view name;
+	uint32_t         failures{};
+
+protected:
+	SelfTest(std::string_view name);
+
+	void check(std::string_view description, bool passed);
+
+public:
+	SelfTest(const SelfTest&) = delete;
+	SelfTest& operator=(const SelfTest&) = delete;
+
+	SelfTest(SelfTest&&) noexcept = default;
+	SelfTest& operator=(SelfTest&&) noexcept = default;
+
+	virtual ~SelfTest() = default;
+
+	virtual void run() = 0;
+
+	auto getName() const -> std::string_view;
+	auto getFailures() const -> uint32_t;
+
+	// prints every check and returns how many failed
+	static auto runAll() -> uint32_t;
+};
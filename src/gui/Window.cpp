@@ -26,12 +26,16 @@ Window::~Window()
 
 void Window::pollEvents()
 {
+	pressed_keys.clear();
+
 	SDL_Event event;
 	while (SDL_PollEvent(&event)) {
 		switch (event.type) {
 		case SDL_EventType::SDL_EVENT_KEY_DOWN:
 			if (event.key.key == SDLK_ESCAPE)
 				should_close = true;
+			else if (!event.key.repeat)
+				pressed_keys.push_back(event.key.key);
 			break;
 		}
 	}
@@ -57,6 +61,11 @@ bool Window::shouldClose() const
 	return should_close;
 }
 
+std::span<const SDL_Keycode> Window::getPressedKeys() const
+{
+	return pressed_keys;
+}
+
 void Window::setTitle(std::string_view title)
 {
 	this->title = title;
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <span>
 #include <string_view>
+#include <vector>
 
 #include <vulkan/vulkan.hpp>
 #include <SDL3/SDL.h>
@@ -15,6 +17,9 @@ private:
 	uint32_t    height{};
 	bool        should_close{};
 
+	// pressed since the last pollEvents, key repeats left out
+	std::vector<SDL_Keycode> pressed_keys;
+
 public:
 	Window(std::string_view title, int width, int height);
 	~Window();
@@ -26,6 +31,8 @@ public:
 	uint32_t    getHeight() const;
 	bool        shouldClose() const;
 
+	auto getPressedKeys() const -> std::span<const SDL_Keycode>;
+
 	void setTitle(std::string_view title);
 	void setWidth(uint32_t width);
 	void setHeight(uint32_t height);
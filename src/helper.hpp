@@ -10,6 +10,9 @@
 #include "scene/components/Camera.hpp"
 #include "scene/components/Material.hpp"
 #include "scene/components/Light.hpp"
+#include "render/graphics/StatisticsQuery.hpp"
+#include "render/TransientPool.hpp"
+#include "render/Renderer.hpp"
 
 inline void printSceneNodes(const Scene& scene)
 {
@@ -456,3 +459,66 @@ inline void printSubmeshDetailed(const SubMesh& submesh)
 	std::println("\n════════════════════════════════════════════\n");
 	std::fflush(stdout);
 }
+
+inline void printPipelineStatistics(const PipelineStatistics& prepass, const PipelineStatistics& main)
+{
+	std::println("\n============== Pipeline Statistics ==============");
+	std::println("{:16} {:>14} {:>14}", "", "pre-pass", "main pass");
+	std::println("{:16} {:>14} {:>14}", "IA vertices", prepass.input_assembly_vertices, main.input_assembly_vertices);
+	std::println("{:16} {:>14} {:>14}", "VS invocations", prepass.vertex_shader_invocations, main.vertex_shader_invocations);
+	std::println("{:16} {:>14} {:>14}", "Clip primitives", prepass.clipping_primitives, main.clipping_primitives);
+	std::println("{:16} {:>14} {:>14}", "FS invocations", prepass.fragment_shader_invocations, main.fragment_shader_invocations);
+	std::println("=================================================\n");
+	std::fflush(stdout);
+}
+
+inline void printTransientMemory(const TransientPool& pool)
+{
+	auto to_mib = [](vk::DeviceSize size) { return static_cast<double>(size) / (1024.0 * 1024.0); };
+
+	std::println("\n=============== Transient Memory ================");
+	std::println("{:16} {:>10.2f} MiB", "Naive", to_mib(pool.getNaiveSize()));
+	std::println("{:16} {:>10.2f} MiB", "Aliased", to_mib(pool.getAliasedSize()));
+	std::println("{:16} {:>10.2f} MiB", "Lazily allocated", to_mib(pool.getLazySize()));
+	std::println("{:16} {:>10.2f} MiB", "Saved", to_mib(pool.getNaiveSize() - pool.getAliasedSize()));
+	std::println("=================================================\n");
+	std::fflush(stdout);
+}
+
+inline void printRenderGraph(const RenderGraph& graph)
+{
+	std::println("\n================= Render Graph ==================");
+	std::println("{:16} {:>10}", "Passes", graph.getSchedule().size());
+	std::println("{:16} {:>10}", "Culled passes", graph.getCulledPassCount());
+	std::println("{:16} {:>10}", "Barriers", graph.getBarrierCount());
+	std::println("=================================================\n");
+	std::fflush(stdout);
+}
+
+inline void printDrawBenchmark(std::span<const DrawBenchmark> results)
+{
+	std::println("\n=========== Draw Submission (CPU record) ===========");
+	std::println("{:>10} {:>14} {:>14} {:>10}", "draws", "direct ms", "indirect ms", "speedup");
+	for (const auto& result : results)
+		std::println("{:>10} {:>14.3f} {:>14.3f} {:>9.1f}x",
+		             result.draw_count, result.direct_ms, result.indirect_ms,
+		             result.indirect_ms > 0.0 ? result.direct_ms / result.indirect_ms : 0.0);
+	std::println("====================================================\n");
+	std::fflush(stdout);
+}
+
+// the GPU culls commands, meshlets among them, the CPU culls instances; count is how many there are
+inline void printCullStatistics(const GpuCullStatistics& statistics, uint32_t count, bool gpu_culled)
+{
+	std::println("\n================ Culling (last frame) ================");
+	std::println("{}: {}", gpu_culled ? "Commands" : "Instances", count);
+	std::println("Frustum culled: {}", statistics.frustum_culled);
+	std::println("Backface culled: {}", statistics.backface_culled);
+	std::println("Occlusion culled: {}", statistics.occlusion_culled);
+	if (gpu_culled)
+		std::println("Skipped for another level of detail: {}", statistics.lod_skipped);
+	std::println("Drawn: {}", statistics.drawn);
+	std::println("Triangles: {} at full detail, {} drawn", statistics.triangles_full, statistics.triangles_drawn);
+	std::println("======================================================\n");
+	std::fflush(stdout);
+}
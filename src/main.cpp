@@ -1,8 +1,13 @@
 #include "Application.hpp"
+#include "SelfTest.hpp"
 
 int main(int argc, char** argv)
 {
-	Application app;
+	auto options = ApplicationOptions::parse({argv, static_cast<size_t>(argc)});
+	if (options.self_test)
+		return SelfTest::runAll() == 0 ? 0 : 1;
+
+	Application app(options);
 	app.run();
 
 	return 0;
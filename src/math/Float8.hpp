@@ -0,0 +1,247 @@
+#pragma once
+
+#include <cstdint>
+
+#if defined(__AVX2__)
+	#include <immintrin.h>
+	#define FLOAT8_AVX2
+#elif defined(__SSE2__) || defined(_M_X64)
+	#include <emmintrin.h>
+	#define FLOAT8_SSE
+#elif defined(__ARM_NEON)
+	#include <arm_neon.h>
+	#define FLOAT8_NEON
+#else
+	#include <array>
+#endif
+
+// eight lanes of a comparison, all bits set where it held
+struct Mask8 {
+#if defined(FLOAT8_AVX2)
+	__m256 value;
+#elif defined(FLOAT8_SSE)
+	__m128 lo, hi;
+#elif defined(FLOAT8_NEON)
+	uint32x4_t lo, hi;
+#else
+	uint32_t bits;
+#endif
+
+	// lane i in bit i
+	auto getBits() const -> uint32_t
+	{
+#if defined(FLOAT8_AVX2)
+		return static_cast<uint32_t>(_mm256_movemask_ps(value));
+#elif defined(FLOAT8_SSE)
+		return static_cast<uint32_t>(_mm_movemask_ps(lo) | _mm_movemask_ps(hi) << 4);
+#elif defined(FLOAT8_NEON)
+		return (vgetq_lane_u32(lo, 0) & 1) | (vgetq_lane_u32(lo, 1) & 2) | (vgetq_lane_u32(lo, 2) & 4) | (vgetq_lane_u32(lo, 3) & 8) |
+		       (vgetq_lane_u32(hi, 0) & 16) | (vgetq_lane_u32(hi, 1) & 32) | (vgetq_lane_u32(hi, 2) & 64) | (vgetq_lane_u32(hi, 3) & 128);
+#else
+		return bits;
+#endif
+	}
+
+	bool any() const
+	{
+		return getBits() != 0;
+	}
+
+	bool all() const
+	{
+		return getBits() == 0xff;
+	}
+
+	friend Mask8 operator&(const Mask8& a, const Mask8& b)
+	{
+#if defined(FLOAT8_AVX2)
+		return {_mm256_and_ps(a.value, b.value)};
+#elif defined(FLOAT8_SSE)
+		return {_mm_and_ps(a.lo, b.lo), _mm_and_ps(a.hi, b.hi)};
+#elif defined(FLOAT8_NEON)
+		return {vandq_u32(a.lo, b.lo), vandq_u32(a.hi, b.hi)};
+#else
+		return {a.bits & b.bits};
+#endif
+	}
+};
+
+// eight floats worked on together: one AVX2 register, two SSE or NEON registers, or a plain array;
+// multiplies and adds stay separate so every backend rounds like scalar code
+struct Float8 {
+#if defined(FLOAT8_AVX2)
+	__m256 value;
+#elif defined(FLOAT8_SSE)
+	__m128 lo, hi;
+#elif defined(FLOAT8_NEON)
+	float32x4_t lo, hi;
+#else
+	std::array<float, 8> value;
+#endif
+
+	static Float8 load(const float* source)
+	{
+#if defined(FLOAT8_AVX2)
+		return {_mm256_loadu_ps(source)};
+#elif defined(FLOAT8_SSE)
+		return {_mm_loadu_ps(source), _mm_loadu_ps(source + 4)};
+#elif defined(FLOAT8_NEON)
+		return {vld1q_f32(source), vld1q_f32(source + 4)};
+#else
+		Float8 result;
+		for (int i = 0; i < 8; i++)
+			result.value[i] = source[i];
+		return result;
+#endif
+	}
+
+	static Float8 broadcast(float x)
+	{
+#if defined(FLOAT8_AVX2)
+		return {_mm256_set1_ps(x)};
+#elif defined(FLOAT8_SSE)
+		return {_mm_set1_ps(x), _mm_set1_ps(x)};
+#elif defined(FLOAT8_NEON)
+		return {vdupq_n_f32(x), vdupq_n_f32(x)};
+#else
+		Float8 result;
+		result.value.fill(x);
+		return result;
+#endif
+	}
+
+	// 0, 1, ... 7
+	static Float8 ramp()
+	{
+		alignas(32) static constexpr float lanes[8] = {0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f};
+		return load(lanes);
+	}
+
+	void store(float* target) const
+	{
+#if defined(FLOAT8_AVX2)
+		_mm256_storeu_ps(target, value);
+#elif defined(FLOAT8_SSE)
+		_mm_storeu_ps(target, lo);
+		_mm_storeu_ps(target + 4, hi);
+#elif defined(FLOAT8_NEON)
+		vst1q_f32(target, lo);
+		vst1q_f32(target + 4, hi);
+#else
+		for (int i = 0; i < 8; i++)
+			target[i] = value[i];
+#endif
+	}
+
+#if defined(FLOAT8_AVX2)
+	#define FLOAT8_BINARY(name, avx, sse, neon, scalar) \
+		friend Float8 name(const Float8& a, const Float8& b) { return {avx(a.value, b.value)}; }
+#elif defined(FLOAT8_SSE)
+	#define FLOAT8_BINARY(name, avx, sse, neon, scalar) \
+		friend Float8 name(const Float8& a, const Float8& b) { return {sse(a.lo, b.lo), sse(a.hi, b.hi)}; }
+#elif defined(FLOAT8_NEON)
+	// 32-bit NEON has no divide, a reciprocal estimate refined twice comes close
+	static float32x4_t divide(float32x4_t a, float32x4_t b)
+	{
+	#if defined(__aarch64__)
+		return vdivq_f32(a, b);
+	#else
+		auto reciprocal = vrecpeq_f32(b);
+		reciprocal = vmulq_f32(vrecpsq_f32(b, reciprocal), reciprocal);
+		reciprocal = vmulq_f32(vrecpsq_f32(b, reciprocal), reciprocal);
+		return vmulq_f32(a, reciprocal);
+	#endif
+	}
+
+	#define FLOAT8_BINARY(name, avx, sse, neon, scalar) \
+		friend Float8 name(const Float8& a, const Float8& b) { return {neon(a.lo, b.lo), neon(a.hi, b.hi)}; }
+#else
+	#define FLOAT8_BINARY(name, avx, sse, neon, scalar)                 \
+		friend Float8 name(const Float8& a, const Float8& b)            \
+		{                                                               \
+			Float8 result;                                              \
+			for (int i = 0; i < 8; i++) {                               \
+				float x = a.value[i], y = b.value[i];                   \
+				result.value[i] = scalar;                               \
+			}                                                           \
+			return result;                                              \
+		}
+#endif
+
+	FLOAT8_BINARY(operator+, _mm256_add_ps, _mm_add_ps, vaddq_f32, x + y)
+	FLOAT8_BINARY(operator-, _mm256_sub_ps, _mm_sub_ps, vsubq_f32, x - y)
+	FLOAT8_BINARY(operator*, _mm256_mul_ps, _mm_mul_ps, vmulq_f32, x * y)
+	FLOAT8_BINARY(operator/, _mm256_div_ps, _mm_div_ps, divide, x / y)
+	FLOAT8_BINARY(min, _mm256_min_ps, _mm_min_ps, vminq_f32, y < x ? y : x)
+	FLOAT8_BINARY(max, _mm256_max_ps, _mm_max_ps, vmaxq_f32, x < y ? y : x)
+
+#undef FLOAT8_BINARY
+
+	friend Mask8 operator>=(const Float8& a, const Float8& b)
+	{
+#if defined(FLOAT8_AVX2)
+		return {_mm256_cmp_ps(a.value, b.value, _CMP_GE_OQ)};
+#elif defined(FLOAT8_SSE)
+		return {_mm_cmpge_ps(a.lo, b.lo), _mm_cmpge_ps(a.hi, b.hi)};
+#elif defined(FLOAT8_NEON)
+		return {vcgeq_f32(a.lo, b.lo), vcgeq_f32(a.hi, b.hi)};
+#else
+		Mask8 result{};
+		for (uint32_t i = 0; i < 8; i++)
+			result.bits |= static_cast<uint32_t>(a.value[i] >= b.value[i]) << i;
+		return result;
+#endif
+	}
+
+	friend Mask8 operator<(const Float8& a, const Float8& b)
+	{
+		return b > a;
+	}
+
+	friend Mask8 operator>(const Float8& a, const Float8& b)
+	{
+#if defined(FLOAT8_AVX2)
+		return {_mm256_cmp_ps(a.value, b.value, _CMP_GT_OQ)};
+#elif defined(FLOAT8_SSE)
+		return {_mm_cmpgt_ps(a.lo, b.lo), _mm_cmpgt_ps(a.hi, b.hi)};
+#elif defined(FLOAT8_NEON)
+		return {vcgtq_f32(a.lo, b.lo), vcgtq_f32(a.hi, b.hi)};
+#else
+		Mask8 result{};
+		for (uint32_t i = 0; i < 8; i++)
+			result.bits |= static_cast<uint32_t>(a.value[i] > b.value[i]) << i;
+		return result;
+#endif
+	}
+
+	// a where the mask is set, b elsewhere
+	friend Float8 select(const Mask8& mask, const Float8& a, const Float8& b)
+	{
+#if defined(FLOAT8_AVX2)
+		return {_mm256_blendv_ps(b.value, a.value, mask.value)};
+#elif defined(FLOAT8_SSE)
+		return {_mm_or_ps(_mm_and_ps(mask.lo, a.lo), _mm_andnot_ps(mask.lo, b.lo)),
+		        _mm_or_ps(_mm_and_ps(mask.hi, a.hi), _mm_andnot_ps(mask.hi, b.hi))};
+#elif defined(FLOAT8_NEON)
+		return {vbslq_f32(mask.lo, a.lo, b.lo), vbslq_f32(mask.hi, a.hi, b.hi)};
+#else
+		Float8 result;
+		for (uint32_t i = 0; i < 8; i++)
+			result.value[i] = (mask.bits >> i) & 1 ? a.value[i] : b.value[i];
+		return result;
+#endif
+	}
+
+	static const char* getKernelName()
+	{
+#if defined(FLOAT8_AVX2)
+		return "avx2";
+#elif defined(FLOAT8_SSE)
+		return "sse";
+#elif defined(FLOAT8_NEON)
+		return "neon";
+#else
+		return "scalar";
+#endif
+	}
+};
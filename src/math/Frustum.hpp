@@ -0,0 +1,24 @@
+#pragma once
+
+#include <array>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_access.hpp>
+
+// the six planes of a clip matrix with Vulkan's 0..1 depth range, taken from its rows and pointing
+// inwards: left, right, top, bottom, near, far. cull.slang takes the same ones in the same order.
+// Normalized planes give distances in world units, the others only signs
+inline std::array<glm::vec4, 6> extractFrustumPlanes(const glm::mat4& view_projection, bool normalize = false)
+{
+	auto row0 = glm::row(view_projection, 0);
+	auto row1 = glm::row(view_projection, 1);
+	auto row2 = glm::row(view_projection, 2);
+	auto row3 = glm::row(view_projection, 3);
+
+	std::array<glm::vec4, 6> planes = {row3 + row0, row3 - row0, row3 + row1, row3 - row1, row2, row3 - row2};
+	if (normalize)
+		for (auto& plane : planes)
+			plane /= glm::length(glm::vec3(plane));
+
+	return planes;
+}
@@ -0,0 +1,450 @@
+#include "RenderGraph.hpp"
+
+#include <stdexcept>
+
+RenderGraphPass::RenderGraphPass(std::string name) :
+    name(std::move(name))
+{}
+
+RenderGraphPass& RenderGraphPass::read(RenderGraphHandle resource, ResourceUsage usage)
+{
+	if (RenderGraph::isWrite(usage))
+		throw std::invalid_argument("Write usage declared as read in pass: " + name);
+
+	accesses.push_back({resource, usage});
+	return *this;
+}
+
+RenderGraphPass& RenderGraphPass::write(RenderGraphHandle resource, ResourceUsage usage)
+{
+	if (!RenderGraph::isWrite(usage))
+		throw std::invalid_argument("Read usage declared as write in pass: " + name);
+
+	accesses.push_back({resource, usage});
+	return *this;
+}
+
+RenderGraphPass& RenderGraphPass::setSideEffects(bool side_effects)
+{
+	this->side_effects = side_effects;
+	return *this;
+}
+
+RenderGraphPass& RenderGraphPass::setExecute(std::function<void(vk::CommandBuffer)> callback)
+{
+	this->callback = std::move(callback);
+	return *this;
+}
+
+const std::string& RenderGraphPass::getName() const
+{
+	return name;
+}
+
+bool RenderGraphPass::isCulled() const
+{
+	return culled;
+}
+
+RenderGraphHandle RenderGraph::importImage(std::string          name,
+                                           vk::Image            image,
+                                           vk::ImageView        view,
+                                           vk::ImageAspectFlags aspect,
+                                           const ResourceState& initial_state,
+                                           vk::ImageLayout      final_layout)
+{
+	Resource resource{};
+	resource.name = std::move(name);
+	resource.is_image = true;
+	resource.image = image;
+	resource.view = view;
+	resource.aspect = aspect;
+	resource.initial_state = initial_state;
+	resource.final_layout = final_layout;
+
+	resources.push_back(std::move(resource));
+	compiled = false;
+
+	return static_cast<RenderGraphHandle>(resources.size() - 1);
+}
+
+RenderGraphHandle RenderGraph::importBuffer(std::string name, vk::Buffer buffer, const ResourceState& initial_state)
+{
+	Resource resource{};
+	resource.name = std::move(name);
+	resource.buffer = buffer;
+	resource.initial_state = initial_state;
+
+	resources.push_back(std::move(resource));
+	compiled = false;
+
+	return static_cast<RenderGraphHandle>(resources.size() - 1);
+}
+
+RenderGraphHandle RenderGraph::createImage(std::string name, const TransientImageDesc& desc)
+{
+	Resource resource{};
+	resource.name = std::move(name);
+	resource.is_image = true;
+	resource.aspect = desc.aspect;
+	resource.transient = true;
+	resource.desc = desc;
+
+	resources.push_back(std::move(resource));
+	compiled = false;
+
+	return static_cast<RenderGraphHandle>(resources.size() - 1);
+}
+
+void RenderGraph::setTransientPool(TransientPool& pool)
+{
+	transient_pool = &pool;
+	compiled = false;
+}
+
+void RenderGraph::markOutput(RenderGraphHandle resource)
+{
+	resources.at(resource).output = true;
+	compiled = false;
+}
+
+RenderGraphPass& RenderGraph::addPass(std::string name)
+{
+	passes.push_back(std::make_unique<RenderGraphPass>(std::move(name)));
+	compiled = false;
+
+	return *passes.back();
+}
+
+// passes are declared in submission order, so the schedule keeps that order minus culled passes
+void RenderGraph::compile()
+{
+	for (auto& pass : passes)
+		for (const auto& access : pass->accesses)
+			if (access.resource >= resources.size())
+				throw std::out_of_range("Unknown resource used by pass: " + pass->name);
+
+	cull();
+
+	schedule.clear();
+	for (auto& pass : passes)
+		if (!pass->culled)
+			schedule.push_back(pass.get());
+
+	allocateTransients();
+	buildBarriers();
+	compiled = true;
+}
+
+// walk backwards from the outputs, keeping only passes whose writes are consumed
+void RenderGraph::cull()
+{
+	std::vector<bool> needed(resources.size(), false);
+	for (size_t i = 0; i < resources.size(); i++)
+		needed[i] = resources[i].output;
+
+	for (auto it = passes.rbegin(); it != passes.rend(); it++) {
+		auto& pass = *it;
+
+		bool alive = pass->side_effects;
+		for (const auto& access : pass->accesses)
+			if (isWrite(access.usage) && needed[access.resource])
+				alive = true;
+
+		pass->culled = !alive;
+		if (!alive)
+			continue;
+
+		for (const auto& access : pass->accesses)
+			if (!isWrite(access.usage))
+				needed[access.resource] = true;
+	}
+}
+
+// transient lifetimes span the first to the last scheduled pass using them;
+// memory reused from an earlier image has to wait for all of that image's stages
+void RenderGraph::allocateTransients()
+{
+	std::vector<TransientRequest>  requests;
+	std::vector<RenderGraphHandle> handles;
+	std::vector<ResourceState>     usages(resources.size());
+
+	for (RenderGraphHandle handle = 0; handle < resources.size(); handle++) {
+		if (!resources[handle].transient)
+			continue;
+
+		std::optional<uint32_t> first;
+		uint32_t                last{};
+		for (uint32_t i = 0; i < schedule.size(); i++)
+			for (const auto& access : schedule[i]->accesses) {
+				if (access.resource != handle)
+					continue;
+
+				auto state = usageState(access.usage);
+				usages[handle].stages |= state.stages;
+				if (isWrite(access.usage))
+					usages[handle].access |= state.access;
+
+				if (!first)
+					first = i;
+				last = i;
+			}
+
+		// culled away, no memory needed
+		if (!first)
+			continue;
+
+		requests.push_back({resources[handle].desc, *first, last});
+		handles.push_back(handle);
+	}
+
+	if (requests.empty())
+		return;
+	if (!transient_pool)
+		throw std::runtime_error("Render graph has transient images but no transient pool");
+
+	transient_pool->allocate(requests);
+
+	for (uint32_t i = 0; i < handles.size(); i++) {
+		auto& resource = resources[handles[i]];
+		auto& image = transient_pool->getImage(i);
+		resource.image = image.get();
+		resource.view = image.getView();
+
+		// the previous frame used the image the same way
+		resource.initial_state = {usages[handles[i]].stages, usages[handles[i]].access, vk::ImageLayout::eUndefined};
+		for (uint32_t alias : transient_pool->getAliases(i)) {
+			resource.initial_state.stages |= usages[handles[alias]].stages;
+			resource.initial_state.access |= usages[handles[alias]].access;
+		}
+	}
+}
+
+// a barrier is only emitted for layout changes, hazards against the last write
+// and writes after reads; consecutive reads of the same state share one barrier
+void RenderGraph::buildBarriers()
+{
+	struct Tracker {
+		ResourceState           last_write;
+		vk::PipelineStageFlags2 read_stages;
+		vk::AccessFlags2        read_access;
+		vk::ImageLayout         layout;
+	};
+
+	std::vector<Tracker> trackers(resources.size());
+	for (size_t i = 0; i < resources.size(); i++)
+		trackers[i] = {
+		    .last_write = resources[i].initial_state,
+		    .read_stages = vk::PipelineStageFlagBits2::eNone,
+		    .read_access = vk::AccessFlagBits2::eNone,
+		    .layout = resources[i].initial_state.layout,
+		};
+
+	auto add_barrier = [&](RenderGraphPass& pass, const Resource& resource, const ResourceState& src, const ResourceState& dst, vk::ImageLayout old_layout) {
+		if (resource.is_image)
+			pass.image_barriers.push_back(vk::ImageMemoryBarrier2()
+			                                  .setSrcStageMask(src.stages)
+			                                  .setSrcAccessMask(src.access)
+			                                  .setDstStageMask(dst.stages)
+			                                  .setDstAccessMask(dst.access)
+			                                  .setOldLayout(old_layout)
+			                                  .setNewLayout(dst.layout)
+			                                  .setSrcQueueFamilyIndex(vk::QueueFamilyIgnored)
+			                                  .setDstQueueFamilyIndex(vk::QueueFamilyIgnored)
+			                                  .setImage(resource.image)
+			                                  .setSubresourceRange({resource.aspect, 0, vk::RemainingMipLevels, 0, vk::RemainingArrayLayers}));
+		else
+			pass.buffer_barriers.push_back(vk::BufferMemoryBarrier2()
+			                                   .setSrcStageMask(src.stages)
+			                                   .setSrcAccessMask(src.access)
+			                                   .setDstStageMask(dst.stages)
+			                                   .setDstAccessMask(dst.access)
+			                                   .setSrcQueueFamilyIndex(vk::QueueFamilyIgnored)
+			                                   .setDstQueueFamilyIndex(vk::QueueFamilyIgnored)
+			                                   .setBuffer(resource.buffer)
+			                                   .setOffset(0)
+			                                   .setSize(vk::WholeSize));
+	};
+
+	for (auto* pass : schedule) {
+		pass->image_barriers.clear();
+		pass->buffer_barriers.clear();
+
+		for (const auto& access : pass->accesses) {
+			const auto& resource = resources[access.resource];
+			auto&       tracker = trackers[access.resource];
+
+			auto next = usageState(access.usage);
+			if (!resource.is_image)
+				next.layout = tracker.layout;
+
+			bool write = isWrite(access.usage);
+			bool layout_change = resource.is_image && next.layout != tracker.layout;
+
+			if (write || layout_change) {
+				ResourceState src{
+				    .stages = tracker.last_write.stages | tracker.read_stages,
+				    .access = tracker.last_write.access,
+				};
+
+				if (layout_change || src.stages)
+					add_barrier(*pass, resource, src, next, tracker.layout);
+
+				// a layout transition counts as a write the following reads depend on
+				tracker.last_write = write ? next : ResourceState{next.stages, vk::AccessFlagBits2::eNone, next.layout};
+				tracker.read_stages = write ? vk::PipelineStageFlagBits2::eNone : next.stages;
+				tracker.read_access = write ? vk::AccessFlagBits2::eNone : next.access;
+				tracker.layout = next.layout;
+			} else {
+				bool visible = !(next.stages & ~tracker.read_stages) && !(next.access & ~tracker.read_access);
+				if (tracker.last_write.stages && !visible)
+					add_barrier(*pass, resource, tracker.last_write, next, tracker.layout);
+
+				tracker.read_stages |= next.stages;
+				tracker.read_access |= next.access;
+			}
+		}
+	}
+
+	final_barriers.clear();
+	for (size_t i = 0; i < resources.size(); i++) {
+		const auto& resource = resources[i];
+		const auto& tracker = trackers[i];
+		if (!resource.is_image || resource.final_layout == vk::ImageLayout::eUndefined || resource.final_layout == tracker.layout)
+			continue;
+
+		final_barriers.push_back(vk::ImageMemoryBarrier2()
+		                             .setSrcStageMask(tracker.last_write.stages | tracker.read_stages)
+		                             .setSrcAccessMask(tracker.last_write.access)
+		                             .setDstStageMask(vk::PipelineStageFlagBits2::eBottomOfPipe)
+		                             .setDstAccessMask(vk::AccessFlagBits2::eNone)
+		                             .setOldLayout(tracker.layout)
+		                             .setNewLayout(resource.final_layout)
+		                             .setSrcQueueFamilyIndex(vk::QueueFamilyIgnored)
+		                             .setDstQueueFamilyIndex(vk::QueueFamilyIgnored)
+		                             .setImage(resource.image)
+		                             .setSubresourceRange({resource.aspect, 0, vk::RemainingMipLevels, 0, vk::RemainingArrayLayers}));
+	}
+}
+
+void RenderGraph::execute(vk::CommandBuffer command_buffer)
+{
+	if (!compiled)
+		compile();
+
+	for (auto* pass : schedule) {
+		if (!pass->image_barriers.empty() || !pass->buffer_barriers.empty()) {
+			vk::DependencyInfo dependency_info{};
+			dependency_info.setImageMemoryBarriers(pass->image_barriers)
+			    .setBufferMemoryBarriers(pass->buffer_barriers);
+
+			command_buffer.pipelineBarrier2(dependency_info);
+		}
+
+		if (pass->callback)
+			pass->callback(command_buffer);
+	}
+
+	if (!final_barriers.empty()) {
+		vk::DependencyInfo dependency_info{};
+		dependency_info.setImageMemoryBarriers(final_barriers);
+
+		command_buffer.pipelineBarrier2(dependency_info);
+	}
+}
+
+void RenderGraph::reset()
+{
+	resources.clear();
+	passes.clear();
+	schedule.clear();
+	final_barriers.clear();
+	compiled = false;
+}
+
+vk::Image RenderGraph::getImage(RenderGraphHandle resource) const
+{
+	return resources.at(resource).image;
+}
+
+vk::ImageView RenderGraph::getImageView(RenderGraphHandle resource) const
+{
+	return resources.at(resource).view;
+}
+
+vk::Buffer RenderGraph::getBuffer(RenderGraphHandle resource) const
+{
+	return resources.at(resource).buffer;
+}
+
+const std::vector<RenderGraphPass*>& RenderGraph::getSchedule() const
+{
+	return schedule;
+}
+
+uint32_t RenderGraph::getCulledPassCount() const
+{
+	return static_cast<uint32_t>(passes.size() - schedule.size());
+}
+
+uint32_t RenderGraph::getBarrierCount() const
+{
+	size_t count = final_barriers.size();
+	for (const auto* pass : schedule)
+		count += pass->image_barriers.size() + pass->buffer_barriers.size();
+
+	return static_cast<uint32_t>(count);
+}
+
+bool RenderGraph::isWrite(ResourceUsage usage)
+{
+	switch (usage) {
+	case ResourceUsage::ColorAttachment:
+	case ResourceUsage::DepthAttachment:
+	case ResourceUsage::StorageWrite:
+	case ResourceUsage::TransferDst:
+		return true;
+	default:
+		return false;
+	}
+}
+
+ResourceState RenderGraph::usageState(ResourceUsage usage)
+{
+	using Stage = vk::PipelineStageFlagBits2;
+	using Access = vk::AccessFlagBits2;
+	using Layout = vk::ImageLayout;
+
+	switch (usage) {
+	case ResourceUsage::ColorAttachment:
+		return {Stage::eColorAttachmentOutput, Access::eColorAttachmentRead | Access::eColorAttachmentWrite, Layout::eColorAttachmentOptimal};
+	case ResourceUsage::DepthAttachment:
+		return {Stage::eEarlyFragmentTests | Stage::eLateFragmentTests, Access::eDepthStencilAttachmentRead | Access::eDepthStencilAttachmentWrite, Layout::eDepthAttachmentOptimal};
+	case ResourceUsage::DepthRead:
+		return {Stage::eEarlyFragmentTests | Stage::eLateFragmentTests, Access::eDepthStencilAttachmentRead, Layout::eDepthAttachmentOptimal};
+	case ResourceUsage::SampledFragment:
+		return {Stage::eFragmentShader, Access::eShaderSampledRead, Layout::eShaderReadOnlyOptimal};
+	case ResourceUsage::SampledCompute:
+		return {Stage::eComputeShader, Access::eShaderSampledRead, Layout::eShaderReadOnlyOptimal};
+	case ResourceUsage::StorageRead:
+		return {Stage::eComputeShader, Access::eShaderStorageRead, Layout::eGeneral};
+	case ResourceUsage::StorageWrite:
+		return {Stage::eComputeShader, Access::eShaderStorageRead | Access::eShaderStorageWrite, Layout::eGeneral};
+	case ResourceUsage::GraphicsStorageRead:
+		return {Stage::eVertexShader | Stage::eFragmentShader, Access::eShaderStorageRead, Layout::eGeneral};
+	case ResourceUsage::TransferSrc:
+		return {Stage::eTransfer, Access::eTransferRead, Layout::eTransferSrcOptimal};
+	case ResourceUsage::TransferDst:
+		return {Stage::eTransfer, Access::eTransferWrite, Layout::eTransferDstOptimal};
+	case ResourceUsage::VertexBuffer:
+		return {Stage::eVertexAttributeInput, Access::eVertexAttributeRead, Layout::eUndefined};
+	case ResourceUsage::IndexBuffer:
+		return {Stage::eIndexInput, Access::eIndexRead, Layout::eUndefined};
+	case ResourceUsage::IndirectBuffer:
+		return {Stage::eDrawIndirect, Access::eIndirectCommandRead, Layout::eUndefined};
+	case ResourceUsage::UniformBuffer:
+		return {Stage::eVertexShader | Stage::eFragmentShader | Stage::eComputeShader, Access::eUniformRead, Layout::eUndefined};
+	}
+
+	throw std::invalid_argument("Unknown resource usage");
+}
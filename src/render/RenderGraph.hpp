@@ -0,0 +1,143 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <functional>
+
+#include <vulkan/vulkan.hpp>
+
+#include "TransientPool.hpp"
+
+enum class ResourceUsage : uint8_t {
+	ColorAttachment,
+	DepthAttachment,
+	DepthRead,
+	SampledFragment,
+	SampledCompute,
+	StorageRead,
+	StorageWrite,
+	GraphicsStorageRead,
+	TransferSrc,
+	TransferDst,
+	VertexBuffer,
+	IndexBuffer,
+	IndirectBuffer,
+	UniformBuffer,
+};
+
+struct ResourceState {
+	vk::PipelineStageFlags2 stages{vk::PipelineStageFlagBits2::eNone};
+	vk::AccessFlags2        access{vk::AccessFlagBits2::eNone};
+	vk::ImageLayout         layout{vk::ImageLayout::eUndefined};
+};
+
+using RenderGraphHandle = uint32_t;
+
+class RenderGraph;
+
+class RenderGraphPass {
+private:
+	struct Access {
+		RenderGraphHandle resource;
+		ResourceUsage     usage;
+	};
+
+	std::string         name;
+	std::vector<Access> accesses;
+	bool                side_effects{false};
+	bool                culled{false};
+
+	std::function<void(vk::CommandBuffer)> callback;
+
+	std::vector<vk::ImageMemoryBarrier2>  image_barriers;
+	std::vector<vk::BufferMemoryBarrier2> buffer_barriers;
+
+	friend class RenderGraph;
+
+public:
+	RenderGraphPass(std::string name);
+
+	auto read(RenderGraphHandle resource, ResourceUsage usage) -> RenderGraphPass&;
+	auto write(RenderGraphHandle resource, ResourceUsage usage) -> RenderGraphPass&;
+	auto setSideEffects(bool side_effects = true) -> RenderGraphPass&;
+	auto setExecute(std::function<void(vk::CommandBuffer)> callback) -> RenderGraphPass&;
+
+	auto getName() const -> const std::string&;
+	bool isCulled() const;
+};
+
+class RenderGraph {
+private:
+	struct Resource {
+		std::string name;
+		bool        is_image{};
+
+		vk::Image            image;
+		vk::ImageView        view;
+		vk::ImageAspectFlags aspect;
+		vk::Buffer           buffer;
+
+		ResourceState   initial_state;
+		vk::ImageLayout final_layout{vk::ImageLayout::eUndefined};
+		bool            output{false};
+
+		bool               transient{false};
+		TransientImageDesc desc{};
+	};
+
+	std::vector<Resource>                         resources;
+	std::vector<std::unique_ptr<RenderGraphPass>> passes;
+	std::vector<RenderGraphPass*>                 schedule;
+	std::vector<vk::ImageMemoryBarrier2>          final_barriers;
+
+	TransientPool* transient_pool{};
+
+	bool compiled{false};
+
+	void cull();
+	void allocateTransients();
+	void buildBarriers();
+
+public:
+	RenderGraph() = default;
+
+	RenderGraph(const RenderGraph&) = delete;
+	RenderGraph& operator=(const RenderGraph&) = delete;
+
+	RenderGraph(RenderGraph&&) noexcept = default;
+	RenderGraph& operator=(RenderGraph&&) noexcept = default;
+
+	~RenderGraph() = default;
+
+	RenderGraphHandle importImage(std::string          name,
+	                              vk::Image            image,
+	                              vk::ImageView        view,
+	                              vk::ImageAspectFlags aspect,
+	                              const ResourceState& initial_state = {},
+	                              vk::ImageLayout      final_layout = vk::ImageLayout::eUndefined);
+	RenderGraphHandle importBuffer(std::string name, vk::Buffer buffer, const ResourceState& initial_state = {});
+
+	// transient images only exist while passes use them and may share memory with each other
+	RenderGraphHandle createImage(std::string name, const TransientImageDesc& desc);
+	void              setTransientPool(TransientPool& pool);
+
+	void markOutput(RenderGraphHandle resource);
+
+	RenderGraphPass& addPass(std::string name);
+
+	void compile();
+	void execute(vk::CommandBuffer command_buffer);
+	void reset();
+
+	vk::Image     getImage(RenderGraphHandle resource) const;
+	vk::ImageView getImageView(RenderGraphHandle resource) const;
+	vk::Buffer    getBuffer(RenderGraphHandle resource) const;
+
+	auto getSchedule() const -> const std::vector<RenderGraphPass*>&;
+	auto getCulledPassCount() const -> uint32_t;
+	auto getBarrierCount() const -> uint32_t;
+
+	static bool          isWrite(ResourceUsage usage);
+	static ResourceState usageState(ResourceUsage usage);
+};
@@ -0,0 +1,102 @@
+#include "RenderSelfTest.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <format>
+#include <random>
+#include <ranges>
+#include <utility>
+#include <vector>
+
+#include "TransientPool.hpp"
+#include "rhi/DrawSorter.hpp"
+
+RenderSelfTest::RenderSelfTest() :
+    SelfTest("Render")
+{}
+
+void RenderSelfTest::run()
+{
+	checkTransientPlacement();
+	checkDrawSorter();
+}
+
+void RenderSelfTest::checkTransientPlacement()
+{
+	// two images used by passes 0..1 and 2..3 never live at once, so they share memory
+	std::array<TransientPlacement, 2> apart{};
+	apart[0] = {.size = 4096, .alignment = 256, .first_pass = 0, .last_pass = 1};
+	apart[1] = {.size = 4096, .alignment = 256, .first_pass = 2, .last_pass = 3};
+
+	auto apart_size = TransientPool::place(apart);
+	check("transient images with disjoint lifetimes share an offset", apart[0].offset == 0 && apart[1].offset == 0);
+	check("transient heap holds only one of two aliased images", apart_size == 4096);
+	check("later transient image waits for the one it aliases", apart[1].aliases == std::vector<uint32_t>{0} && apart[0].aliases.empty());
+
+	// a third image live alongside both has to go elsewhere, past the alignment of its own kind
+	std::array<TransientPlacement, 3> overlap{};
+	overlap[0] = {.size = 4096, .alignment = 256, .first_pass = 0, .last_pass = 1};
+	overlap[1] = {.size = 4096, .alignment = 256, .first_pass = 2, .last_pass = 3};
+	overlap[2] = {.size = 1000, .alignment = 65536, .first_pass = 1, .last_pass = 2};
+
+	auto overlap_size = TransientPool::place(overlap);
+	check("transient image overlapping in time gets its own range", overlap[2].offset >= 4096 && overlap[0].offset == 0 && overlap[1].offset == 0);
+	check("transient offsets respect each image's alignment", std::ranges::all_of(overlap, [](const auto& p) { return p.offset % p.alignment == 0; }));
+	check("transient heap covers every placed image", overlap_size == overlap[2].offset + overlap[2].size);
+	check("transient image live throughout aliases nothing", overlap[2].aliases.empty());
+}
+
+void RenderSelfTest::checkDrawSorter()
+{
+	auto key = [](DrawPass pass, uint32_t pipeline, uint32_t material, float depth) {
+		return DrawSorter::makeKey(pass, pipeline, 0, material, depth);
+	};
+
+	check("draw key orders passes before pipelines", key(DrawPass::Opaque, 1000, 0, 0.0f) < key(DrawPass::Masked, 0, 0, 0.0f)
+	                                                     && key(DrawPass::Masked, 1000, 0, 0.0f) < key(DrawPass::Blended, 0, 0, 0.0f));
+	check("draw key orders pipelines before materials", key(DrawPass::Opaque, 1, 0, 0.0f) > key(DrawPass::Opaque, 0, 1000, 0.0f));
+	check("draw key orders materials before depth", key(DrawPass::Opaque, 0, 1, 1.0f) > key(DrawPass::Opaque, 0, 0, 100.0f));
+	check("draw key orders opaque depth front to back", key(DrawPass::Opaque, 0, 0, 1.0f) < key(DrawPass::Opaque, 0, 0, 2.0f)
+	                                                        && key(DrawPass::Opaque, 0, 0, -1.0f) < key(DrawPass::Opaque, 0, 0, 1.0f));
+	check("draw key orders blended depth back to front, before pipelines", key(DrawPass::Blended, 0, 0, 2.0f) < key(DrawPass::Blended, 0, 0, 1.0f)
+	                                                                           && key(DrawPass::Blended, 1000, 0, 2.0f) < key(DrawPass::Blended, 0, 0, 1.0f));
+	check("draw key clamps ids past their field", key(DrawPass::Opaque, ~0u, 0, 0.0f) == key(DrawPass::Opaque, (1u << DrawSorter::pipeline_bits) - 1, 0, 0.0f));
+	check("draw key leaves the bits below its fields clear", std::countr_zero(key(DrawPass::Opaque, 0, 1, 0.0f) | key(DrawPass::Opaque, 0, 0, 1.0f)) >= static_cast<int>(64 - DrawSorter::key_bits));
+
+	// few distinct states and depths, so many keys are equal and stability shows
+	std::mt19937                            random(1);
+	std::uniform_int_distribution<uint32_t> small(0, 7);
+	std::uniform_int_distribution<uint32_t> large(0, 999);
+
+	constexpr uint32_t                         draw_count = 100000;
+	std::vector<std::pair<uint64_t, uint32_t>> reference;
+	DrawSorter                                 sorter;
+	sorter.reserve(draw_count);
+	for (uint32_t i = 0; i < draw_count; i++) {
+		auto pass = static_cast<DrawPass>(small(random) % 3);
+		auto draw_key = DrawSorter::makeKey(pass, small(random), small(random) % 3, large(random), static_cast<float>(small(random)));
+		sorter.add(draw_key, i);
+		reference.push_back({draw_key, i});
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	sorter.sort();
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+	std::ranges::stable_sort(reference, {}, &std::pair<uint64_t, uint32_t>::first);
+	check(std::format("draw sorter orders {} draws like a stable sort, in {:.3f} ms", draw_count, elapsed.count()),
+	      std::ranges::equal(sorter.getKeys(), reference | std::views::keys) && std::ranges::equal(sorter.getValues(), reference | std::views::values));
+
+	// sorting again from sorted keys reuses the storage and changes nothing
+	sorter.sort();
+	check("draw sorter keeps sorted draws in place", std::ranges::equal(sorter.getValues(), reference | std::views::values));
+
+	sorter.clear();
+	for (uint32_t i = 0; i < 4; i++)
+		sorter.add(key(DrawPass::Blended, 0, 0, static_cast<float>(i)), i);
+	sorter.sort();
+
+	check("draw sorter draws blended depth back to front", std::ranges::equal(sorter.getValues(), std::array{3u, 2u, 1u, 0u}));
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "SelfTest.hpp"
+
+// the renderer's CPU side bookkeeping, such as how transient images share memory and the order
+// draws are recorded in
+class RenderSelfTest : public SelfTest {
+private:
+	void checkTransientPlacement();
+	void checkDrawSorter();
+
+public:
+	RenderSelfTest();
+
+	void run() override;
+};
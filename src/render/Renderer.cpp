@@ -1,5 +1,9 @@
 #include "Renderer.hpp"
 
+#include <chrono>
+#include <format>
+#include <optional>
+
 #include <vulkan/vulkan.hpp>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -10,15 +14,20 @@
 #include "graphics/Buffer.hpp"
 #include "render/rhi/GpuVertex.hpp"
 #include "render/rhi/GpuUniforms.hpp"
+#include "render/rhi/VertexCompressor.hpp"
 
-std::array<GpuVertex, 4> vertices = {
-    GpuVertex{{-0.5, -0.5, 0.0}, {0.0, 0.0, -1.0}, {0.0, 0.0}, {1.0, 0.0, 0.0, 1.0}},
-    GpuVertex{{-0.5, 0.5, 0.0}, {0.0, 0.0, -1.0}, {0.0, 1.0}, {1.0, 1.0, 0.0, 1.0}},
-    GpuVertex{{0.5, 0.5, 0.0}, {0.0, 0.0, -1.0}, {1.0, 1.0}, {0.0, 0.0, 1.0, 1.0}},
-    GpuVertex{{0.5, -0.5, 0.0}, {0.0, 0.0, -1.0}, {1.0, 0.0}, {0.0, 1.0, 0.0, 1.0}},
+std::array<MeshVertex, 4> vertices = {
+    MeshVertex{{-0.5, -0.5, 0.0}, {0.0, 0.0, -1.0}, {0.0, 0.0}, {1.0, 0.0, 0.0, 1.0}},
+    MeshVertex{{-0.5, 0.5, 0.0}, {0.0, 0.0, -1.0}, {0.0, 1.0}, {1.0, 1.0, 0.0, 1.0}},
+    MeshVertex{{0.5, 0.5, 0.0}, {0.0, 0.0, -1.0}, {1.0, 1.0}, {0.0, 0.0, 1.0, 1.0}},
+    MeshVertex{{0.5, -0.5, 0.0}, {0.0, 0.0, -1.0}, {1.0, 0.0}, {0.0, 1.0, 0.0, 1.0}},
 };
 
-std::array<uint32_t, 6> indices = {0, 1, 2, 2, 3, 0};
+// the box the quad's positions are quantized within
+glm::vec3 vertices_min = {-0.5, -0.5, 0.0};
+glm::vec3 vertices_max = {0.5, 0.5, 0.0};
+
+std::array<uint16_t, 6> indices = {0, 1, 2, 2, 3, 0};
 
 GpuTransform createTransform()
 {
@@ -34,17 +43,44 @@ GpuTransform createTransform()
 }
 
 GpuTransform transform = createTransform();
+GpuObject    default_object = {
+    .model = glm::mat4(1.0f),
+    .position_min = vertices_min,
+    .position_extent = vertices_max - vertices_min,
+    .colored = 1,
+};
 
 Renderer::Renderer(Window& window)
 {
 	context = std::make_unique<Context>(window);
-	swap_chain = std::make_unique<SwapChain>(window, *context);
-	render_pass = std::make_unique<RenderPass>(*context, *swap_chain);
-	graphics_pipeline = std::make_unique<GraphicsPipeline>(*context, *render_pass);
 
-	vertex_buffer = Buffer::createFrom(*context, vk::BufferUsageFlagBits::eVertexBuffer, vertices.data(), sizeof(vertices));
+	// prefer Vulkan 1.3 dynamic rendering, which needs no render pass or framebuffer objects; its
+	// render graph keeps depth in the transient pool instead of one image per swap chain image
+	bool dynamic = context->getFeatures().dynamic_rendering && context->getFeatures().synchronization2;
+	swap_chain = std::make_unique<SwapChain>(window, *context, !dynamic);
+
+	if (dynamic) {
+		dynamic_rendering = std::make_unique<DynamicRendering>(*context, *swap_chain);
+		transient_pool = std::make_unique<TransientPool>(*context);
+		render_graph.setTransientPool(*transient_pool);
+		depth_pyramid = std::make_unique<GpuDepthPyramid>(*context, swap_chain->getExtent());
+	} else
+		render_pass = std::make_unique<RenderPass>(*context, *swap_chain);
+
+	createPipelines();
+
+	if (context->getFeatures().pipeline_statistics_query)
+		statistics_query = std::make_unique<StatisticsQuery>(*context, 2);
+
+	VertexCompressor quad;
+	quad.add(vertices, vertices_min, vertices_max);
+
+	vertex_buffer = Buffer::createFrom(*context, vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eStorageBuffer, quad.getVertices().data(), quad.getVertices().size() * sizeof(GpuVertex));
+	position_buffer = Buffer::createFrom(*context, vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eStorageBuffer, quad.getPositions().data(), quad.getPositions().size() * sizeof(GpuPosition));
+	color_buffer = Buffer::createFrom(*context, vk::BufferUsageFlagBits::eStorageBuffer, quad.getColors().data(), quad.getColors().size() * sizeof(GpuColor));
 	index_buffer = Buffer::createFrom(*context, vk::BufferUsageFlagBits::eIndexBuffer, indices.data(), sizeof(indices));
 	uniform_buffer = Buffer::createFrom(*context, vk::BufferUsageFlagBits::eUniformBuffer, &transform, sizeof(GpuTransform));
+	object_buffer = Buffer::createFrom(*context, vk::BufferUsageFlagBits::eStorageBuffer, &default_object, sizeof(GpuObject));
 	image = std::make_unique<Image>(*context, ASSETS_DIR "/background.jpeg");
 	sampler = std::make_unique<Sampler>(*context);
 	image->setSampler(*sampler);
@@ -55,11 +91,95 @@ Renderer::Renderer(Window& window)
 	frame.fence = context->getSyncManager().allocateFence();
 	context->getSyncManager().allocateFence();
 
-	frame.pool = context->getDescriptorManager().createPool(vk::DescriptorType::eUniformBuffer, 1);
+	std::array<vk::DescriptorPoolSize, 3> pool_sizes{};
+	pool_sizes[0].setType(vk::DescriptorType::eUniformBuffer).setDescriptorCount(1);
+	pool_sizes[1].setType(vk::DescriptorType::eCombinedImageSampler).setDescriptorCount(1);
+	pool_sizes[2].setType(vk::DescriptorType::eStorageBuffer).setDescriptorCount(4);
+
+	frame.pool = context->getDescriptorManager().createPool(pool_sizes, 1);
 	frame.set = context->getDescriptorManager().allocateSet(frame.pool, graphics_pipeline->getDescriptorBindings());
 
 	context->getDescriptorManager().updateSet(frame.set, 0, vk::DescriptorType::eUniformBuffer, uniform_buffer.get());
 	context->getDescriptorManager().updateSet(frame.set, 1, vk::DescriptorType::eCombinedImageSampler, image.get());
+	updateObjectBinding();
+	updateVertexBinding();
+}
+
+// the scene's per-draw buffer when it has draws, otherwise a single identity transform
+void Renderer::updateObjectBinding()
+{
+	const Buffer* buffer = object_buffer.get();
+	if (render_scene && render_scene->getDrawCount() > 0)
+		buffer = &render_scene->getObjectBuffer();
+
+	context->getDescriptorManager().updateSet(frame.set, 2, vk::DescriptorType::eStorageBuffer, buffer);
+}
+
+// the scene's vertex, position and color streams when it has draws, otherwise the fallback quad's
+void Renderer::updateVertexBinding()
+{
+	const Buffer* vertex = vertex_buffer.get();
+	const Buffer* position = position_buffer.get();
+	const Buffer* color = color_buffer.get();
+	if (render_scene && render_scene->getDrawCount() > 0) {
+		vertex = &render_scene->getVertexBuffer();
+		position = &render_scene->getPositionBuffer();
+		color = &render_scene->getColorBuffer();
+	}
+
+	context->getDescriptorManager().updateSet(frame.set, 3, vk::DescriptorType::eStorageBuffer, vertex);
+	context->getDescriptorManager().updateSet(frame.set, 4, vk::DescriptorType::eStorageBuffer, position);
+	context->getDescriptorManager().updateSet(frame.set, 5, vk::DescriptorType::eStorageBuffer, color);
+}
+
+// occlusion culling builds its pyramid from the pre-pass depth, which only the render graph path can sample
+void Renderer::updateOcclusionCulling()
+{
+	if (render_scene)
+		render_scene->setDepthPyramid(depth_prepass ? depth_pyramid.get() : nullptr);
+}
+
+void Renderer::createPipelines()
+{
+	GraphicsPipelineConfig pipeline_config{};
+	pipeline_config.specialization.set(GpuSpecialization::Textured, false);
+	pipeline_config.specialization.set(GpuSpecialization::AlphaTest, false);
+	pipeline_config.specialization.set(GpuSpecialization::LightCount, 1);
+	pipeline_config.specialization.set(GpuSpecialization::QualityTier, 1);
+
+	// the pre-pass lays down depth from the position stream alone, the main pass then shades each
+	// pixel once
+	GraphicsPipelineConfig depth_config = pipeline_config;
+	depth_config.vertex_entry = "depthVertexMain";
+	depth_config.fragment_entry.clear();
+	depth_config.vertex_bindings = {GpuVertex::positionBinding()};
+	depth_config.vertex_attributes = {GpuVertex::attributes().front()};
+
+	// pulled vertices come from bindings 3 and 4, the pipelines take no vertex input at all
+	if (vertex_pulling) {
+		pipeline_config.vertex_entry = "pulledVertexMain";
+		depth_config.vertex_entry = "pulledDepthVertexMain";
+		for (auto* config : {&pipeline_config, &depth_config}) {
+			config->vertex_bindings.clear();
+			config->vertex_attributes.clear();
+		}
+	}
+	depth_config.color_blend_attachment.setColorWriteMask({});
+	depth_config.depth_only = true;
+
+	if (depth_prepass)
+		pipeline_config.depth_stencil.setDepthWriteEnable(vk::False)
+		    .setDepthCompareOp(vk::CompareOp::eEqual);
+
+	auto create_pipeline = [this](const GraphicsPipelineConfig& config) {
+		if (dynamic_rendering)
+			return std::make_unique<GraphicsPipeline>(*context, *dynamic_rendering, config);
+		else
+			return std::make_unique<GraphicsPipeline>(*context, *render_pass, config);
+	};
+
+	graphics_pipeline = create_pipeline(pipeline_config);
+	depth_pipeline = depth_prepass ? create_pipeline(depth_config) : nullptr;
 }
 
 void Renderer::begin()
@@ -74,7 +194,16 @@ void Renderer::begin()
 	frame.command.reset();
 
 	command_manager->begin(frame.command);
-	render_pass->begin(frame.command, frame.image_index, swap_chain->getExtent(), {{0.0f, 0.0f, 0.0f, 1.0f}});
+	if (statistics_query)
+		statistics_query->reset(frame.command);
+
+	// under dynamic rendering the render graph begins each pass and handles the transitions
+	if (!dynamic_rendering && render_scene) {
+		render_scene->cull(frame.command, transform.projection * transform.view * transform.model);
+		render_scene->cullBarrier(frame.command);
+	}
+	if (!dynamic_rendering)
+		render_pass->begin(frame.command, frame.image_index, swap_chain->getExtent(), {{0.0f, 0.0f, 0.0f, 1.0f}});
 
 	frame.command.setScissor(0,
 	                         vk::Rect2D{}
@@ -95,7 +224,8 @@ void Renderer::end()
 	auto chain = swap_chain->get();
 	auto stage = vk::PipelineStageFlags(vk::PipelineStageFlagBits::eColorAttachmentOutput);
 
-	render_pass->end(frame.command);
+	if (!dynamic_rendering)
+		render_pass->end(frame.command);
 	context->getCommandManager().end(frame.command);
 
 	context->submit(frame.command, {&frame.wait_semaphore, 1}, {&frame.signal_semaphore, 1}, {&stage, 1}, frame.fence);
@@ -106,16 +236,159 @@ void Renderer::end()
 
 void Renderer::draw()
 {
-	frame.command.bindPipeline(vk::PipelineBindPoint::eGraphics, graphics_pipeline->get());
-	frame.command.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, graphics_pipeline->getLayout(), 0, frame.set, {});
+	// the late occlusion phase re-enters rendering and is left out of the statistics
+	auto draw_geometry = [this](GraphicsPipeline& pipeline, std::optional<uint32_t> query_index, std::optional<CullPhase> phase = {}) {
+		frame.command.bindPipeline(vk::PipelineBindPoint::eGraphics, pipeline.get());
+		frame.command.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, pipeline.getLayout(), 0, frame.set, {});
 
-	if (render_scene)
-		render_scene->draw(frame.command);
-	else {
-		frame.command.bindVertexBuffers(0, vertex_buffer->get(), {0});
-		frame.command.bindIndexBuffer(index_buffer->get(), 0, vk::IndexType::eUint32);
-		frame.command.drawIndexed(indices.size(), 1, 0, 0, 0);
+		if (statistics_query && query_index)
+			statistics_query->begin(frame.command, *query_index);
+
+		// depth only passes read the position stream
+		bool depth_only = &pipeline == depth_pipeline.get();
+		auto stream = depth_only ? SceneVertexStream::Position : SceneVertexStream::Full;
+
+		auto start = std::chrono::steady_clock::now();
+		if (render_scene && phase)
+			render_scene->draw(frame.command, *phase, stream);
+		else if (render_scene)
+			render_scene->draw(frame.command, stream);
+		else {
+			if (depth_only)
+				frame.command.bindVertexBuffers(0, position_buffer->get(), {0});
+			else
+				frame.command.bindVertexBuffers(0, {position_buffer->get(), vertex_buffer->get()}, {0, 0});
+			frame.command.bindIndexBuffer(index_buffer->get(), 0, vk::IndexType::eUint16);
+			frame.command.drawIndexed(indices.size(), 1, 0, 0, 0);
+		}
+		record_ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		if (statistics_query && query_index)
+			statistics_query->end(frame.command, *query_index);
+	};
+
+	record_ms = 0.0;
+
+	if (!dynamic_rendering) {
+		if (depth_pipeline)
+			draw_geometry(*depth_pipeline, 0);
+		draw_geometry(*graphics_pipeline, 1);
+		return;
+	}
+
+	auto extent = swap_chain->getExtent();
+
+	render_graph.reset();
+
+	auto color = render_graph.importImage("swapchain",
+	                                      swap_chain->getImages()[frame.image_index],
+	                                      swap_chain->getImageViews()[frame.image_index],
+	                                      vk::ImageAspectFlagBits::eColor,
+	                                      {vk::PipelineStageFlagBits2::eColorAttachmentOutput, vk::AccessFlagBits2::eNone, vk::ImageLayout::eUndefined},
+	                                      vk::ImageLayout::ePresentSrcKHR);
+
+	bool occlusion = render_scene && render_scene->isOcclusionCulled();
+
+	// depth never leaves the frame, so it lives in the transient pool
+	vk::ImageUsageFlags depth_usage = vk::ImageUsageFlagBits::eDepthStencilAttachment;
+	if (occlusion)
+		depth_usage |= vk::ImageUsageFlagBits::eSampled;
+
+	auto depth = render_graph.createImage("depth", {extent, swap_chain->getDepthFormat(), depth_usage, vk::ImageAspectFlagBits::eDepth});
+	render_graph.markOutput(color);
+
+	vk::ClearValue color_clear = vk::ClearColorValue{0.0f, 0.0f, 0.0f, 1.0f};
+	vk::ClearValue depth_clear = vk::ClearDepthStencilValue{1.0f, 0};
+
+	auto view_projection = transform.projection * transform.view * transform.model;
+
+	// the culled commands of each phase, read by every geometry pass that draws the phase
+	std::array<std::vector<RenderGraphHandle>, 2> indirect;
+
+	auto import_phase = [&](CullPhase phase, std::string_view name) -> RenderGraphPass& {
+		// last read by the previous frame's draws
+		auto  last_use = RenderGraph::usageState(ResourceUsage::IndirectBuffer);
+		auto& handles = indirect[static_cast<size_t>(phase)];
+		handles.push_back(render_graph.importBuffer(std::format("{}_commands", name), render_scene->getIndirectBuffer(phase).get(), last_use));
+		handles.push_back(render_graph.importBuffer(std::format("{}_counts", name), render_scene->getCountBuffer(phase).get(), last_use));
+
+		auto& cull = render_graph.addPass(std::format("cull_{}", name));
+		for (auto handle : handles)
+			cull.write(handle, ResourceUsage::StorageWrite);
+		cull.setExecute([this, phase, view_projection](vk::CommandBuffer command_buffer) {
+			render_scene->cull(command_buffer, view_projection, phase);
+		});
+		return cull;
+	};
+	auto read_phase = [&](RenderGraphPass& pass, CullPhase phase) {
+		for (auto handle : indirect[static_cast<size_t>(phase)])
+			pass.read(handle, ResourceUsage::IndirectBuffer);
+	};
+
+	// without GPU culling the scene culls on the CPU while the graph is recorded
+	if (render_scene && render_scene->isGpuCulled())
+		import_phase(CullPhase::Early, "early");
+	else if (render_scene)
+		render_scene->cull(frame.command, view_projection);
+
+	if (depth_pipeline) {
+		auto& depth_pass = render_graph.addPass("depth_prepass").write(depth, ResourceUsage::DepthAttachment);
+		read_phase(depth_pass, CullPhase::Early);
+		depth_pass.setExecute([&](vk::CommandBuffer command_buffer) {
+			dynamic_rendering->begin(command_buffer, {}, render_graph.getImageView(depth), extent, {&depth_clear, 1});
+			draw_geometry(*depth_pipeline, 0, CullPhase::Early);
+			dynamic_rendering->end(command_buffer);
+		});
 	}
+
+	// the pyramid is rebuilt from the early phase's depth, then the late phase tests the remaining draws against it
+	if (occlusion) {
+		auto pyramid = render_graph.importImage("depth_pyramid",
+		                                        depth_pyramid->getImage().get(),
+		                                        depth_pyramid->getImage().getView(),
+		                                        vk::ImageAspectFlagBits::eColor,
+		                                        RenderGraph::usageState(ResourceUsage::SampledCompute),
+		                                        GpuDepthPyramid::layout);
+
+		render_graph.addPass("depth_pyramid")
+		    .read(depth, ResourceUsage::SampledCompute)
+		    .write(pyramid, ResourceUsage::StorageWrite)
+		    .setExecute([&](vk::CommandBuffer command_buffer) {
+			    depth_pyramid->build(command_buffer, render_graph.getImageView(depth));
+		    });
+
+		import_phase(CullPhase::Late, "late").read(pyramid, ResourceUsage::SampledCompute);
+
+		auto& late_pass = render_graph.addPass("depth_late").write(depth, ResourceUsage::DepthAttachment);
+		read_phase(late_pass, CullPhase::Late);
+		late_pass.setExecute([&](vk::CommandBuffer command_buffer) {
+			dynamic_rendering->begin(command_buffer, {}, render_graph.getImageView(depth), extent, {});
+			draw_geometry(*depth_pipeline, std::nullopt, CullPhase::Late);
+			dynamic_rendering->end(command_buffer);
+		});
+	}
+
+	// with the pre-pass the forward pass only tests against the existing depth
+	auto& forward = render_graph.addPass("forward").write(color, ResourceUsage::ColorAttachment);
+	if (depth_pipeline)
+		forward.read(depth, ResourceUsage::DepthRead);
+	else
+		forward.write(depth, ResourceUsage::DepthAttachment);
+	read_phase(forward, CullPhase::Early);
+	read_phase(forward, CullPhase::Late);
+
+	forward.setExecute([&](vk::CommandBuffer command_buffer) {
+		std::vector<vk::ClearValue> clear_values = {color_clear};
+		if (!depth_pipeline)
+			clear_values.push_back(depth_clear);
+
+		auto color_view = render_graph.getImageView(color);
+		dynamic_rendering->begin(command_buffer, {&color_view, 1}, render_graph.getImageView(depth), extent, clear_values);
+		draw_geometry(*graphics_pipeline, 1);
+		dynamic_rendering->end(command_buffer);
+	});
+
+	render_graph.execute(frame.command);
 }
 
 void Renderer::wait()
@@ -128,10 +401,77 @@ void Renderer::tick(float dt)
 	if (!active_level)
 		return;
 
+	// levels of detail follow the active camera's field of view, the default one's without it
+	if (render_scene) {
+		float fov = glm::radians(45.0f);
+		if (auto* camera = dynamic_cast<PerspectiveCamera*>(active_level->getActiveCamera()))
+			fov = camera->getFov();
+
+		render_scene->update();
+		render_scene->setLodProjection(fov, static_cast<float>(swap_chain->getExtent().height));
+	}
+
 	begin();
 	draw();
 	end();
 	wait();
+
+	if (statistics_query) {
+		prepass_statistics = statistics_query->fetch(0).value_or(PipelineStatistics{});
+		main_statistics = statistics_query->fetch(1).value_or(PipelineStatistics{});
+	}
+
+	if (render_scene)
+		cull_statistics = render_scene->getCullStatistics();
+}
+
+void Renderer::setDepthPrepass(bool enabled)
+{
+	if (depth_prepass == enabled)
+		return;
+
+	wait();
+	depth_prepass = enabled;
+	createPipelines();
+	updateOcclusionCulling();
+}
+
+// rebuilds the scene's commands and object buffer
+void Renderer::setMeshletCulling(bool enabled)
+{
+	if (meshlet_culling == enabled)
+		return;
+
+	wait();
+	meshlet_culling = enabled;
+	if (render_scene) {
+		render_scene->setMeshletCulling(enabled);
+		updateObjectBinding();
+	}
+}
+
+void Renderer::setLodThreshold(float pixels)
+{
+	lod_threshold = pixels;
+	if (render_scene)
+		render_scene->setLodThreshold(pixels);
+}
+
+void Renderer::setStaticBatching(bool enabled)
+{
+	static_batching = enabled;
+}
+
+void Renderer::setVertexPulling(bool enabled)
+{
+	if (vertex_pulling == enabled)
+		return;
+
+	wait();
+	vertex_pulling = enabled;
+	createPipelines();
+	if (render_scene)
+		render_scene->setVertexPulling(enabled);
 }
 
 Level* Renderer::getActiveLevel() const
@@ -143,5 +483,65 @@ void Renderer::setActiveLevel(Level& level)
 {
 	active_level = &level;
 
-	render_scene = std::make_unique<GpuScene>(*context, *active_level->getActiveScene());
+	render_scene = std::make_unique<GpuScene>(*context, *active_level->getActiveScene(), static_batching);
+	render_scene->setVertexPulling(vertex_pulling);
+	render_scene->setMeshletCulling(meshlet_culling);
+	render_scene->setLodThreshold(lod_threshold);
+	batch_statistics = render_scene->getBatchStatistics();
+	compression_statistics = render_scene->getCompressionStatistics();
+	updateObjectBinding();
+	updateVertexBinding();
+	updateOcclusionCulling();
+}
+
+// renders frames at each draw count and measures the CPU time spent recording the draws; both
+// modes cull on the CPU, outside the measured time, so they record the same sorted draws
+std::vector<DrawBenchmark> Renderer::benchmarkDrawSubmission(std::span<const uint32_t> draw_counts, uint32_t frames)
+{
+	std::vector<DrawBenchmark> results;
+	if (!render_scene)
+		return results;
+
+	auto mode = render_scene->getDrawMode();
+
+	auto measure = [&](SceneDrawMode draw_mode) {
+		render_scene->setDrawMode(draw_mode);
+
+		double total = 0.0;
+		for (uint32_t i = 0; i < frames; i++) {
+			begin();
+			draw();
+			total += record_ms;
+			end();
+			wait();
+		}
+
+		return total / std::max(frames, 1u);
+	};
+
+	// instancing would fold the copies back into a handful of draws, and direct draws cannot be
+	// culled on the GPU
+	render_scene->setInstancing(false);
+	render_scene->setGpuCulling(false);
+
+	for (auto draw_count : draw_counts) {
+		render_scene->replicateDraws(draw_count);
+		updateObjectBinding();
+
+		DrawBenchmark result{.draw_count = render_scene->getDrawCount()};
+		result.direct_ms = measure(SceneDrawMode::Direct);
+		result.indirect_ms = measure(SceneDrawMode::Indirect);
+		results.push_back(result);
+	}
+
+	render_scene = std::make_unique<GpuScene>(*context, *active_level->getActiveScene(), static_batching);
+	render_scene->setDrawMode(mode);
+	render_scene->setVertexPulling(vertex_pulling);
+	render_scene->setMeshletCulling(meshlet_culling);
+	render_scene->setLodThreshold(lod_threshold);
+	updateObjectBinding();
+	updateVertexBinding();
+	updateOcclusionCulling();
+
+	return results;
 }
@@ -4,11 +4,15 @@
 #include <SDL3/SDL.h>
 #include <SDL3/SDL_vulkan.h>
 
+#include "RenderGraph.hpp"
 #include "rhi/GpuScene.hpp"
+#include "rhi/GpuDepthPyramid.hpp"
 #include "graphics/Context.hpp"
 #include "graphics/SwapChain.hpp"
 #include "graphics/RenderPass.hpp"
+#include "graphics/DynamicRendering.hpp"
 #include "graphics/GraphicsPipeline.hpp"
+#include "graphics/StatisticsQuery.hpp"
 #include "graphics/Buffer.hpp"
 #include "graphics/Image.hpp"
 #include "graphics/Sampler.hpp"
@@ -25,24 +29,55 @@ struct Frame {
 	vk::DescriptorSet  set{};
 };
 
+struct DrawBenchmark {
+	uint32_t draw_count{};
+	double   direct_ms{};
+	double   indirect_ms{};
+};
+
 struct Renderer {
 	std::unique_ptr<Context>          context;
 	std::unique_ptr<SwapChain>        swap_chain;
 	std::unique_ptr<RenderPass>       render_pass;
+	std::unique_ptr<DynamicRendering> dynamic_rendering;
 	std::unique_ptr<GraphicsPipeline> graphics_pipeline;
+	std::unique_ptr<GraphicsPipeline> depth_pipeline;
+	std::unique_ptr<StatisticsQuery>  statistics_query;
 
 	std::unique_ptr<Buffer>  vertex_buffer;
+	std::unique_ptr<Buffer>  position_buffer;
+	std::unique_ptr<Buffer>  color_buffer;
 	std::unique_ptr<Buffer>  index_buffer;
 	std::unique_ptr<Buffer>  uniform_buffer;
+	std::unique_ptr<Buffer>  object_buffer;
 	std::unique_ptr<Image>   image;
 	std::unique_ptr<Sampler> sampler;
 
-	std::unique_ptr<GpuScene> render_scene;
+	std::unique_ptr<GpuScene>        render_scene;
+	std::unique_ptr<GpuDepthPyramid> depth_pyramid;
+
+	RenderGraph                    render_graph;
+	std::unique_ptr<TransientPool> transient_pool;
 
 	Level* active_level{};
 
 	Frame frame;
 
+	bool               depth_prepass{true};
+	bool               static_batching{false};
+	bool               vertex_pulling{false};
+	bool               meshlet_culling{true};
+	float              lod_threshold{1.0f};
+	PipelineStatistics prepass_statistics{};
+	PipelineStatistics main_statistics{};
+	GpuCullStatistics  cull_statistics{};
+
+	// CPU time the last frame spent recording the geometry passes' draws
+	double record_ms{};
+
+	StaticBatchStatistics       batch_statistics{};
+	VertexCompressionStatistics compression_statistics{};
+
 	Renderer(Window& window);
 
 	Renderer(const Renderer&) = delete;
@@ -53,6 +88,11 @@ struct Renderer {
 
 	~Renderer() = default;
 
+	void createPipelines();
+	void updateObjectBinding();
+	void updateVertexBinding();
+	void updateOcclusionCulling();
+
 	void begin();
 	void end();
 	void wait();
@@ -60,6 +100,22 @@ struct Renderer {
 
 	void tick(float dt);
 
+	void setDepthPrepass(bool enabled);
+
+	// vertex shaders fetch vertices from a storage buffer instead of fixed-function vertex input
+	void setVertexPulling(bool enabled);
+
+	// culls meshes loaded with meshlets one meshlet at a time while the GPU culls
+	void setMeshletCulling(bool enabled);
+
+	// the screen-space error in pixels levels of detail may cause, 0 draws every mesh in full detail
+	void setLodThreshold(float pixels);
+
+	// merges small static submeshes when the level's scene is built, takes effect on the next level
+	void setStaticBatching(bool enabled);
+
 	auto getActiveLevel() const -> Level*;
 	void setActiveLevel(Level& level);
+
+	auto benchmarkDrawSubmission(std::span<const uint32_t> draw_counts, uint32_t frames = 16) -> std::vector<DrawBenchmark>;
 };
@@ -0,0 +1,211 @@
+#include "TransientPool.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <functional>
+#include <stdexcept>
+
+namespace
+{
+constexpr vk::ImageUsageFlags attachment_usage = vk::ImageUsageFlagBits::eColorAttachment
+                                               | vk::ImageUsageFlagBits::eDepthStencilAttachment
+                                               | vk::ImageUsageFlagBits::eInputAttachment;
+
+bool lifetimesOverlap(const TransientPlacement& a, const TransientPlacement& b)
+{
+	return a.first_pass <= b.last_pass && b.first_pass <= a.last_pass;
+}
+
+vk::DeviceSize alignUp(vk::DeviceSize value, vk::DeviceSize alignment)
+{
+	return (value + alignment - 1) / alignment * alignment;
+}
+}        // namespace
+
+TransientPool::TransientPool(Context& c) :
+    context(&c)
+{}
+
+TransientPool::~TransientPool()
+{
+	release();
+}
+
+void TransientPool::release()
+{
+	allocations.clear();
+	for (auto& heap : heaps)
+		context->getLogicalDevice().freeMemory(heap.memory);
+
+	heaps.clear();
+	naive_size = 0;
+}
+
+void TransientPool::allocate(std::span<const TransientRequest> new_requests)
+{
+	if (std::ranges::equal(new_requests, requests) && allocations.size() == requests.size())
+		return;
+
+	release();
+	requests.assign(new_requests.begin(), new_requests.end());
+
+	// attachment-only images can live in lazily allocated memory, which tilers may never back
+	heaps.resize(2);
+	heaps[1].lazy = true;
+
+	std::vector<uint32_t> regular;
+	std::vector<uint32_t> lazy;
+
+	for (uint32_t i = 0; i < requests.size(); i++) {
+		const auto& desc = requests[i].desc;
+
+		bool attachment_only = !(desc.usage & ~attachment_usage);
+		auto usage = attachment_only ? desc.usage | vk::ImageUsageFlagBits::eTransientAttachment : desc.usage;
+
+		Allocation allocation{};
+		allocation.image = Image::createUnbound(*context, desc.extent, desc.format, usage, desc.aspect);
+
+		auto requirements = allocation.image->getMemoryRequirements();
+		allocation.size = requirements.size;
+		naive_size += requirements.size;
+
+		bool can_be_lazy = attachment_only
+		                && queryMemoryType(requirements.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal | vk::MemoryPropertyFlagBits::eLazilyAllocated);
+		(can_be_lazy ? lazy : regular).push_back(i);
+
+		allocations.push_back(std::move(allocation));
+	}
+
+	place(heaps[0], 0, regular);
+	place(heaps[1], 1, lazy);
+
+	for (auto& heap : heaps) {
+		if (heap.size == 0)
+			continue;
+
+		auto flags = heap.lazy ? vk::MemoryPropertyFlagBits::eDeviceLocal | vk::MemoryPropertyFlagBits::eLazilyAllocated
+		                       : vk::MemoryPropertyFlags(vk::MemoryPropertyFlagBits::eDeviceLocal);
+		auto type = queryMemoryType(heap.type_bits, flags);
+		if (!type)
+			throw std::runtime_error("No memory type can hold every aliased transient image");
+
+		vk::MemoryAllocateInfo alloc_info{};
+		alloc_info.setAllocationSize(heap.size)
+		    .setMemoryTypeIndex(*type);
+
+		heap.memory = context->getLogicalDevice().allocateMemory(alloc_info);
+	}
+
+	for (auto& allocation : allocations)
+		allocation.image->bindMemory(heaps[allocation.heap].memory, allocation.offset);
+}
+
+void TransientPool::place(Heap& heap, uint32_t heap_index, std::span<const uint32_t> members)
+{
+	std::vector<TransientPlacement> placements;
+	for (uint32_t i : members) {
+		auto requirements = allocations[i].image->getMemoryRequirements();
+
+		TransientPlacement placement{};
+		placement.size = requirements.size;
+		placement.alignment = requirements.alignment;
+		placement.first_pass = requests[i].first_pass;
+		placement.last_pass = requests[i].last_pass;
+		placements.push_back(std::move(placement));
+
+		heap.type_bits &= requirements.memoryTypeBits;
+	}
+
+	heap.size = place(placements);
+
+	for (uint32_t m = 0; m < members.size(); m++) {
+		auto& allocation = allocations[members[m]];
+		allocation.offset = placements[m].offset;
+		allocation.heap = heap_index;
+		for (uint32_t alias : placements[m].aliases)
+			allocation.aliases.push_back(members[alias]);
+	}
+}
+
+vk::DeviceSize TransientPool::place(std::span<TransientPlacement> placements)
+{
+	std::vector<uint32_t> order(placements.size());
+	std::iota(order.begin(), order.end(), 0u);
+	std::ranges::stable_sort(order, std::greater{}, [&](uint32_t i) { return placements[i].size; });
+
+	vk::DeviceSize        heap_size = 0;
+	std::vector<uint32_t> placed;
+	for (uint32_t i : order) {
+		auto& placement = placements[i];
+
+		std::vector<vk::DeviceSize> candidates = {0};
+		for (uint32_t other : placed)
+			if (lifetimesOverlap(placement, placements[other]))
+				candidates.push_back(alignUp(placements[other].offset + placements[other].size, placement.alignment));
+		std::ranges::sort(candidates);
+
+		for (auto offset : candidates) {
+			bool free = std::ranges::none_of(placed, [&](uint32_t other) {
+				const auto& o = placements[other];
+				return lifetimesOverlap(placement, o) && offset < o.offset + o.size && o.offset < offset + placement.size;
+			});
+
+			if (free) {
+				placement.offset = offset;
+				break;
+			}
+		}
+
+		heap_size = std::max(heap_size, placement.offset + placement.size);
+		placed.push_back(i);
+	}
+
+	// images sharing memory with an earlier one must wait for its last use
+	for (uint32_t i : placed)
+		for (uint32_t other : placed) {
+			const auto& a = placements[i];
+			const auto& b = placements[other];
+			if (b.last_pass < a.first_pass && a.offset < b.offset + b.size && b.offset < a.offset + a.size)
+				placements[i].aliases.push_back(other);
+		}
+
+	return heap_size;
+}
+
+Image& TransientPool::getImage(uint32_t index) const
+{
+	return *allocations.at(index).image;
+}
+
+const std::vector<uint32_t>& TransientPool::getAliases(uint32_t index) const
+{
+	return allocations.at(index).aliases;
+}
+
+vk::DeviceSize TransientPool::getNaiveSize() const
+{
+	return naive_size;
+}
+
+vk::DeviceSize TransientPool::getAliasedSize() const
+{
+	return std::accumulate(heaps.begin(), heaps.end(), vk::DeviceSize{0}, [](vk::DeviceSize sum, const Heap& heap) {
+		return sum + heap.size;
+	});
+}
+
+vk::DeviceSize TransientPool::getLazySize() const
+{
+	return heaps.size() > 1 ? heaps[1].size : 0;
+}
+
+std::optional<uint32_t> TransientPool::queryMemoryType(uint32_t type_bits, vk::MemoryPropertyFlags prop_flags) const
+{
+	auto property = context->getPhysicalDevice().getMemoryProperties();
+
+	for (uint32_t i = 0; i < property.memoryTypeCount; i++)
+		if ((1u << i) & type_bits && (property.memoryTypes[i].propertyFlags & prop_flags) == prop_flags)
+			return i;
+
+	return std::nullopt;
+}
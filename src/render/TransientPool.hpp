@@ -0,0 +1,97 @@
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include <vulkan/vulkan.hpp>
+
+#include "graphics/Context.hpp"
+#include "graphics/Image.hpp"
+
+struct TransientImageDesc {
+	vk::Extent2D         extent{};
+	vk::Format           format{vk::Format::eUndefined};
+	vk::ImageUsageFlags  usage{};
+	vk::ImageAspectFlags aspect{vk::ImageAspectFlagBits::eColor};
+
+	bool operator==(const TransientImageDesc&) const = default;
+};
+
+// lifetime is the inclusive range of scheduled pass indices that access the image
+struct TransientRequest {
+	TransientImageDesc desc{};
+	uint32_t           first_pass{};
+	uint32_t           last_pass{};
+
+	bool operator==(const TransientRequest&) const = default;
+};
+
+// the memory side of one image in a heap; place() fills in the offset and the earlier images the
+// placement shares memory with, as indices into the same span
+struct TransientPlacement {
+	vk::DeviceSize size{};
+	vk::DeviceSize alignment{1};
+	uint32_t       first_pass{};
+	uint32_t       last_pass{};
+
+	vk::DeviceSize        offset{};
+	std::vector<uint32_t> aliases;
+};
+
+class TransientPool {
+private:
+	struct Allocation {
+		std::unique_ptr<Image> image;
+		vk::DeviceSize         offset{};
+		vk::DeviceSize         size{};
+		uint32_t               heap{};
+		std::vector<uint32_t>  aliases;
+	};
+
+	struct Heap {
+		vk::DeviceMemory memory;
+		vk::DeviceSize   size{};
+		uint32_t         type_bits{~0u};
+		bool             lazy{};
+	};
+
+	std::vector<TransientRequest> requests;
+	std::vector<Allocation>       allocations;
+	std::vector<Heap>             heaps;
+
+	vk::DeviceSize naive_size{};
+
+	Context* context{};
+
+	void release();
+	void place(Heap& heap, uint32_t heap_index, std::span<const uint32_t> members);
+
+	std::optional<uint32_t> queryMemoryType(uint32_t type_bits, vk::MemoryPropertyFlags prop_flags) const;
+
+public:
+	TransientPool(Context& context);
+
+	TransientPool(const TransientPool&) = delete;
+	TransientPool& operator=(const TransientPool&) = delete;
+
+	TransientPool(TransientPool&&) noexcept = default;
+	TransientPool& operator=(TransientPool&&) noexcept = default;
+
+	~TransientPool();
+
+	// rebuilding destroys the previous images, the GPU must no longer use them
+	void allocate(std::span<const TransientRequest> requests);
+
+	Image& getImage(uint32_t index) const;
+	auto   getAliases(uint32_t index) const -> const std::vector<uint32_t>&;
+
+	auto getNaiveSize() const -> vk::DeviceSize;
+	auto getAliasedSize() const -> vk::DeviceSize;
+	auto getLazySize() const -> vk::DeviceSize;
+
+	// largest images first, each at the lowest offset not used by an image whose lifetime
+	// overlaps; returns the heap size
+	static auto place(std::span<TransientPlacement> placements) -> vk::DeviceSize;
+};
@@ -0,0 +1,110 @@
+#include "CullingSelfTest.hpp"
+
+#include <algorithm>
+#include <array>
+#include <format>
+#include <print>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "FrustumCuller.hpp"
+#include "OcclusionCuller.hpp"
+
+namespace
+{
+// the camera sits at the origin looking down -z, with Vulkan's 0..1 depth range
+glm::mat4 testProjection()
+{
+	return glm::perspectiveRH_ZO(glm::radians(60.0f), 2.0f, 0.1f, 100.0f);
+}
+
+// a square facing the camera, half_size wide either side of the z axis
+void addSquare(OcclusionCuller& culler, float half_size, float z, const glm::mat4& view_projection)
+{
+	std::array<glm::vec3, 4> positions = {
+	    glm::vec3(-half_size, -half_size, z),
+	    glm::vec3(half_size, -half_size, z),
+	    glm::vec3(half_size, half_size, z),
+	    glm::vec3(-half_size, half_size, z),
+	};
+	std::array<uint32_t, 6> indices = {0, 1, 2, 0, 2, 3};
+
+	culler.addOccluder(positions, std::span<const uint32_t>(indices), view_projection);
+}
+}        // namespace
+
+CullingSelfTest::CullingSelfTest() :
+    SelfTest("Culling")
+{}
+
+void CullingSelfTest::run()
+{
+	checkFrustum();
+	checkOcclusion();
+}
+
+void CullingSelfTest::checkFrustum()
+{
+	auto view_projection = testProjection();
+
+	FrustumCuller culler;
+	culler.resize(2);
+	culler.setBounds(0, glm::vec3(-1.0f, -1.0f, -11.0f), glm::vec3(1.0f, 1.0f, -9.0f), glm::mat4(1.0f));
+	culler.setBounds(1, glm::vec3(-1.0f, -1.0f, 9.0f), glm::vec3(1.0f, 1.0f, 11.0f), glm::mat4(1.0f));
+	culler.cull(view_projection);
+	check("frustum keeps a box ahead", culler.isVisible(0));
+	check("frustum culls a box behind", !culler.isVisible(1));
+
+	// the same boxes every run, so a disagreement is repeatable
+	constexpr uint32_t box_count = 4096;
+
+	std::mt19937                          random(1);
+	std::uniform_real_distribution<float> position(-60.0f, 60.0f);
+	std::uniform_real_distribution<float> size(0.1f, 4.0f);
+
+	culler.resize(box_count);
+	for (uint32_t i = 0; i < box_count; i++) {
+		glm::vec3 min = {position(random), position(random), position(random)};
+		culler.setBounds(i, min, min + glm::vec3(size(random), size(random), size(random)), glm::mat4(1.0f));
+	}
+	auto mismatches = culler.validate(view_projection);
+	check(std::format("frustum {} kernel matches the scalar path, {} of {} visible", FrustumCuller::getKernelName(), culler.getVisibleCount(), box_count),
+	      mismatches == 0);
+}
+
+void CullingSelfTest::checkOcclusion()
+{
+	auto view_projection = testProjection();
+
+	// a wall filling the view
+	OcclusionCuller culler;
+	culler.setThreadCount(1);
+	culler.clear();
+	addSquare(culler, 20.0f, -5.0f, view_projection);
+	culler.rasterize();
+
+	check("occlusion hides a box behind a wall", culler.isOccluded(glm::vec3(-1.0f, -1.0f, -21.0f), glm::vec3(1.0f, 1.0f, -19.0f), view_projection));
+	check("occlusion keeps a box before a wall", !culler.isOccluded(glm::vec3(-1.0f, -1.0f, -4.0f), glm::vec3(1.0f, 1.0f, -3.0f), view_projection));
+	check("occlusion keeps a box behind the camera", !culler.isOccluded(glm::vec3(-1.0f, -1.0f, 3.0f), glm::vec3(1.0f, 1.0f, 4.0f), view_projection));
+
+	// a small square covers a box whose outline it contains, not one reaching past it
+	culler.clear();
+	addSquare(culler, 1.0f, -5.0f, view_projection);
+	culler.rasterize();
+
+	check("occlusion hides a box inside the square's outline", culler.isOccluded(glm::vec3(-2.0f, -2.0f, -21.0f), glm::vec3(2.0f, 2.0f, -20.0f), view_projection));
+	check("occlusion keeps a box reaching past the square", !culler.isOccluded(glm::vec3(-8.0f, -2.0f, -21.0f), glm::vec3(8.0f, 2.0f, -20.0f), view_projection));
+
+	// the tiles are independent, so workers must leave the depth the single thread did
+	std::vector<float> reference(culler.getDepth().begin(), culler.getDepth().end());
+
+	culler.setThreadCount(std::max(std::thread::hardware_concurrency(), 2u));
+	culler.clear();
+	addSquare(culler, 1.0f, -5.0f, view_projection);
+	culler.rasterize();
+	check(std::format("occlusion on {} threads matches one", culler.getThreadCount()), std::ranges::equal(reference, culler.getDepth()));
+}
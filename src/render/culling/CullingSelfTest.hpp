@@ -0,0 +1,15 @@
+#pragma once
+
+#include "SelfTest.hpp"
+
+// the CPU frustum and occlusion culling paths
+class CullingSelfTest : public SelfTest {
+private:
+	void checkFrustum();
+	void checkOcclusion();
+
+public:
+	CullingSelfTest();
+
+	void run() override;
+};
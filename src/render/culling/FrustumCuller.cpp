@@ -0,0 +1,148 @@
+#include "FrustumCuller.hpp"
+
+#include <cmath>
+#include <numeric>
+
+#include "math/Float8.hpp"
+#include "math/Frustum.hpp"
+
+namespace
+{
+using Planes = std::array<glm::vec4, 6>;
+
+// a box is outside once it lies entirely behind one plane: distance + radius < 0
+void cullBatches(const BoundsSoA& bounds, const Planes& planes, uint8_t* visibility, size_t padded_count)
+{
+	for (size_t i = 0; i < padded_count; i += FrustumCuller::batch_size) {
+		auto cx = Float8::load(&bounds.center_x[i]);
+		auto cy = Float8::load(&bounds.center_y[i]);
+		auto cz = Float8::load(&bounds.center_z[i]);
+		auto ex = Float8::load(&bounds.extent_x[i]);
+		auto ey = Float8::load(&bounds.extent_y[i]);
+		auto ez = Float8::load(&bounds.extent_z[i]);
+
+		uint32_t inside = 0xff;
+		for (const auto& plane : planes) {
+			auto distance = Float8::broadcast(plane.x) * cx + Float8::broadcast(plane.y) * cy + Float8::broadcast(plane.z) * cz + Float8::broadcast(plane.w);
+			auto radius = Float8::broadcast(std::abs(plane.x)) * ex + Float8::broadcast(std::abs(plane.y)) * ey + Float8::broadcast(std::abs(plane.z)) * ez;
+			inside &= (distance + radius >= Float8::broadcast(0.0f)).getBits();
+		}
+
+		for (size_t j = 0; j < FrustumCuller::batch_size; j++)
+			visibility[i + j] = (inside >> j) & 1;
+	}
+}
+
+void cullScalarRange(const BoundsSoA& bounds, const Planes& planes, uint8_t* visibility, size_t count)
+{
+	for (size_t i = 0; i < count; i++) {
+		bool inside = true;
+		for (const auto& plane : planes) {
+			float distance = plane.x * bounds.center_x[i] + plane.y * bounds.center_y[i] + plane.z * bounds.center_z[i] + plane.w;
+			float radius = std::abs(plane.x) * bounds.extent_x[i] + std::abs(plane.y) * bounds.extent_y[i] + std::abs(plane.z) * bounds.extent_z[i];
+			inside = inside && distance + radius >= 0.0f;
+		}
+		visibility[i] = inside;
+	}
+}
+}        // namespace
+
+void BoundsSoA::resize(size_t count)
+{
+	auto padded = (count + FrustumCuller::batch_size - 1) / FrustumCuller::batch_size * FrustumCuller::batch_size;
+	for (auto* values : {&center_x, &center_y, &center_z, &extent_x, &extent_y, &extent_z})
+		values->assign(padded, 0.0f);
+}
+
+void BoundsSoA::set(size_t index, const glm::vec3& center, const glm::vec3& extent)
+{
+	center_x[index] = center.x;
+	center_y[index] = center.y;
+	center_z[index] = center.z;
+	extent_x[index] = extent.x;
+	extent_y[index] = extent.y;
+	extent_z[index] = extent.z;
+}
+
+void FrustumCuller::resize(uint32_t object_count)
+{
+	count = object_count;
+	visible_count = count;
+
+	bounds.resize(count);
+	visibility.assign(bounds.center_x.size(), 1);
+}
+
+void FrustumCuller::setBounds(uint32_t index, const glm::vec3& local_min, const glm::vec3& local_max, const glm::mat4& model)
+{
+	auto center = (local_min + local_max) * 0.5f;
+	auto extent = (local_max - local_min) * 0.5f;
+
+	auto world_center = glm::vec3(model * glm::vec4(center, 1.0f));
+	auto world_extent = glm::abs(glm::vec3(model[0])) * extent.x +
+	                    glm::abs(glm::vec3(model[1])) * extent.y +
+	                    glm::abs(glm::vec3(model[2])) * extent.z;
+
+	bounds.set(index, world_center, world_extent);
+}
+
+uint32_t FrustumCuller::cull(const glm::mat4& view_projection)
+{
+	cullBatches(bounds, extractFrustumPlanes(view_projection, true), visibility.data(), visibility.size());
+
+	visible_count = std::accumulate(visibility.begin(), visibility.begin() + count, 0u);
+	return visible_count;
+}
+
+uint32_t FrustumCuller::cullScalar(const glm::mat4& view_projection)
+{
+	cullScalarRange(bounds, extractFrustumPlanes(view_projection, true), visibility.data(), count);
+
+	visible_count = std::accumulate(visibility.begin(), visibility.begin() + count, 0u);
+	return visible_count;
+}
+
+// boxes touching a plane may still differ where the compiler contracts the scalar path into FMAs
+uint32_t FrustumCuller::validate(const glm::mat4& view_projection)
+{
+	cullScalar(view_projection);
+	auto reference = visibility;
+
+	cull(view_projection);
+
+	uint32_t mismatches = 0;
+	for (uint32_t i = 0; i < count; i++)
+		mismatches += reference[i] != visibility[i];
+
+	return mismatches;
+}
+
+bool FrustumCuller::isVisible(uint32_t index) const
+{
+	return visibility[index] != 0;
+}
+
+std::span<const uint8_t> FrustumCuller::getVisibility() const
+{
+	return {visibility.data(), count};
+}
+
+uint32_t FrustumCuller::getVisibleCount() const
+{
+	return visible_count;
+}
+
+uint32_t FrustumCuller::getCount() const
+{
+	return count;
+}
+
+const BoundsSoA& FrustumCuller::getBounds() const
+{
+	return bounds;
+}
+
+const char* FrustumCuller::getKernelName()
+{
+	return Float8::getKernelName();
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+// world space boxes as center and half extent, one array per component so a SIMD register holds
+// the same component of consecutive boxes; the arrays are padded to a whole batch
+struct BoundsSoA {
+	std::vector<float> center_x;
+	std::vector<float> center_y;
+	std::vector<float> center_z;
+	std::vector<float> extent_x;
+	std::vector<float> extent_y;
+	std::vector<float> extent_z;
+
+	void resize(size_t count);
+	void set(size_t index, const glm::vec3& center, const glm::vec3& extent);
+};
+
+// frustum culls boxes on the CPU, eight per iteration with AVX2, SSE or NEON when available
+class FrustumCuller {
+private:
+	BoundsSoA            bounds;
+	std::vector<uint8_t> visibility;
+
+	uint32_t count{};
+	uint32_t visible_count{};
+
+public:
+	static constexpr uint32_t batch_size = 8;
+
+	FrustumCuller() = default;
+
+	FrustumCuller(const FrustumCuller&) = delete;
+	FrustumCuller& operator=(const FrustumCuller&) = delete;
+
+	FrustumCuller(FrustumCuller&&) noexcept = default;
+	FrustumCuller& operator=(FrustumCuller&&) noexcept = default;
+
+	~FrustumCuller() = default;
+
+	void resize(uint32_t count);
+
+	// stores the world box around a local box transformed by model
+	void setBounds(uint32_t index, const glm::vec3& local_min, const glm::vec3& local_max, const glm::mat4& model);
+
+	auto cull(const glm::mat4& view_projection) -> uint32_t;
+
+	// the reference the SIMD kernels are checked against, same arithmetic in the same order
+	auto cullScalar(const glm::mat4& view_projection) -> uint32_t;
+
+	// runs both paths and returns how many boxes they disagree on
+	auto validate(const glm::mat4& view_projection) -> uint32_t;
+
+	bool isVisible(uint32_t index) const;
+	auto getVisibility() const -> std::span<const uint8_t>;
+	auto getVisibleCount() const -> uint32_t;
+	auto getCount() const -> uint32_t;
+	auto getBounds() const -> const BoundsSoA&;
+
+	static const char* getKernelName();
+};
@@ -0,0 +1,378 @@
+#include "OcclusionCuller.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "math/Float8.hpp"
+
+namespace
+{
+constexpr float far_depth = std::numeric_limits<float>::max();
+
+// clip space to pixels, y as the projection leaves it
+glm::vec3 toScreen(const glm::vec4& clip, float width, float height)
+{
+	auto ndc = glm::vec3(clip) / clip.w;
+	return {(ndc.x * 0.5f + 0.5f) * width, (ndc.y * 0.5f + 0.5f) * height, ndc.z};
+}
+}        // namespace
+
+// threads sleep until a generation of work starts, run it with the caller and report back; the
+// threads are declared last so they are joined before what they wait on goes
+struct OcclusionCuller::Workers {
+	std::mutex              mutex;
+	std::condition_variable started;
+	std::condition_variable finished;
+	std::function<void()>   work;
+	uint64_t                generation{};
+	uint32_t                running{};
+	bool                    stopping{};
+
+	std::vector<std::jthread> threads;
+
+	Workers(uint32_t count)
+	{
+		for (uint32_t i = 0; i < count; i++)
+			threads.emplace_back([this] { loop(); });
+	}
+
+	~Workers()
+	{
+		{
+			std::lock_guard lock(mutex);
+			stopping = true;
+		}
+		started.notify_all();
+	}
+
+	void loop()
+	{
+		uint64_t seen = 0;
+		while (true) {
+			std::unique_lock lock(mutex);
+			started.wait(lock, [&] { return stopping || generation != seen; });
+			if (stopping)
+				return;
+
+			seen = generation;
+			lock.unlock();
+			work();
+			lock.lock();
+
+			if (--running == 0)
+				finished.notify_one();
+		}
+	}
+
+	// returns once every thread is done with it
+	void run(std::function<void()> job)
+	{
+		{
+			std::lock_guard lock(mutex);
+			work = std::move(job);
+			running = static_cast<uint32_t>(threads.size());
+			generation++;
+		}
+		started.notify_all();
+
+		work();
+
+		std::unique_lock lock(mutex);
+		finished.wait(lock, [&] { return running == 0; });
+	}
+};
+
+OcclusionCuller::OcclusionCuller(uint32_t width, uint32_t height)
+{
+	resize(width, height);
+	setThreadCount(std::thread::hardware_concurrency());
+}
+
+OcclusionCuller::OcclusionCuller(OcclusionCuller&&) noexcept = default;
+OcclusionCuller& OcclusionCuller::operator=(OcclusionCuller&&) noexcept = default;
+
+OcclusionCuller::~OcclusionCuller() = default;
+
+void OcclusionCuller::resize(uint32_t new_width, uint32_t new_height)
+{
+	tiles_x = std::max((new_width + tile_size - 1) / tile_size, 1u);
+	tiles_y = std::max((new_height + tile_size - 1) / tile_size, 1u);
+	width = tiles_x * tile_size;
+	height = tiles_y * tile_size;
+
+	depth.resize(width * height);
+	tile_farthest.resize(tiles_x * tiles_y);
+	bins.resize(tiles_x * tiles_y);
+
+	clear();
+	startWorkers();
+}
+
+void OcclusionCuller::clear()
+{
+	std::ranges::fill(depth, far_depth);
+	std::ranges::fill(tile_farthest, far_depth);
+
+	triangles.clear();
+	for (auto& bin : bins)
+		bin.clear();
+}
+
+void OcclusionCuller::addOccluder(std::span<const glm::vec3> positions, std::span<const uint8_t> indices, const glm::mat4& model_view_projection)
+{
+	addTriangles(positions, indices, model_view_projection);
+}
+
+void OcclusionCuller::addOccluder(std::span<const glm::vec3> positions, std::span<const uint16_t> indices, const glm::mat4& model_view_projection)
+{
+	addTriangles(positions, indices, model_view_projection);
+}
+
+void OcclusionCuller::addOccluder(std::span<const glm::vec3> positions, std::span<const uint32_t> indices, const glm::mat4& model_view_projection)
+{
+	addTriangles(positions, indices, model_view_projection);
+}
+
+template <typename Index>
+void OcclusionCuller::addTriangles(std::span<const glm::vec3> positions, std::span<const Index> indices, const glm::mat4& model_view_projection)
+{
+	clip_positions.resize(positions.size());
+	for (size_t i = 0; i < positions.size(); i++)
+		clip_positions[i] = model_view_projection * glm::vec4(positions[i], 1.0f);
+
+	for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+		if (indices[i] >= positions.size() || indices[i + 1] >= positions.size() || indices[i + 2] >= positions.size())
+			continue;
+
+		const auto& c0 = clip_positions[indices[i]];
+		const auto& c1 = clip_positions[indices[i + 1]];
+		const auto& c2 = clip_positions[indices[i + 2]];
+
+		// the GPU clips what lies in front of the near plane, so such triangles cannot occlude
+		if (c0.w <= 0.0f || c1.w <= 0.0f || c2.w <= 0.0f || c0.z < 0.0f || c1.z < 0.0f || c2.z < 0.0f)
+			continue;
+
+		std::array<glm::vec3, 3> v = {toScreen(c0, width, height), toScreen(c1, width, height), toScreen(c2, width, height)};
+
+		// both windings occlude, counter-clockwise keeps the edge functions positive inside
+		float area = (v[1].x - v[0].x) * (v[2].y - v[0].y) - (v[1].y - v[0].y) * (v[2].x - v[0].x);
+		if (std::abs(area) < 1e-6f)
+			continue;
+		if (area < 0.0f)
+			std::swap(v[1], v[2]);
+
+		auto lower = glm::min(glm::min(v[0], v[1]), v[2]);
+		auto upper = glm::max(glm::max(v[0], v[1]), v[2]);
+
+		Triangle triangle{};
+		triangle.min = glm::clamp(glm::ivec2(glm::floor(glm::vec2(lower))), glm::ivec2(0), glm::ivec2(width, height));
+		triangle.max = glm::clamp(glm::ivec2(glm::ceil(glm::vec2(upper))), glm::ivec2(0), glm::ivec2(width, height));
+		if (triangle.min.x >= triangle.max.x || triangle.min.y >= triangle.max.y)
+			continue;
+
+		// the farthest vertex stands in for the whole triangle, which never occludes more than it should
+		triangle.depth = upper.z;
+
+		// pixel (x, y) is sampled at its center; requiring full coverage instead would open cracks
+		// along every edge two triangles share. Both triangles of an edge take it from the same
+		// endpoint, so their edge functions are exact negatives and no center falls between them
+		for (int e = 0; e < 3; e++) {
+			const auto& p = v[e];
+			const auto& q = v[(e + 1) % 3];
+
+			bool        flip = std::pair{q.x, q.y} < std::pair{p.x, p.y};
+			const auto& from = flip ? q : p;
+			const auto& to = flip ? p : q;
+
+			float a = from.y - to.y;
+			float b = to.x - from.x;
+			float c = -a * from.x - b * from.y + 0.5f * (a + b);
+
+			float sign = flip ? -1.0f : 1.0f;
+			triangle.a[e] = sign * a;
+			triangle.b[e] = sign * b;
+			triangle.c[e] = sign * c;
+		}
+
+		auto index = static_cast<uint32_t>(triangles.size());
+		triangles.push_back(triangle);
+
+		for (uint32_t ty = triangle.min.y / tile_size; ty <= (triangle.max.y - 1) / tile_size; ty++)
+			for (uint32_t tx = triangle.min.x / tile_size; tx <= (triangle.max.x - 1) / tile_size; tx++)
+				bins[ty * tiles_x + tx].push_back(index);
+	}
+}
+
+// there is no point in more threads than tiles
+void OcclusionCuller::startWorkers()
+{
+	auto count = std::min(thread_count, tiles_x * tiles_y) - 1;
+	if (count == (workers ? workers->threads.size() : 0))
+		return;
+
+	workers.reset();
+	if (count > 0)
+		workers = std::make_unique<Workers>(count);
+}
+
+// tiles share no pixels, so workers need no synchronization past handing them out
+void OcclusionCuller::rasterize()
+{
+	auto tile_count = tiles_x * tiles_y;
+
+	std::atomic<uint32_t> next{0};
+	auto work = [&] {
+		for (uint32_t tile = next++; tile < tile_count; tile = next++)
+			rasterizeTile(tile);
+	};
+
+	if (workers)
+		workers->run(work);
+	else
+		work();
+}
+
+void OcclusionCuller::rasterizeTile(uint32_t tile)
+{
+	auto tile_min = glm::ivec2(tile % tiles_x, tile / tiles_x) * static_cast<int>(tile_size);
+	auto tile_max = tile_min + static_cast<int>(tile_size);
+
+	auto ramp = Float8::ramp();
+	auto zero = Float8::broadcast(0.0f);
+
+	for (auto index : bins[tile]) {
+		const auto& triangle = triangles[index];
+
+		auto first = glm::max(triangle.min, tile_min);
+		auto last = glm::min(triangle.max, tile_max);
+
+		// tiles are a whole number of blocks wide, so aligned blocks never leave the tile
+		first.x &= ~7;
+
+		std::array<Float8, 3> step;
+		for (int e = 0; e < 3; e++)
+			step[e] = Float8::broadcast(triangle.a[e]) * ramp;
+		auto triangle_depth = Float8::broadcast(triangle.depth);
+
+		for (int y = first.y; y < last.y; y++) {
+			float* row = &depth[y * width];
+
+			for (int x = first.x; x < last.x; x += 8) {
+				auto inside = Float8::broadcast(triangle.a[0] * x + triangle.b[0] * y + triangle.c[0]) + step[0] >= zero;
+				inside = inside & (Float8::broadcast(triangle.a[1] * x + triangle.b[1] * y + triangle.c[1]) + step[1] >= zero);
+				inside = inside & (Float8::broadcast(triangle.a[2] * x + triangle.b[2] * y + triangle.c[2]) + step[2] >= zero);
+				if (!inside.any())
+					continue;
+
+				auto current = Float8::load(row + x);
+				select(inside, min(current, triangle_depth), current).store(row + x);
+			}
+		}
+	}
+
+	// the tile's farthest depth lets tests skip it when a box lies behind all of it
+	auto farthest = Float8::broadcast(-far_depth);
+	for (int y = tile_min.y; y < tile_max.y; y++)
+		for (int x = tile_min.x; x < tile_max.x; x += 8)
+			farthest = max(farthest, Float8::load(&depth[y * width + x]));
+
+	std::array<float, 8> lanes;
+	farthest.store(lanes.data());
+	tile_farthest[tile] = *std::ranges::max_element(lanes);
+}
+
+bool OcclusionCuller::isOccluded(const glm::vec3& local_min, const glm::vec3& local_max, const glm::mat4& model_view_projection) const
+{
+	auto lower = glm::vec3(far_depth);
+	auto upper = glm::vec3(-far_depth);
+
+	for (uint32_t i = 0; i < 8; i++) {
+		glm::vec3 corner = {i & 1 ? local_max.x : local_min.x, i & 2 ? local_max.y : local_min.y, i & 4 ? local_max.z : local_min.z};
+		auto      clip = model_view_projection * glm::vec4(corner, 1.0f);
+
+		// boxes reaching behind the camera cannot be projected conservatively
+		if (clip.w <= 0.0f)
+			return false;
+
+		auto screen = toScreen(clip, width, height);
+		lower = glm::min(lower, screen);
+		upper = glm::max(upper, screen);
+	}
+
+	auto first = glm::clamp(glm::ivec2(glm::floor(glm::vec2(lower))), glm::ivec2(0), glm::ivec2(width, height));
+	auto last = glm::clamp(glm::ivec2(glm::ceil(glm::vec2(upper))), glm::ivec2(0), glm::ivec2(width, height));
+
+	// off screen, which is for the frustum test to decide
+	if (first.x >= last.x || first.y >= last.y)
+		return false;
+
+	float nearest = lower.z;
+	auto  box_depth = Float8::broadcast(nearest);
+	auto  ramp = Float8::ramp();
+	auto  rect_min = Float8::broadcast(static_cast<float>(first.x));
+	auto  rect_max = Float8::broadcast(static_cast<float>(last.x));
+
+	for (int ty = first.y / static_cast<int>(tile_size); ty <= (last.y - 1) / static_cast<int>(tile_size); ty++) {
+		for (int tx = first.x / static_cast<int>(tile_size); tx <= (last.x - 1) / static_cast<int>(tile_size); tx++) {
+			if (tile_farthest[ty * tiles_x + tx] < nearest)
+				continue;
+
+			int y_end = std::min(last.y, (ty + 1) * static_cast<int>(tile_size));
+			int x_end = std::min(last.x, (tx + 1) * static_cast<int>(tile_size));
+
+			for (int y = std::max(first.y, ty * static_cast<int>(tile_size)); y < y_end; y++) {
+				const float* row = &depth[y * width];
+
+				for (int x = std::max(first.x, tx * static_cast<int>(tile_size)) & ~7; x < x_end; x += 8) {
+					auto column = Float8::broadcast(static_cast<float>(x)) + ramp;
+					auto in_rect = (column >= rect_min) & (column < rect_max);
+
+					if ((in_rect & (Float8::load(row + x) >= box_depth)).any())
+						return false;
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+uint32_t OcclusionCuller::getThreadCount() const
+{
+	return thread_count;
+}
+
+// zero, as hardware_concurrency may report, rasterizes on the calling thread
+void OcclusionCuller::setThreadCount(uint32_t count)
+{
+	thread_count = std::max(count, 1u);
+	startWorkers();
+}
+
+uint32_t OcclusionCuller::getWidth() const
+{
+	return width;
+}
+
+uint32_t OcclusionCuller::getHeight() const
+{
+	return height;
+}
+
+std::span<const float> OcclusionCuller::getDepth() const
+{
+	return depth;
+}
+
+uint32_t OcclusionCuller::getTriangleCount() const
+{
+	return static_cast<uint32_t>(triangles.size());
+}
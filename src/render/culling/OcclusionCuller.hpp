@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+// software occlusion culling: a few large occluders are rasterized into a small depth buffer on the
+// CPU, occludee boxes are then tested against it; the buffer is split into tiles rasterized in
+// parallel by workers the culler keeps for its lifetime
+class OcclusionCuller {
+private:
+	struct Workers;
+
+	// edge functions a * x + b * y + c of a screen triangle, non-negative where a pixel's center lies inside
+	struct Triangle {
+		glm::vec3 a;
+		glm::vec3 b;
+		glm::vec3 c;
+		float     depth;
+
+		// covered pixels, max exclusive
+		glm::ivec2 min;
+		glm::ivec2 max;
+	};
+
+	uint32_t width{};
+	uint32_t height{};
+	uint32_t tiles_x{};
+	uint32_t tiles_y{};
+	uint32_t thread_count{1};
+
+	std::vector<float> depth;
+	std::vector<float> tile_farthest;
+
+	std::vector<Triangle>              triangles;
+	std::vector<std::vector<uint32_t>> bins;
+	std::vector<glm::vec4>             clip_positions;
+
+	std::unique_ptr<Workers> workers;
+
+	// one less than the threads used, the calling thread rasterizes too
+	void startWorkers();
+	void rasterizeTile(uint32_t tile);
+
+	template <typename Index>
+	void addTriangles(std::span<const glm::vec3> positions, std::span<const Index> indices, const glm::mat4& model_view_projection);
+
+public:
+	static constexpr uint32_t tile_size = 32;
+
+	OcclusionCuller(uint32_t width = 256, uint32_t height = 128);
+
+	OcclusionCuller(const OcclusionCuller&) = delete;
+	OcclusionCuller& operator=(const OcclusionCuller&) = delete;
+
+	OcclusionCuller(OcclusionCuller&&) noexcept;
+	OcclusionCuller& operator=(OcclusionCuller&&) noexcept;
+
+	~OcclusionCuller();
+
+	// rounded up to whole tiles
+	void resize(uint32_t width, uint32_t height);
+
+	void clear();
+
+	// bins the triangles of a local mesh, triangles reaching in front of the near plane are dropped;
+	// the indices may have any width
+	void addOccluder(std::span<const glm::vec3> positions, std::span<const uint8_t> indices, const glm::mat4& model_view_projection);
+	void addOccluder(std::span<const glm::vec3> positions, std::span<const uint16_t> indices, const glm::mat4& model_view_projection);
+	void addOccluder(std::span<const glm::vec3> positions, std::span<const uint32_t> indices, const glm::mat4& model_view_projection);
+
+	void rasterize();
+
+	// true when every pixel under the box's screen rectangle holds an occluder nearer than the box
+	bool isOccluded(const glm::vec3& local_min, const glm::vec3& local_max, const glm::mat4& model_view_projection) const;
+
+	auto getThreadCount() const -> uint32_t;
+	void setThreadCount(uint32_t thread_count);
+
+	auto getWidth() const -> uint32_t;
+	auto getHeight() const -> uint32_t;
+	auto getDepth() const -> std::span<const float>;
+	auto getTriangleCount() const -> uint32_t;
+};
@@ -24,6 +24,12 @@ void Buffer::create(vk::BufferUsageFlags usage, size_t size)
 	    .setUsage(usage)
 	    .setSharingMode(vk::SharingMode::eExclusive);
 
+	// storage buffers may be shared with the async compute queue without ownership transfers
+	auto families = context->getQueueFamilies();
+	if (usage & vk::BufferUsageFlagBits::eStorageBuffer && context->hasAsyncCompute())
+		create_info.setSharingMode(vk::SharingMode::eConcurrent)
+		    .setQueueFamilyIndices(families);
+
 	buffer = context->getLogicalDevice().createBuffer(create_info);
 }
 
@@ -87,6 +93,13 @@ void Buffer::upload(const void* src, size_t src_size, size_t dst_offset)
 	unmap();
 }
 
+void Buffer::download(void* dst, size_t dst_size, size_t src_offset)
+{
+	map(dst_size, src_offset);
+	std::memcpy(dst, data, dst_size);
+	unmap();
+}
+
 std::unique_ptr<Buffer> Buffer::createFrom(Context& context, vk::BufferUsageFlags Usage, const void* src, size_t size)
 {
 	if (!src || size == 0)
@@ -41,6 +41,7 @@ public:
 	void copyTo(vk::Buffer dst, size_t size, size_t src_offset = 0, size_t dst_offset = 0);
 	void copyFrom(vk::Buffer src, size_t size, size_t src_offset = 0, size_t dst_offset = 0);
 	void upload(const void* src, size_t src_size, size_t dst_offset = 0);
+	void download(void* dst, size_t dst_size, size_t src_offset = 0);
 
 	static std::unique_ptr<Buffer> createFrom(Context& context, vk::BufferUsageFlags Usage, const void* src, size_t size);
 
@@ -1,7 +1,8 @@
 #include "CommandManager.hpp"
 
-CommandManager::CommandManager(Context& context) :
-    context(&context)
+CommandManager::CommandManager(Context& context, uint32_t queue_family) :
+    context(&context),
+    queue_family(queue_family)
 {
 	createPool();
 }
@@ -15,7 +16,7 @@ void CommandManager::createPool()
 {
 	vk::CommandPoolCreateInfo pool_info{};
 	pool_info.setFlags(vk::CommandPoolCreateFlagBits::eResetCommandBuffer)
-	    .setQueueFamilyIndex(context->getGraphicsQueueIndex());
+	    .setQueueFamilyIndex(queue_family);
 
 	command_maps.first = context->getLogicalDevice().createCommandPool(pool_info);
 }
@@ -9,9 +9,10 @@ private:
 	std::pair<vk::CommandPool, std::vector<vk::CommandBuffer>> command_maps;
 
 	Context* context{};
+	uint32_t queue_family{};
 
 public:
-	CommandManager(Context& context);
+	CommandManager(Context& context, uint32_t queue_family);
 
 	CommandManager(const CommandManager&) = delete;
 	CommandManager& operator=(const CommandManager&) = delete;
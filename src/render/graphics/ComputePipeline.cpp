@@ -0,0 +1,89 @@
+#include "ComputePipeline.hpp"
+
+#include "DescriptorManager.hpp"
+
+ComputePipeline::ComputePipeline(Context& c, std::string_view shader_file, const ComputePipelineConfig& p) :
+    context(&c),
+    shader(c, shader_file),
+    config(p)
+{
+	init();
+}
+
+void ComputePipeline::init()
+{
+	shader.setStage(vk::ShaderStageFlagBits::eCompute, config.entry);
+
+	auto layout = context->getDescriptorManager().createLayout(config.descriptor_bindings);
+
+	vk::PipelineLayoutCreateInfo layout_info{};
+	layout_info.setSetLayouts(layout)
+	    .setPushConstantRanges(config.push_constants);
+
+	pipeline_layout = context->getLogicalDevice().createPipelineLayout(layout_info);
+
+	create(config);
+}
+
+ComputePipeline::~ComputePipeline()
+{
+	context->getLogicalDevice().destroyPipeline(pipeline);
+	context->getLogicalDevice().destroyPipelineLayout(pipeline_layout);
+}
+
+void ComputePipeline::create(const ComputePipelineConfig& config)
+{
+	vk::ComputePipelineCreateInfo pipeline_info{};
+	pipeline_info.setStage(shader.getStage(vk::ShaderStageFlagBits::eCompute, &config.specialization))
+	    .setLayout(pipeline_layout);
+
+	pipeline = context->getLogicalDevice().createComputePipeline(context->getPipelineCache(), pipeline_info).value;
+}
+
+void ComputePipeline::bind(vk::CommandBuffer command, std::span<const vk::DescriptorSet> sets) const
+{
+	command.bindPipeline(vk::PipelineBindPoint::eCompute, pipeline);
+	if (!sets.empty())
+		command.bindDescriptorSets(vk::PipelineBindPoint::eCompute, pipeline_layout, 0, sets, {});
+}
+
+void ComputePipeline::dispatch(vk::CommandBuffer command, uint32_t group_x, uint32_t group_y, uint32_t group_z) const
+{
+	command.dispatch(group_x, group_y, group_z);
+}
+
+// the buffer holds a VkDispatchIndirectCommand written by an earlier pass
+void ComputePipeline::dispatchIndirect(vk::CommandBuffer command, const Buffer& buffer, vk::DeviceSize offset) const
+{
+	command.dispatchIndirect(buffer.get(), offset);
+}
+
+vk::Pipeline ComputePipeline::get() const
+{
+	return pipeline;
+}
+
+vk::PipelineLayout ComputePipeline::getLayout() const
+{
+	return pipeline_layout;
+}
+
+const std::vector<vk::DescriptorSetLayoutBinding>& ComputePipeline::getDescriptorBindings() const
+{
+	return config.descriptor_bindings;
+}
+
+const ComputePipelineConfig& ComputePipeline::getConfig() const
+{
+	return config;
+}
+
+const Shader& ComputePipeline::getShader() const
+{
+	return shader;
+}
+
+uint32_t ComputePipeline::groupCount(uint32_t count, uint32_t group_size)
+{
+	return (count + group_size - 1) / group_size;
+}
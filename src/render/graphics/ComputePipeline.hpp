@@ -0,0 +1,66 @@
+#pragma once
+
+#include <vulkan/vulkan.hpp>
+
+#include "Context.hpp"
+#include "Buffer.hpp"
+#include "Shader.hpp"
+
+struct ComputePipelineConfig {
+	std::string entry = "computeMain";
+
+	std::vector<vk::DescriptorSetLayoutBinding> descriptor_bindings;
+	std::vector<vk::PushConstantRange>          push_constants;
+
+	ShaderSpecialization specialization{};
+};
+
+class ComputePipeline {
+private:
+	vk::Pipeline       pipeline;
+	vk::PipelineLayout pipeline_layout;
+
+	ComputePipelineConfig config;
+
+	Shader shader;
+
+	Context* context{};
+
+	void init();
+
+public:
+	ComputePipeline(Context& context, std::string_view shader_file, const ComputePipelineConfig& config = {});
+
+	ComputePipeline(const ComputePipeline&) = delete;
+	ComputePipeline& operator=(const ComputePipeline&) = delete;
+
+	ComputePipeline(ComputePipeline&&) noexcept = default;
+	ComputePipeline& operator=(ComputePipeline&&) noexcept = default;
+
+	~ComputePipeline();
+
+	void create(const ComputePipelineConfig& config);
+
+	void bind(vk::CommandBuffer command, std::span<const vk::DescriptorSet> sets = {}) const;
+	void dispatch(vk::CommandBuffer command, uint32_t group_x, uint32_t group_y = 1, uint32_t group_z = 1) const;
+	void dispatchIndirect(vk::CommandBuffer command, const Buffer& buffer, vk::DeviceSize offset = 0) const;
+
+	template <typename T>
+	void pushConstants(vk::CommandBuffer command, const T& constants, uint32_t offset = 0) const;
+
+	vk::Pipeline       get() const;
+	vk::PipelineLayout getLayout() const;
+
+	const std::vector<vk::DescriptorSetLayoutBinding>& getDescriptorBindings() const;
+
+	const ComputePipelineConfig& getConfig() const;
+	const Shader&                getShader() const;
+
+	static uint32_t groupCount(uint32_t count, uint32_t group_size);
+};
+
+template <typename T>
+void ComputePipeline::pushConstants(vk::CommandBuffer command, const T& constants, uint32_t offset) const
+{
+	command.pushConstants(pipeline_layout, vk::ShaderStageFlagBits::eCompute, offset, sizeof(T), &constants);
+}
@@ -0,0 +1,88 @@
+#include "ComputeScheduler.hpp"
+
+#include "SyncManager.hpp"
+
+ComputeScheduler::ComputeScheduler(Context& c) :
+    context(&c)
+{
+	if (!context->getFeatures().timeline_semaphore)
+		throw std::runtime_error("Compute scheduling requires timeline semaphore support");
+
+	command_manager = std::make_unique<CommandManager>(*context, context->getComputeQueueIndex());
+	timeline = context->getSyncManager().allocateTimelineSemaphore();
+}
+
+ComputeScheduler::~ComputeScheduler()
+{
+	if (timeline)
+		wait(timeline_value);
+}
+
+uint64_t ComputeScheduler::submit(vk::CommandBuffer command, std::span<const QueueWait> waits)
+{
+	std::vector<vk::Semaphore>          wait_semaphores;
+	std::vector<uint64_t>               wait_values;
+	std::vector<vk::PipelineStageFlags> wait_stages;
+	for (const auto& wait : waits) {
+		wait_semaphores.push_back(wait.semaphore);
+		wait_values.push_back(wait.value);
+		wait_stages.push_back(wait.stages);
+	}
+
+	uint64_t signal_value = ++timeline_value;
+
+	vk::TimelineSemaphoreSubmitInfo timeline_info{};
+	timeline_info.setWaitSemaphoreValues(wait_values)
+	    .setSignalSemaphoreValues(signal_value);
+
+	vk::SubmitInfo submit_info{};
+	submit_info.setPNext(&timeline_info)
+	    .setCommandBuffers(command)
+	    .setWaitSemaphores(wait_semaphores)
+	    .setWaitDstStageMask(wait_stages)
+	    .setSignalSemaphores(timeline);
+
+	context->getComputeQueue().submit(submit_info);
+
+	return signal_value;
+}
+
+void ComputeScheduler::wait(uint64_t value, uint64_t timeout) const
+{
+	vk::SemaphoreWaitInfo wait_info{};
+	wait_info.setSemaphores(timeline)
+	    .setValues(value);
+
+	if (context->getLogicalDevice().waitSemaphores(wait_info, timeout) != vk::Result::eSuccess)
+		throw std::runtime_error("Timed out waiting for compute work");
+}
+
+bool ComputeScheduler::isComplete(uint64_t value) const
+{
+	return context->getLogicalDevice().getSemaphoreCounterValue(timeline) >= value;
+}
+
+QueueWait ComputeScheduler::waitFor(uint64_t value, vk::PipelineStageFlags stages) const
+{
+	return {timeline, value, stages};
+}
+
+CommandManager& ComputeScheduler::getCommandManager() const
+{
+	return *command_manager;
+}
+
+vk::Semaphore ComputeScheduler::getTimeline() const
+{
+	return timeline;
+}
+
+uint64_t ComputeScheduler::getLastValue() const
+{
+	return timeline_value;
+}
+
+bool ComputeScheduler::isAsync() const
+{
+	return context->hasAsyncCompute();
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <limits>
+#include <memory>
+#include <span>
+
+#include <vulkan/vulkan.hpp>
+
+#include "Context.hpp"
+#include "CommandManager.hpp"
+
+struct QueueWait {
+	vk::Semaphore          semaphore;
+	uint64_t               value{};        // ignored for binary semaphores
+	vk::PipelineStageFlags stages{vk::PipelineStageFlagBits::eComputeShader};
+};
+
+// compute submissions signal a timeline semaphore, so graphics work can wait on a specific
+// submission instead of the whole queue; single-family devices run it on the graphics queue
+class ComputeScheduler {
+private:
+	std::unique_ptr<CommandManager> command_manager;
+
+	vk::Semaphore timeline;
+	uint64_t      timeline_value{};
+
+	Context* context{};
+
+public:
+	ComputeScheduler(Context& context);
+
+	ComputeScheduler(const ComputeScheduler&) = delete;
+	ComputeScheduler& operator=(const ComputeScheduler&) = delete;
+
+	ComputeScheduler(ComputeScheduler&&) noexcept = default;
+	ComputeScheduler& operator=(ComputeScheduler&&) noexcept = default;
+
+	~ComputeScheduler();
+
+	auto submit(vk::CommandBuffer command, std::span<const QueueWait> waits = {}) -> uint64_t;
+
+	void wait(uint64_t value, uint64_t timeout = std::numeric_limits<uint64_t>::max()) const;
+	bool isComplete(uint64_t value) const;
+
+	// a graphics submission waiting on (getTimeline(), value) overlaps everything submitted before it
+	QueueWait waitFor(uint64_t value, vk::PipelineStageFlags stages) const;
+
+	auto getCommandManager() const -> CommandManager&;
+	auto getTimeline() const -> vk::Semaphore;
+	auto getLastValue() const -> uint64_t;
+	bool isAsync() const;
+};
@@ -1,9 +1,12 @@
+#include <algorithm>
 #include <set>
 #include <print>
+#include <string_view>
 
 #include "DescriptorManager.hpp"
 #include "CommandManager.hpp"
 #include "SyncManager.hpp"
+#include "ComputeScheduler.hpp"
 
 Context::Context(Window& window) :
     window(&window)
@@ -13,16 +16,24 @@ Context::Context(Window& window) :
 	pickPhysicalDevice();
 	createLogicalDevice();
 
+	// shared by graphics and compute pipelines so recreating a pipeline reuses compiled state
+	pipeline_cache = logical_device.createPipelineCache(vk::PipelineCacheCreateInfo{});
+
 	descriptor_manager = std::make_unique<DescriptorManager>(*this);
-	command_manager = std::make_unique<CommandManager>(*this);
+	command_manager = std::make_unique<CommandManager>(*this, getGraphicsQueueIndex());
 	sync_manager = std::make_unique<SyncManager>(*this);
+
+	if (device_features.timeline_semaphore)
+		compute_scheduler = std::make_unique<ComputeScheduler>(*this);
 }
 
 Context::~Context()
 {
+	compute_scheduler.reset();
 	sync_manager.reset();
 	command_manager.reset();
 	descriptor_manager.reset();
+	logical_device.destroyPipelineCache(pipeline_cache);
 	logical_device.destroy();
 	instance.destroySurfaceKHR(surface);
 	instance.destroy();
@@ -76,15 +87,19 @@ void Context::pickPhysicalDevice()
 void Context::createLogicalDevice()
 {
 	queue_family_indices = queryQueueFamilyIndices();
+	device_features = queryDeviceFeatures();
 
-	std::array layers = {"VK_LAYER_KHRONOS_validation"};
-	std::array extensions = {VK_KHR_SWAPCHAIN_EXTENSION_NAME};
+	std::array               layers = {"VK_LAYER_KHRONOS_validation"};
+	std::vector<const char*> extensions = {VK_KHR_SWAPCHAIN_EXTENSION_NAME};
+	if (device_features.index_type_uint8)
+		extensions.push_back(VK_EXT_INDEX_TYPE_UINT8_EXTENSION_NAME);
 
 	std::vector<vk::DeviceQueueCreateInfo> queue_create_infos{};
 
 	std::set<uint32_t> unique_queue_families = {
 	    queue_family_indices.graphics_family.value(),
 	    queue_family_indices.present_family.value(),
+	    queue_family_indices.compute_family.value(),
 	};
 
 	float queue_priority = 1.0f;
@@ -96,7 +111,28 @@ void Context::createLogicalDevice()
 		queue_create_infos.push_back(std::move(queue_create_info));
 	}
 
-	vk::DeviceCreateInfo create_info{};
+	vk::StructureChain<vk::DeviceCreateInfo, vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan12Features, vk::PhysicalDeviceVulkan13Features,
+	                   vk::PhysicalDeviceIndexTypeUint8FeaturesEXT>
+	    create_chain{};
+	create_chain.get<vk::PhysicalDeviceFeatures2>().features
+	    .setPipelineStatisticsQuery(device_features.pipeline_statistics_query)
+	    .setMultiDrawIndirect(device_features.multi_draw_indirect)
+	    .setDrawIndirectFirstInstance(device_features.draw_indirect_first_instance);
+	create_chain.get<vk::PhysicalDeviceVulkan12Features>()
+	    .setTimelineSemaphore(device_features.timeline_semaphore)
+	    .setDrawIndirectCount(device_features.draw_indirect_count);
+	if (physical_device.getProperties().apiVersion < VK_API_VERSION_1_2)
+		create_chain.unlink<vk::PhysicalDeviceVulkan12Features>();
+	create_chain.get<vk::PhysicalDeviceVulkan13Features>()
+	    .setDynamicRendering(device_features.dynamic_rendering)
+	    .setSynchronization2(device_features.synchronization2);
+	if (physical_device.getProperties().apiVersion < VK_API_VERSION_1_3)
+		create_chain.unlink<vk::PhysicalDeviceVulkan13Features>();
+	create_chain.get<vk::PhysicalDeviceIndexTypeUint8FeaturesEXT>().setIndexTypeUint8(vk::True);
+	if (!device_features.index_type_uint8)
+		create_chain.unlink<vk::PhysicalDeviceIndexTypeUint8FeaturesEXT>();
+
+	auto& create_info = create_chain.get<vk::DeviceCreateInfo>();
 	create_info.setQueueCreateInfos(queue_create_infos)
 	    .setEnabledLayerCount(layers.size())
 	    .setPEnabledLayerNames(layers)
@@ -107,6 +143,7 @@ void Context::createLogicalDevice()
 
 	graphics_queue = logical_device.getQueue(queue_family_indices.graphics_family.value(), 0);
 	present_queue = logical_device.getQueue(queue_family_indices.present_family.value(), 0);
+	compute_queue = logical_device.getQueue(queue_family_indices.compute_family.value(), 0);
 }
 
 QueueFamilyIndices Context::queryQueueFamilyIndices() const
@@ -117,19 +154,65 @@ QueueFamilyIndices Context::queryQueueFamilyIndices() const
 	for (int i = 0; i < properties.size(); i++) {
 		const auto& property = properties[i];
 
-		if (property.queueFlags & vk::QueueFlagBits::eGraphics)
+		if (!queue_family_indices.graphics_family && property.queueFlags & vk::QueueFlagBits::eGraphics)
 			queue_family_indices.graphics_family = i;
 
-		if (physical_device.getSurfaceSupportKHR(i, surface))
+		if (!queue_family_indices.present_family && physical_device.getSurfaceSupportKHR(i, surface))
 			queue_family_indices.present_family = i;
 
-		if (queue_family_indices)
-			break;
+		// a compute family without graphics usually maps to a separate hardware queue
+		if (!queue_family_indices.compute_family && property.queueFlags & vk::QueueFlagBits::eCompute
+		    && !(property.queueFlags & vk::QueueFlagBits::eGraphics))
+			queue_family_indices.compute_family = i;
 	}
 
+	// graphics families always support compute, so single-family devices fall back to it
+	if (!queue_family_indices.compute_family)
+		queue_family_indices.compute_family = queue_family_indices.graphics_family;
+
 	return queue_family_indices;
 }
 
+DeviceFeatures Context::queryDeviceFeatures() const
+{
+	DeviceFeatures features{};
+
+	auto core = physical_device.getFeatures();
+	features.pipeline_statistics_query = core.pipelineStatisticsQuery;
+	features.multi_draw_indirect = core.multiDrawIndirect;
+	features.draw_indirect_first_instance = core.drawIndirectFirstInstance;
+
+	// without it meshes of up to 256 vertices fall back to 16-bit indices
+	auto extensions = physical_device.enumerateDeviceExtensionProperties();
+	bool has_uint8 = std::ranges::any_of(extensions, [](const vk::ExtensionProperties& extension) {
+		return std::string_view(extension.extensionName) == VK_EXT_INDEX_TYPE_UINT8_EXTENSION_NAME;
+	});
+	if (has_uint8 && physical_device.getProperties().apiVersion >= VK_API_VERSION_1_1) {
+		auto uint8_chain = physical_device.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceIndexTypeUint8FeaturesEXT>();
+		features.index_type_uint8 = uint8_chain.get<vk::PhysicalDeviceIndexTypeUint8FeaturesEXT>().indexTypeUint8;
+	}
+
+	if (physical_device.getProperties().apiVersion < VK_API_VERSION_1_2)
+		return features;
+
+	auto vulkan12_chain = physical_device.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan12Features>();
+	const auto& vulkan12 = vulkan12_chain.get<vk::PhysicalDeviceVulkan12Features>();
+
+	features.timeline_semaphore = vulkan12.timelineSemaphore;
+	features.draw_indirect_count = vulkan12.drawIndirectCount;
+
+	if (physical_device.getProperties().apiVersion < VK_API_VERSION_1_3)
+		return features;
+
+	auto chain = physical_device.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan13Features>();
+	const auto& vulkan13 = chain.get<vk::PhysicalDeviceVulkan13Features>();
+
+	features.dynamic_rendering = vulkan13.dynamicRendering;
+	features.synchronization2 = vulkan13.synchronization2;
+
+	return features;
+}
+
 void Context::execute(std::function<void(vk::CommandBuffer)> func)
 {
 	auto command_buffer = command_manager->allocateBuffer();
@@ -147,7 +230,9 @@ void Context::submit(vk::CommandBuffer                       command,
                      std::span<const vk::Semaphore>          wait_semaphores,
                      std::span<const vk::Semaphore>          signal_semaphores,
                      std::span<const vk::PipelineStageFlags> wait_stages,
-                     vk::Fence                               fence)
+                     vk::Fence                               fence,
+                     std::span<const uint64_t>               wait_values,
+                     std::span<const uint64_t>               signal_values)
 {
 	vk::SubmitInfo submit_info{};
 	submit_info.setCommandBuffers(command)
@@ -155,6 +240,13 @@ void Context::submit(vk::CommandBuffer                       command,
 	    .setSignalSemaphores(signal_semaphores)
 	    .setWaitDstStageMask(wait_stages);
 
+	// values line up with the semaphores, binary semaphores ignore theirs
+	vk::TimelineSemaphoreSubmitInfo timeline_info{};
+	timeline_info.setWaitSemaphoreValues(wait_values)
+	    .setSignalSemaphoreValues(signal_values);
+	if (!wait_values.empty() || !signal_values.empty())
+		submit_info.setPNext(&timeline_info);
+
 	graphics_queue.submit(submit_info, fence);
 }
 
@@ -201,6 +293,16 @@ vk::Queue Context::getPresentQueue() const
 	return present_queue;
 }
 
+vk::Queue Context::getComputeQueue() const
+{
+	return compute_queue;
+}
+
+vk::PipelineCache Context::getPipelineCache() const
+{
+	return pipeline_cache;
+}
+
 DescriptorManager& Context::getDescriptorManager() const
 {
 	return *descriptor_manager;
@@ -216,6 +318,14 @@ SyncManager& Context::getSyncManager() const
 	return *sync_manager;
 }
 
+ComputeScheduler& Context::getComputeScheduler() const
+{
+	if (!compute_scheduler)
+		throw std::runtime_error("Compute scheduling requires timeline semaphore support");
+
+	return *compute_scheduler;
+}
+
 uint32_t Context::getGraphicsQueueIndex() const
 {
 	return queue_family_indices.graphics_family.value();
@@ -226,6 +336,28 @@ uint32_t Context::getPresentQueueIndex() const
 	return queue_family_indices.present_family.value();
 }
 
+uint32_t Context::getComputeQueueIndex() const
+{
+	return queue_family_indices.compute_family.value();
+}
+
+bool Context::hasAsyncCompute() const
+{
+	return getComputeQueueIndex() != getGraphicsQueueIndex();
+}
+
+std::vector<uint32_t> Context::getQueueFamilies() const
+{
+	std::set<uint32_t> families = {getGraphicsQueueIndex(), getPresentQueueIndex(), getComputeQueueIndex()};
+
+	return {families.begin(), families.end()};
+}
+
+const DeviceFeatures& Context::getFeatures() const
+{
+	return device_features;
+}
+
 QueueFamilyIndices::operator bool() const
 {
 	return graphics_family.has_value() && present_family.has_value();
@@ -9,16 +9,29 @@
 class DescriptorManager;
 class CommandManager;
 class SyncManager;
+class ComputeScheduler;
 
 class Buffer;
 
 struct QueueFamilyIndices {
 	std::optional<uint32_t> graphics_family;
 	std::optional<uint32_t> present_family;
+	std::optional<uint32_t> compute_family;
 
 	operator bool() const;
 };
 
+struct DeviceFeatures {
+	bool dynamic_rendering{};
+	bool synchronization2{};
+	bool pipeline_statistics_query{};
+	bool timeline_semaphore{};
+	bool multi_draw_indirect{};
+	bool draw_indirect_first_instance{};
+	bool draw_indirect_count{};
+	bool index_type_uint8{};        // VK_EXT_index_type_uint8
+};
+
 class Context {
 private:
 	vk::Instance       instance;
@@ -27,14 +40,18 @@ private:
 	vk::Device         logical_device;
 	vk::Queue          graphics_queue;
 	vk::Queue          present_queue;
+	vk::Queue          compute_queue;
+	vk::PipelineCache  pipeline_cache;
 
 	std::unique_ptr<DescriptorManager> descriptor_manager;
 	std::unique_ptr<CommandManager>    command_manager;
 	std::unique_ptr<SyncManager>       sync_manager;
+	std::unique_ptr<ComputeScheduler>  compute_scheduler;
 
 	Window* window{};
 
 	QueueFamilyIndices queue_family_indices;
+	DeviceFeatures     device_features;
 
 	void createInstance();
 	void createSurface();
@@ -42,6 +59,7 @@ private:
 	void createLogicalDevice();
 
 	QueueFamilyIndices queryQueueFamilyIndices() const;
+	DeviceFeatures     queryDeviceFeatures() const;
 
 public:
 	Context(Window& window);
@@ -60,7 +78,9 @@ public:
 	            std::span<const vk::Semaphore>          wait_semaphores = {},
 	            std::span<const vk::Semaphore>          signal_semaphores = {},
 	            std::span<const vk::PipelineStageFlags> wait_stages = {},
-	            vk::Fence                               fence = {});
+	            vk::Fence                               fence = {},
+	            std::span<const uint64_t>               wait_values = {},
+	            std::span<const uint64_t>               signal_values = {});
 
 	void present(std::span<const uint32_t>         image_indices,
 	             std::span<const vk::SwapchainKHR> swap_chains = {},
@@ -72,10 +92,20 @@ public:
 	vk::Device         getLogicalDevice() const;
 	vk::Queue          getGraphicsQueue() const;
 	vk::Queue          getPresentQueue() const;
+	vk::Queue          getComputeQueue() const;
 	uint32_t           getGraphicsQueueIndex() const;
 	uint32_t           getPresentQueueIndex() const;
+	uint32_t           getComputeQueueIndex() const;
+	vk::PipelineCache  getPipelineCache() const;
+
+	// compute runs on its own queue family and can overlap graphics work
+	bool                  hasAsyncCompute() const;
+	std::vector<uint32_t> getQueueFamilies() const;
+
+	const DeviceFeatures& getFeatures() const;
 
 	DescriptorManager& getDescriptorManager() const;
 	CommandManager&    getCommandManager() const;
 	SyncManager&       getSyncManager() const;
+	ComputeScheduler&  getComputeScheduler() const;
 };
@@ -32,6 +32,11 @@ vk::DescriptorPool DescriptorManager::createPool(vk::DescriptorType type, uint32
 	pool_sizes[0].setType(type).setDescriptorCount(max_sets);
 	pool_sizes[1].setType(vk::DescriptorType::eCombinedImageSampler).setDescriptorCount(max_sets);
 
+	return createPool(pool_sizes, max_sets);
+}
+
+vk::DescriptorPool DescriptorManager::createPool(std::span<const vk::DescriptorPoolSize> pool_sizes, uint32_t max_sets)
+{
 	vk::DescriptorPoolCreateInfo create_info{};
 	create_info.setPoolSizes(pool_sizes)
 	    .setMaxSets(max_sets)
@@ -118,6 +123,24 @@ void DescriptorManager::updateSet(vk::DescriptorSet set, uint32_t binding, vk::D
 	context->getLogicalDevice().updateDescriptorSets(write, {});
 }
 
+void DescriptorManager::updateSet(vk::DescriptorSet set, uint32_t binding, vk::DescriptorType type, const Buffer& buffer, vk::DeviceSize offset, vk::DeviceSize range)
+{
+	vk::DescriptorBufferInfo buffer_info{};
+	buffer_info.setBuffer(buffer.get())
+	    .setOffset(offset)
+	    .setRange(range);
+
+	vk::WriteDescriptorSet write{};
+	write.setDstSet(set)
+	    .setDstBinding(binding)
+	    .setDstArrayElement(0)
+	    .setDescriptorType(type)
+	    .setBufferInfo(buffer_info);
+
+	context->getLogicalDevice().updateDescriptorSets(write, {});
+}
+
+// storage images are accessed in the general layout and have no sampler
 void DescriptorManager::updateSet(vk::DescriptorSet set, uint32_t binding, vk::DescriptorType type, const Image* texture)
 {
 	vk::WriteDescriptorSet write{};
@@ -130,8 +153,12 @@ void DescriptorManager::updateSet(vk::DescriptorSet set, uint32_t binding, vk::D
 	if (texture) {
 		vk::DescriptorImageInfo image_info{};
 		image_info.setImageLayout(vk::ImageLayout::eShaderReadOnlyOptimal)
-		    .setImageView(texture->getView())
-		    .setSampler(texture->getSampler().get());
+		    .setImageView(texture->getView());
+
+		if (type == vk::DescriptorType::eStorageImage)
+			image_info.setImageLayout(vk::ImageLayout::eGeneral);
+		else
+			image_info.setSampler(texture->getSampler().get());
 
 		write.setImageInfo(image_info);
 	}
@@ -139,6 +166,23 @@ void DescriptorManager::updateSet(vk::DescriptorSet set, uint32_t binding, vk::D
 	context->getLogicalDevice().updateDescriptorSets(write, {});
 }
 
+// for views that are not an Image's own, e.g. single mip levels or render graph images
+void DescriptorManager::updateSet(vk::DescriptorSet set, uint32_t binding, vk::DescriptorType type, vk::ImageView view, vk::ImageLayout layout)
+{
+	vk::DescriptorImageInfo image_info{};
+	image_info.setImageView(view)
+	    .setImageLayout(layout);
+
+	vk::WriteDescriptorSet write{};
+	write.setDstSet(set)
+	    .setDstBinding(binding)
+	    .setDstArrayElement(0)
+	    .setDescriptorType(type)
+	    .setImageInfo(image_info);
+
+	context->getLogicalDevice().updateDescriptorSets(write, {});
+}
+
 bool DescriptorManager::hasPool(vk::DescriptorPool pool) const
 {
 	return descriptor_map.find(pool) != descriptor_map.end();
@@ -160,3 +204,14 @@ const std::vector<vk::DescriptorSet>& DescriptorManager::getSets(vk::DescriptorP
 
 	throw std::runtime_error("Descriptor pool not found");
 }
+
+vk::DescriptorSetLayoutBinding DescriptorManager::binding(uint32_t binding, vk::DescriptorType type, vk::ShaderStageFlags stages, uint32_t count)
+{
+	vk::DescriptorSetLayoutBinding layout_binding{};
+	layout_binding.setBinding(binding)
+	    .setDescriptorType(type)
+	    .setDescriptorCount(count)
+	    .setStageFlags(stages);
+
+	return layout_binding;
+}
@@ -33,6 +33,7 @@ public:
 	~DescriptorManager();
 
 	vk::DescriptorPool      createPool(vk::DescriptorType type, uint32_t max_sets);
+	vk::DescriptorPool      createPool(std::span<const vk::DescriptorPoolSize> pool_sizes, uint32_t max_sets);
 	vk::DescriptorSetLayout createLayout(std::span<const vk::DescriptorSetLayoutBinding> bindings);
 
 	vk::DescriptorSet              allocateSet(vk::DescriptorPool pool, const vk::DescriptorSetLayout& layout);
@@ -44,9 +45,16 @@ public:
 
 	void updateSet(vk::DescriptorSet set, uint32_t binding, vk::DescriptorType type, const Buffer* buffer = {});
 	void updateSet(vk::DescriptorSet set, uint32_t binding, vk::DescriptorType type, const Image* texture = {});
+	void updateSet(vk::DescriptorSet set, uint32_t binding, vk::DescriptorType type, const Buffer& buffer, vk::DeviceSize offset, vk::DeviceSize range);
+	void updateSet(vk::DescriptorSet set, uint32_t binding, vk::DescriptorType type, vk::ImageView view, vk::ImageLayout layout);
 
 	bool hasPool(vk::DescriptorPool pool) const;
 	void resetPool(vk::DescriptorPool pool);
 
 	const std::vector<vk::DescriptorSet>& getSets(vk::DescriptorPool pool) const;
+
+	static vk::DescriptorSetLayoutBinding binding(uint32_t             binding,
+	                                              vk::DescriptorType   type,
+	                                              vk::ShaderStageFlags stages = vk::ShaderStageFlagBits::eCompute,
+	                                              uint32_t             count = 1);
 };
@@ -0,0 +1,74 @@
+#include "DynamicRendering.hpp"
+
+DynamicRendering::DynamicRendering(Context& c, SwapChain& s, const DynamicRenderingConfig& p) :
+    context(&c),
+    swap_chain(&s),
+    config(p)
+{
+	if (!context->getFeatures().dynamic_rendering || !context->getFeatures().synchronization2)
+		throw std::runtime_error("Dynamic rendering requires Vulkan 1.3 dynamicRendering and synchronization2");
+
+	config.color_formats.front() = swap_chain->getSurfaceFormat().format;
+	if (config.depth_format != vk::Format::eUndefined)
+		config.depth_format = swap_chain->getDepthFormat();
+}
+
+// attachments with a clear value are cleared, the others keep their contents;
+// the depth clear value follows the color ones
+void DynamicRendering::begin(vk::CommandBuffer               command_buffer,
+                             std::span<const vk::ImageView>  color_views,
+                             vk::ImageView                   depth_view,
+                             const vk::Extent2D&             extent,
+                             std::span<const vk::ClearValue> clear_values)
+{
+	std::vector<vk::RenderingAttachmentInfo> color_attachments(color_views.size());
+	for (size_t i = 0; i < color_views.size(); i++) {
+		color_attachments[i]
+		    .setImageView(color_views[i])
+		    .setImageLayout(vk::ImageLayout::eColorAttachmentOptimal)
+		    .setLoadOp(vk::AttachmentLoadOp::eLoad)
+		    .setStoreOp(config.color_store_op);
+		if (i < clear_values.size())
+			color_attachments[i].setLoadOp(vk::AttachmentLoadOp::eClear)
+			    .setClearValue(clear_values[i]);
+	}
+
+	vk::RenderingAttachmentInfo depth_attachment{};
+	depth_attachment.setImageView(depth_view)
+	    .setImageLayout(vk::ImageLayout::eDepthAttachmentOptimal)
+	    .setLoadOp(vk::AttachmentLoadOp::eLoad)
+	    .setStoreOp(config.depth_store_op);
+	if (clear_values.size() > color_views.size())
+		depth_attachment.setLoadOp(vk::AttachmentLoadOp::eClear)
+		    .setClearValue(clear_values[color_views.size()]);
+
+	vk::RenderingInfo rendering_info{};
+	rendering_info.setRenderArea({{0, 0}, extent})
+	    .setLayerCount(1)
+	    .setColorAttachments(color_attachments);
+	if (depth_view)
+		rendering_info.setPDepthAttachment(&depth_attachment);
+
+	command_buffer.beginRendering(rendering_info);
+}
+
+void DynamicRendering::end(vk::CommandBuffer command_buffer)
+{
+	command_buffer.endRendering();
+}
+
+vk::PipelineRenderingCreateInfo DynamicRendering::getPipelineRenderingInfo(bool depth_only) const
+{
+	vk::PipelineRenderingCreateInfo rendering_info{};
+	if (!depth_only)
+		rendering_info.setColorAttachmentFormats(config.color_formats);
+	rendering_info.setDepthAttachmentFormat(config.depth_format)
+	    .setStencilAttachmentFormat(config.stencil_format);
+
+	return rendering_info;
+}
+
+const DynamicRenderingConfig& DynamicRendering::getConfig() const
+{
+	return config;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <vulkan/vulkan.hpp>
+
+#include "Context.hpp"
+#include "SwapChain.hpp"
+
+struct DynamicRenderingConfig {
+	std::vector<vk::Format> color_formats = {vk::Format::eB8G8R8A8Srgb};
+	vk::Format              depth_format = vk::Format::eD32Sfloat;
+	vk::Format              stencil_format = vk::Format::eUndefined;
+
+	vk::AttachmentStoreOp color_store_op = vk::AttachmentStoreOp::eStore;
+	vk::AttachmentStoreOp depth_store_op = vk::AttachmentStoreOp::eStore;
+};
+
+class DynamicRendering {
+private:
+	DynamicRenderingConfig config;
+
+	Context*   context{};
+	SwapChain* swap_chain{};
+
+public:
+	DynamicRendering(Context& context, SwapChain& swap_chain, const DynamicRenderingConfig& config = {});
+
+	DynamicRendering(const DynamicRendering&) = delete;
+	DynamicRendering& operator=(const DynamicRendering&) = delete;
+
+	DynamicRendering(DynamicRendering&&) noexcept = default;
+	DynamicRendering& operator=(DynamicRendering&&) noexcept = default;
+
+	~DynamicRendering() = default;
+
+	void begin(vk::CommandBuffer               command_buffer,
+	           std::span<const vk::ImageView>  color_views,
+	           vk::ImageView                   depth_view,
+	           const vk::Extent2D&             extent,
+	           std::span<const vk::ClearValue> clear_values = {});
+	void end(vk::CommandBuffer command_buffer);
+
+	vk::PipelineRenderingCreateInfo getPipelineRenderingInfo(bool depth_only = false) const;
+
+	const DynamicRenderingConfig& getConfig() const;
+};
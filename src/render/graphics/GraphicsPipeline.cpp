@@ -2,7 +2,6 @@
 
 #include "DescriptorManager.hpp"
 #include "Shader.hpp"
-#include "render/rhi/GpuVertex.hpp"
 #include "render/rhi/GpuUniforms.hpp"
 
 GraphicsPipeline::GraphicsPipeline(Context& c, RenderPass& r, const GraphicsPipelineConfig& p) :
@@ -11,25 +10,38 @@ GraphicsPipeline::GraphicsPipeline(Context& c, RenderPass& r, const GraphicsPipe
     shader(c, SHADER_DIR "/default.spv"),
     config(p)
 {
-	// move these to Shader
-	shader.setStage(vk::ShaderStageFlagBits::eVertex, "vertexMain");
-	shader.setStage(vk::ShaderStageFlagBits::eFragment, "fragmentMain");
+	init();
+}
+
+GraphicsPipeline::GraphicsPipeline(Context& c, DynamicRendering& d, const GraphicsPipelineConfig& p) :
+    context(&c),
+    dynamic_rendering(&d),
+    shader(c, SHADER_DIR "/default.spv"),
+    config(p)
+{
+	init();
+}
 
-	auto vbinding = GpuVertex::binding();
-	auto vattributes = GpuVertex::attributes();
+void GraphicsPipeline::init()
+{
+	shader.setStage(vk::ShaderStageFlagBits::eVertex, config.vertex_entry);
+	if (!config.fragment_entry.empty())
+		shader.setStage(vk::ShaderStageFlagBits::eFragment, config.fragment_entry);
 
 	descriptor_bindings.push_back(GpuTransform::binding(0));
 	descriptor_bindings.push_back(Sampler::binding(1));
-
-	vk::DescriptorSetLayoutBinding tex_binding{};
-	tex_binding.setBinding(1)
-	    .setDescriptorType(vk::DescriptorType::eCombinedImageSampler)
-	    .setStageFlags(vk::ShaderStageFlagBits::eFragment);
+	descriptor_bindings.push_back(GpuObject::binding(2));
+	descriptor_bindings.push_back(GpuVertex::storageBinding(3));
+	descriptor_bindings.push_back(GpuVertex::storageBinding(4));
+	descriptor_bindings.push_back(GpuVertex::storageBinding(5));
 
 	auto layout = context->getDescriptorManager().createLayout(descriptor_bindings);
 
-	config.vertex_input.setVertexBindingDescriptions(vbinding)
-	    .setVertexAttributeDescriptions(vattributes);
+	// re-point the state structs at this copy of the config
+	config.vertex_input.setVertexBindingDescriptions(config.vertex_bindings)
+	    .setVertexAttributeDescriptions(config.vertex_attributes);
+	config.color_blend_state.setAttachments(config.color_blend_attachment);
+	config.dynamic_state.setDynamicStates(config.dynamic_states);
 	config.pipeline_layout.setSetLayouts(layout);
 
 	pipeline_layout = context->getLogicalDevice().createPipelineLayout(config.pipeline_layout);
@@ -45,7 +57,7 @@ GraphicsPipeline::~GraphicsPipeline()
 
 void GraphicsPipeline::create(const GraphicsPipelineConfig& config)
 {
-	auto stages = shader.getStages();
+	auto stages = shader.getStages(&config.specialization);
 
 	vk::GraphicsPipelineCreateInfo pipeline_info{};
 	pipeline_info.setStages(stages)
@@ -57,11 +69,20 @@ void GraphicsPipeline::create(const GraphicsPipelineConfig& config)
 	    .setPDepthStencilState(&config.depth_stencil)
 	    .setPColorBlendState(&config.color_blend_state)
 	    .setPDynamicState(&config.dynamic_state)
-	    .setLayout(pipeline_layout)
-	    .setRenderPass(render_pass->get())
-	    .setSubpass(0);
-
-	pipeline = context->getLogicalDevice().createGraphicsPipeline({}, pipeline_info).value;
+	    .setLayout(pipeline_layout);
+
+	vk::PipelineRenderingCreateInfo       rendering_info{};
+	vk::PipelineColorBlendStateCreateInfo depth_only_blend_state{};
+	if (dynamic_rendering) {
+		rendering_info = dynamic_rendering->getPipelineRenderingInfo(config.depth_only);
+		pipeline_info.setPNext(&rendering_info);
+		if (config.depth_only)
+			pipeline_info.setPColorBlendState(&depth_only_blend_state);
+	} else
+		pipeline_info.setRenderPass(render_pass->get())
+		    .setSubpass(0);
+
+	pipeline = context->getLogicalDevice().createGraphicsPipeline(context->getPipelineCache(), pipeline_info).value;
 }
 
 vk::Pipeline GraphicsPipeline::get() const
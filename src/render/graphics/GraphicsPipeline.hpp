@@ -6,9 +6,18 @@
 
 #include "Context.hpp"
 #include "RenderPass.hpp"
+#include "DynamicRendering.hpp"
 #include "Shader.hpp"
+#include "render/rhi/GpuVertex.hpp"
 
 struct GraphicsPipelineConfig {
+	std::string vertex_entry = "vertexMain";
+	std::string fragment_entry = "fragmentMain";        // may be empty for depth-only pipelines
+	bool        depth_only{false};                       // no color attachments under dynamic rendering
+
+	std::vector<vk::VertexInputBindingDescription>   vertex_bindings = {GpuVertex::positionBinding(), GpuVertex::binding()};
+	std::vector<vk::VertexInputAttributeDescription> vertex_attributes = GpuVertex::attributes();
+
 	vk::PipelineVertexInputStateCreateInfo vertex_input{};
 
 	vk::PipelineInputAssemblyStateCreateInfo input_assembly{
@@ -47,7 +56,12 @@ struct GraphicsPipelineConfig {
 	    vk::False,
 	};
 
-	vk::PipelineDepthStencilStateCreateInfo depth_stencil{};
+	vk::PipelineDepthStencilStateCreateInfo depth_stencil{
+	    {},
+	    vk::True,
+	    vk::True,
+	    vk::CompareOp::eLess,
+	};
 
 	vk::PipelineColorBlendAttachmentState color_blend_attachment{
 	    vk::False,
@@ -80,6 +94,8 @@ struct GraphicsPipelineConfig {
 	};
 
 	vk::PipelineLayoutCreateInfo pipeline_layout{};
+
+	ShaderSpecialization specialization{};
 };
 
 class GraphicsPipeline {
@@ -93,11 +109,15 @@ private:
 
 	std::vector<vk::DescriptorSetLayoutBinding> descriptor_bindings;
 
-	Context*    context{};
-	RenderPass* render_pass{};
+	Context*          context{};
+	RenderPass*       render_pass{};
+	DynamicRendering* dynamic_rendering{};
+
+	void init();
 
 public:
 	GraphicsPipeline(Context& context, RenderPass& render_pass, const GraphicsPipelineConfig& config = {});
+	GraphicsPipeline(Context& context, DynamicRendering& dynamic_rendering, const GraphicsPipelineConfig& config = {});
 
 	GraphicsPipeline(const GraphicsPipeline&) = delete;
 	GraphicsPipeline& operator=(const GraphicsPipeline&) = delete;
@@ -18,8 +18,39 @@ Image::Image(Context& context, std::string_view file_path) :
 	freeImage();
 }
 
+Image::Image(Context& context, vk::Extent2D extent, vk::Format format, vk::ImageUsageFlags usage, vk::ImageAspectFlags aspect, uint32_t mip_levels) :
+    context(&context),
+    format(format),
+    aspect(aspect),
+    width(static_cast<int>(extent.width)),
+    height(static_cast<int>(extent.height)),
+    mip_levels(mip_levels)
+{
+	createImage(extent.width, extent.height, usage);
+	allocateMemory();
+	createImageView();
+}
+
+Image::Image(Context& context) :
+    context(&context)
+{}
+
+std::unique_ptr<Image> Image::createUnbound(Context& context, vk::Extent2D extent, vk::Format format, vk::ImageUsageFlags usage, vk::ImageAspectFlags aspect)
+{
+	auto image = std::unique_ptr<Image>(new Image(context));
+	image->format = format;
+	image->aspect = aspect;
+	image->width = static_cast<int>(extent.width);
+	image->height = static_cast<int>(extent.height);
+	image->createImage(extent.width, extent.height, usage);
+
+	return image;
+}
+
 Image::~Image()
 {
+	for (auto mip_view : mip_views)
+		context->getLogicalDevice().destroyImageView(mip_view);
 	context->getLogicalDevice().destroyImageView(view);
 	context->getLogicalDevice().freeMemory(memory);
 	context->getLogicalDevice().destroyImage(image);
@@ -50,17 +81,17 @@ void Image::createBuffer(uint32_t image_size)
 	buffer->upload(data, image_size);
 }
 
-void Image::createImage(uint32_t width, uint32_t height)
+void Image::createImage(uint32_t width, uint32_t height, vk::ImageUsageFlags usage)
 {
 	vk::ImageCreateInfo create_info{};
 	create_info.setImageType(vk::ImageType::e2D)
 	    .setExtent({width, height, 1})
-	    .setMipLevels(1)
+	    .setMipLevels(mip_levels)
 	    .setArrayLayers(1)
-	    .setFormat(vk::Format::eR8G8B8A8Srgb)
+	    .setFormat(format)
 	    .setTiling(vk::ImageTiling::eOptimal)
 	    .setInitialLayout(vk::ImageLayout::eUndefined)
-	    .setUsage(vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled)
+	    .setUsage(usage)
 	    .setSamples(vk::SampleCountFlagBits::e1)
 	    .setSharingMode(vk::SharingMode::eExclusive);
 
@@ -81,30 +112,48 @@ void Image::allocateMemory()
 	context->getLogicalDevice().bindImageMemory(image, memory, 0);
 }
 
+// the memory stays owned by the caller and is not freed with the image
+void Image::bindMemory(vk::DeviceMemory memory, vk::DeviceSize offset)
+{
+	context->getLogicalDevice().bindImageMemory(image, memory, offset);
+	createImageView();
+}
+
 void Image::createImageView()
 {
 	vk::ImageSubresourceRange range{};
 	vk::ComponentMapping      mapping{};
 	range.setBaseMipLevel(0)
-	    .setLevelCount(1)
+	    .setLevelCount(mip_levels)
 	    .setBaseArrayLayer(0)
 	    .setLayerCount(1)
-	    .setAspectMask(vk::ImageAspectFlagBits::eColor);
+	    .setAspectMask(aspect);
 
 	vk::ImageViewCreateInfo create_info{};
 	create_info.setImage(image)
 	    .setViewType(vk::ImageViewType::e2D)
-	    .setFormat(vk::Format::eR8G8B8A8Srgb)
+	    .setFormat(format)
 	    .setSubresourceRange(range)
 	    .setComponents(mapping);
 
 	view = context->getLogicalDevice().createImageView(create_info);
+
+	if (mip_levels == 1)
+		return;
+
+	for (uint32_t level = 0; level < mip_levels; level++) {
+		range.setBaseMipLevel(level).setLevelCount(1);
+		create_info.setSubresourceRange(range);
+		mip_views.push_back(context->getLogicalDevice().createImageView(create_info));
+	}
 }
 
 void Image::transitionImageLayout(vk::CommandBuffer command, vk::Image image, vk::Format format, vk::ImageLayout old_layout, vk::ImageLayout new_layout)
 {
+	bool depth = new_layout == vk::ImageLayout::eDepthAttachmentOptimal;
+
 	vk::ImageSubresourceRange range{};
-	range.setAspectMask(vk::ImageAspectFlagBits::eColor)
+	range.setAspectMask(depth ? vk::ImageAspectFlagBits::eDepth : vk::ImageAspectFlagBits::eColor)
 	    .setBaseMipLevel(0)
 	    .setLevelCount(1)
 	    .setBaseArrayLayer(0)
@@ -179,6 +228,31 @@ vk::ImageView Image::getView() const
 	return view;
 }
 
+vk::Format Image::getFormat() const
+{
+	return format;
+}
+
+vk::Extent2D Image::getExtent() const
+{
+	return {static_cast<uint32_t>(width), static_cast<uint32_t>(height)};
+}
+
+vk::ImageView Image::getMipView(uint32_t level) const
+{
+	return mip_views.empty() ? view : mip_views.at(level);
+}
+
+uint32_t Image::getMipLevels() const
+{
+	return mip_levels;
+}
+
+vk::MemoryRequirements Image::getMemoryRequirements() const
+{
+	return context->getLogicalDevice().getImageMemoryRequirements(image);
+}
+
 void Image::setSampler(Sampler& sampler)
 {
 	this->sampler = &sampler;
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <vector>
+
 #include <vulkan/vulkan.hpp>
 
 #include "Context.hpp"
@@ -12,10 +14,16 @@ private:
 	vk::ImageView    view;
 	vk::DeviceMemory memory;
 
-	int   width{};
-	int   height{};
-	int   channels{};
-	void* data;
+	std::vector<vk::ImageView> mip_views;
+
+	vk::Format           format{vk::Format::eR8G8B8A8Srgb};
+	vk::ImageAspectFlags aspect{vk::ImageAspectFlagBits::eColor};
+
+	int      width{};
+	int      height{};
+	int      channels{};
+	uint32_t mip_levels{1};
+	void*    data{};
 
 	std::unique_ptr<Buffer> buffer;
 
@@ -24,8 +32,16 @@ private:
 
 	uint32_t queryMemoryType(uint32_t type, vk::MemoryPropertyFlags prop_flags) const;
 
+	Image(Context& context);
+
 public:
 	Image(Context& context, std::string_view file_path);
+	Image(Context&             context,
+	      vk::Extent2D         extent,
+	      vk::Format           format,
+	      vk::ImageUsageFlags  usage,
+	      vk::ImageAspectFlags aspect = vk::ImageAspectFlagBits::eColor,
+	      uint32_t             mip_levels = 1);
 
 	Image(const Image&) = delete;
 	Image& operator=(const Image&) = delete;
@@ -35,17 +51,33 @@ public:
 
 	~Image();
 
+	// the caller provides the memory through bindMemory(), e.g. to alias it with other images
+	static std::unique_ptr<Image> createUnbound(Context&             context,
+	                                            vk::Extent2D         extent,
+	                                            vk::Format           format,
+	                                            vk::ImageUsageFlags  usage,
+	                                            vk::ImageAspectFlags aspect = vk::ImageAspectFlagBits::eColor);
+
 	void readImage(std::string_view file_path);
 	void freeImage();
 	void createBuffer(uint32_t image_size);
-	void createImage(uint32_t width, uint32_t height);
+	void createImage(uint32_t width, uint32_t height, vk::ImageUsageFlags usage = vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled);
 	void allocateMemory();
+	void bindMemory(vk::DeviceMemory memory, vk::DeviceSize offset);
 	void createImageView();
 	void copyBufferToImage(vk::CommandBuffer command, vk::Buffer buffer, vk::Image image, uint32_t width, uint32_t height);
 	void transitionImageLayout(vk::CommandBuffer command, vk::Image image, vk::Format format, vk::ImageLayout old_layout, vk::ImageLayout new_layout);
 
 	vk::Image     get() const;
 	vk::ImageView getView() const;
+	vk::Format    getFormat() const;
+	vk::Extent2D  getExtent() const;
+
+	// views of single mip levels, only created for images with more than one level
+	vk::ImageView getMipView(uint32_t level) const;
+	uint32_t      getMipLevels() const;
+
+	vk::MemoryRequirements getMemoryRequirements() const;
 
 	void     setSampler(Sampler& sampler);
 	Sampler& getSampler() const;
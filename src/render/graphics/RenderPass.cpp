@@ -6,9 +6,16 @@ RenderPass::RenderPass(Context& c, SwapChain& s, const RenderPassConfig& p) :
     config(p)
 {
 	config.attachments.front().setFormat(swap_chain->getSurfaceFormat().format);
+	if (config.depth_reference)
+		config.attachments.at(config.depth_reference->attachment).setFormat(swap_chain->getDepthFormat());
+
+	std::vector<vk::ImageView> depth_views;
+	if (config.depth_reference)
+		for (const auto& depth_image : swap_chain->getDepthImages())
+			depth_views.push_back(depth_image->getView());
 
 	create(config);
-	createFrameBuffers(swap_chain->getImageViews(), swap_chain->getExtent(), swap_chain->getImageCount());
+	createFrameBuffers(swap_chain->getImageViews(), depth_views, swap_chain->getExtent(), swap_chain->getImageCount());
 }
 
 RenderPass::~RenderPass()
@@ -20,21 +27,30 @@ RenderPass::~RenderPass()
 
 void RenderPass::create(const RenderPassConfig& config)
 {
+	auto subpasses = config.subpasses;
+	subpasses.front().setColorAttachments(config.color_references);
+	if (config.depth_reference)
+		subpasses.front().setPDepthStencilAttachment(&config.depth_reference.value());
+
 	vk::RenderPassCreateInfo render_pass_info{};
 	render_pass_info.setAttachments(config.attachments)
-	    .setSubpasses(config.subpasses)
+	    .setSubpasses(subpasses)
 	    .setDependencies(config.dependencies);
 
 	render_pass = context->getLogicalDevice().createRenderPass(render_pass_info);
 }
 
-void RenderPass::createFrameBuffers(std::span<const vk::ImageView> attachments, vk::Extent2D extent, uint32_t count)
+void RenderPass::createFrameBuffers(std::span<const vk::ImageView> color_views, std::span<const vk::ImageView> depth_views, vk::Extent2D extent, uint32_t count)
 {
 	framebuffers.resize(count);
 	for (size_t i = 0; i < count; i++) {
+		std::vector<vk::ImageView> attachments = {color_views[i]};
+		if (i < depth_views.size())
+			attachments.push_back(depth_views[i]);
+
 		vk::FramebufferCreateInfo create_info{};
 		create_info.setRenderPass(render_pass)
-		    .setAttachments(attachments[i])
+		    .setAttachments(attachments)
 		    .setWidth(extent.width)
 		    .setHeight(extent.height)
 		    .setLayers(1);
@@ -45,11 +61,14 @@ void RenderPass::createFrameBuffers(std::span<const vk::ImageView> attachments,
 
 void RenderPass::begin(vk::CommandBuffer command_buffer, uint32_t framebuffer_index, const vk::Extent2D& extent, const vk::ClearValue& color)
 {
+	std::array<vk::ClearValue, 2> clear_values = {color, vk::ClearDepthStencilValue{1.0f, 0}};
+
 	vk::RenderPassBeginInfo begin_info{};
 	begin_info.setRenderPass(render_pass)
 	    .setFramebuffer(framebuffers[framebuffer_index])
 	    .setRenderArea({{0, 0}, extent})
-	    .setClearValues(color);
+	    .setClearValueCount(config.depth_reference ? 2 : 1)
+	    .setPClearValues(clear_values.data());
 
 	command_buffer.beginRenderPass(begin_info, vk::SubpassContents::eInline);
 }
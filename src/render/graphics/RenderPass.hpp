@@ -1,5 +1,7 @@
 #pragma once
 
+#include <optional>
+
 #include <vulkan/vulkan.hpp>
 
 #include "Context.hpp"
@@ -16,25 +18,41 @@ struct RenderPassConfig {
 	        .setStencilStoreOp(vk::AttachmentStoreOp::eDontCare)
 	        .setInitialLayout(vk::ImageLayout::eUndefined)
 	        .setFinalLayout(vk::ImageLayout::ePresentSrcKHR),
+	    vk::AttachmentDescription()
+	        .setFormat(vk::Format::eD32Sfloat)
+	        .setSamples(vk::SampleCountFlagBits::e1)
+	        .setLoadOp(vk::AttachmentLoadOp::eClear)
+	        .setStoreOp(vk::AttachmentStoreOp::eDontCare)
+	        .setStencilLoadOp(vk::AttachmentLoadOp::eDontCare)
+	        .setStencilStoreOp(vk::AttachmentStoreOp::eDontCare)
+	        .setInitialLayout(vk::ImageLayout::eUndefined)
+	        .setFinalLayout(vk::ImageLayout::eDepthStencilAttachmentOptimal),
 	};
 
+	std::vector<vk::AttachmentReference> color_references = {
+	    vk::AttachmentReference()
+	        .setAttachment(0)
+	        .setLayout(vk::ImageLayout::eColorAttachmentOptimal),
+	};
+
+	std::optional<vk::AttachmentReference> depth_reference = vk::AttachmentReference()
+	                                                             .setAttachment(1)
+	                                                             .setLayout(vk::ImageLayout::eDepthStencilAttachmentOptimal);
+
+	// attachment references of the first subpass are filled from color_references and depth_reference
 	std::vector<vk::SubpassDescription> subpasses = {
 	    vk::SubpassDescription()
-	        .setPipelineBindPoint(vk::PipelineBindPoint::eGraphics)
-	        .setColorAttachments(
-	            vk::AttachmentReference()
-	                .setAttachment(0)
-	                .setLayout(vk::ImageLayout::eColorAttachmentOptimal)),
+	        .setPipelineBindPoint(vk::PipelineBindPoint::eGraphics),
 	};
 
 	std::vector<vk::SubpassDependency> dependencies = {
 	    vk::SubpassDependency()
 	        .setSrcSubpass(vk::SubpassExternal)
 	        .setDstSubpass(0)
-	        .setSrcStageMask(vk::PipelineStageFlagBits::eColorAttachmentOutput)
-	        .setSrcAccessMask(vk::AccessFlagBits::eNone)
-	        .setDstStageMask(vk::PipelineStageFlagBits::eColorAttachmentOutput)
-	        .setDstAccessMask(vk::AccessFlagBits::eColorAttachmentWrite),
+	        .setSrcStageMask(vk::PipelineStageFlagBits::eColorAttachmentOutput | vk::PipelineStageFlagBits::eLateFragmentTests)
+	        .setSrcAccessMask(vk::AccessFlagBits::eDepthStencilAttachmentWrite)
+	        .setDstStageMask(vk::PipelineStageFlagBits::eColorAttachmentOutput | vk::PipelineStageFlagBits::eEarlyFragmentTests)
+	        .setDstAccessMask(vk::AccessFlagBits::eColorAttachmentWrite | vk::AccessFlagBits::eDepthStencilAttachmentWrite),
 
 	};
 };
@@ -52,7 +70,7 @@ private:
 
 	void create(const RenderPassConfig& config);
 
-	void createFrameBuffers(std::span<const vk::ImageView> attachments, vk::Extent2D extent, uint32_t count);
+	void createFrameBuffers(std::span<const vk::ImageView> color_views, std::span<const vk::ImageView> depth_views, vk::Extent2D extent, uint32_t count);
 
 public:
 	RenderPass(Context& context, SwapChain& swap_chain, const RenderPassConfig& config = {});
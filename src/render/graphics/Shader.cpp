@@ -45,7 +45,7 @@ void Shader::setStage(vk::ShaderStageFlagBits stage, std::string_view entry)
 	stages[stage] = entry;
 }
 
-vk::PipelineShaderStageCreateInfo Shader::getStage(vk::ShaderStageFlagBits stage) const
+vk::PipelineShaderStageCreateInfo Shader::getStage(vk::ShaderStageFlagBits stage, const ShaderSpecialization* specialization) const
 {
 	auto it = stages.find(stage);
 	if (it == stages.end())
@@ -56,16 +56,19 @@ vk::PipelineShaderStageCreateInfo Shader::getStage(vk::ShaderStageFlagBits stage
 	    .setModule(shader)
 	    .setPName(it->second.c_str());
 
+	if (specialization && !specialization->empty())
+		stage_info.setPSpecializationInfo(specialization->get());
+
 	return stage_info;
 }
 
-std::vector<vk::PipelineShaderStageCreateInfo> Shader::getStages() const
+std::vector<vk::PipelineShaderStageCreateInfo> Shader::getStages(const ShaderSpecialization* specialization) const
 {
 	std::vector<vk::PipelineShaderStageCreateInfo> stage_infos;
 	stage_infos.reserve(stages.size());
 
 	for (const auto& [stage, entry] : stages)
-		stage_infos.push_back(getStage(stage));
+		stage_infos.push_back(getStage(stage, specialization));
 
 	return stage_infos;
 }
@@ -74,3 +77,70 @@ vk::ShaderModule Shader::get() const
 {
 	return shader;
 }
+
+ShaderSpecialization::ShaderSpecialization(const ShaderSpecialization& other) :
+    constants(other.constants)
+{
+	refresh();
+}
+
+ShaderSpecialization& ShaderSpecialization::operator=(const ShaderSpecialization& other)
+{
+	if (this != &other) {
+		constants = other.constants;
+		refresh();
+	}
+
+	return *this;
+}
+
+ShaderSpecialization::ShaderSpecialization(ShaderSpecialization&& other) noexcept :
+    constants(std::move(other.constants))
+{
+	refresh();
+	other.refresh();
+}
+
+ShaderSpecialization& ShaderSpecialization::operator=(ShaderSpecialization&& other) noexcept
+{
+	if (this != &other) {
+		constants = std::move(other.constants);
+		refresh();
+		other.refresh();
+	}
+
+	return *this;
+}
+
+// entries and data point into this object, so they are rebuilt whenever constants change
+void ShaderSpecialization::refresh()
+{
+	entries.clear();
+	data.clear();
+	entries.reserve(constants.size());
+	data.reserve(constants.size());
+
+	for (const auto& [id, value] : constants) {
+		entries.emplace_back(id, static_cast<uint32_t>(data.size() * sizeof(uint32_t)), sizeof(uint32_t));
+		data.push_back(value);
+	}
+
+	info.setMapEntries(entries)
+	    .setDataSize(data.size() * sizeof(uint32_t))
+	    .setPData(data.data());
+}
+
+bool ShaderSpecialization::empty() const
+{
+	return constants.empty();
+}
+
+const std::map<uint32_t, uint32_t>& ShaderSpecialization::getConstants() const
+{
+	return constants;
+}
+
+const vk::SpecializationInfo* ShaderSpecialization::get() const
+{
+	return &info;
+}
@@ -1,11 +1,46 @@
 #pragma once
 
+#include <map>
+#include <bit>
+#include <type_traits>
 #include <unordered_map>
 
 #include <vulkan/vulkan.hpp>
 
 #include "Context.hpp"
 
+class ShaderSpecialization {
+private:
+	std::map<uint32_t, uint32_t> constants;
+
+	std::vector<vk::SpecializationMapEntry> entries;
+	std::vector<uint32_t>                   data;
+	vk::SpecializationInfo                  info;
+
+	void refresh();
+
+public:
+	ShaderSpecialization() = default;
+
+	ShaderSpecialization(const ShaderSpecialization& other);
+	ShaderSpecialization& operator=(const ShaderSpecialization& other);
+
+	ShaderSpecialization(ShaderSpecialization&& other) noexcept;
+	ShaderSpecialization& operator=(ShaderSpecialization&& other) noexcept;
+
+	~ShaderSpecialization() = default;
+
+	template <typename I, typename T>
+	void set(I id, T value);
+	template <typename I>
+	void erase(I id);
+
+	bool empty() const;
+
+	auto getConstants() const -> const std::map<uint32_t, uint32_t>&;
+	auto get() const -> const vk::SpecializationInfo*;
+};
+
 class Shader {
 private:
 	vk::ShaderModule shader;
@@ -32,8 +67,29 @@ public:
 	void create();
 
 	void                                           setStage(vk::ShaderStageFlagBits stage, std::string_view entry);
-	vk::PipelineShaderStageCreateInfo              getStage(vk::ShaderStageFlagBits stage) const;
-	std::vector<vk::PipelineShaderStageCreateInfo> getStages() const;
+	vk::PipelineShaderStageCreateInfo              getStage(vk::ShaderStageFlagBits stage, const ShaderSpecialization* specialization = {}) const;
+	std::vector<vk::PipelineShaderStageCreateInfo> getStages(const ShaderSpecialization* specialization = {}) const;
 
 	vk::ShaderModule get() const;
 };
+
+template <typename I, typename T>
+void ShaderSpecialization::set(I id, T value)
+{
+	static_assert(sizeof(T) == sizeof(uint32_t) || std::is_same_v<T, bool>,
+	              "Specialization constants must be bool or 32-bit scalars");
+
+	if constexpr (std::is_same_v<T, bool>)
+		constants[static_cast<uint32_t>(id)] = value ? vk::True : vk::False;
+	else
+		constants[static_cast<uint32_t>(id)] = std::bit_cast<uint32_t>(value);
+
+	refresh();
+}
+
+template <typename I>
+void ShaderSpecialization::erase(I id)
+{
+	constants.erase(static_cast<uint32_t>(id));
+	refresh();
+}
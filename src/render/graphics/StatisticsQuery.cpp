@@ -0,0 +1,68 @@
+#include "StatisticsQuery.hpp"
+
+StatisticsQuery::StatisticsQuery(Context& context, uint32_t count) :
+    context(&context), count(count), recorded(count, false)
+{
+	if (!context.getFeatures().pipeline_statistics_query)
+		throw std::runtime_error("Pipeline statistics queries are not supported");
+
+	vk::QueryPoolCreateInfo create_info{};
+	create_info.setQueryType(vk::QueryType::ePipelineStatistics)
+	    .setQueryCount(count)
+	    .setPipelineStatistics(flags());
+
+	pool = context.getLogicalDevice().createQueryPool(create_info);
+}
+
+StatisticsQuery::~StatisticsQuery()
+{
+	context->getLogicalDevice().destroyQueryPool(pool);
+}
+
+// must be recorded outside of a render pass instance
+void StatisticsQuery::reset(vk::CommandBuffer command_buffer)
+{
+	command_buffer.resetQueryPool(pool, 0, count);
+	std::fill(recorded.begin(), recorded.end(), false);
+}
+
+void StatisticsQuery::begin(vk::CommandBuffer command_buffer, uint32_t index)
+{
+	command_buffer.beginQuery(pool, index, {});
+}
+
+void StatisticsQuery::end(vk::CommandBuffer command_buffer, uint32_t index)
+{
+	command_buffer.endQuery(pool, index);
+	recorded.at(index) = true;
+}
+
+// queries which were reset but never ended would block forever, so they are skipped
+std::optional<PipelineStatistics> StatisticsQuery::fetch(uint32_t index) const
+{
+	if (!recorded.at(index))
+		return std::nullopt;
+
+	std::array<uint64_t, 4> values{};
+	auto result = context->getLogicalDevice().getQueryPoolResults(
+	    pool, index, 1, sizeof(values), values.data(), sizeof(values),
+	    vk::QueryResultFlagBits::e64 | vk::QueryResultFlagBits::eWait);
+	if (result != vk::Result::eSuccess)
+		return std::nullopt;
+
+	// results are written in ascending order of the statistic flag bits
+	return PipelineStatistics{
+	    .input_assembly_vertices = values[0],
+	    .vertex_shader_invocations = values[1],
+	    .clipping_primitives = values[2],
+	    .fragment_shader_invocations = values[3],
+	};
+}
+
+vk::QueryPipelineStatisticFlags StatisticsQuery::flags()
+{
+	return vk::QueryPipelineStatisticFlagBits::eInputAssemblyVertices |
+	       vk::QueryPipelineStatisticFlagBits::eVertexShaderInvocations |
+	       vk::QueryPipelineStatisticFlagBits::eClippingPrimitives |
+	       vk::QueryPipelineStatisticFlagBits::eFragmentShaderInvocations;
+}
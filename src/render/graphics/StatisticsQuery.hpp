@@ -0,0 +1,41 @@
+#pragma once
+
+#include <vulkan/vulkan.hpp>
+
+#include "Context.hpp"
+
+struct PipelineStatistics {
+	uint64_t input_assembly_vertices{};
+	uint64_t vertex_shader_invocations{};
+	uint64_t clipping_primitives{};
+	uint64_t fragment_shader_invocations{};
+};
+
+class StatisticsQuery {
+private:
+	vk::QueryPool pool;
+	uint32_t      count{};
+
+	std::vector<bool> recorded;
+
+	Context* context{};
+
+public:
+	StatisticsQuery(Context& context, uint32_t count = 1);
+
+	StatisticsQuery(const StatisticsQuery&) = delete;
+	StatisticsQuery& operator=(const StatisticsQuery&) = delete;
+
+	StatisticsQuery(StatisticsQuery&&) noexcept = default;
+	StatisticsQuery& operator=(StatisticsQuery&&) noexcept = default;
+
+	~StatisticsQuery();
+
+	void reset(vk::CommandBuffer command_buffer);
+	void begin(vk::CommandBuffer command_buffer, uint32_t index = 0);
+	void end(vk::CommandBuffer command_buffer, uint32_t index = 0);
+
+	std::optional<PipelineStatistics> fetch(uint32_t index = 0) const;
+
+	static vk::QueryPipelineStatisticFlags flags();
+};
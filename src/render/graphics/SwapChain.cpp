@@ -1,15 +1,18 @@
 #include "SwapChain.hpp"
 
-SwapChain::SwapChain(Window& window, Context& context) :
+SwapChain::SwapChain(Window& window, Context& context, bool depth_images) :
+    with_depth_images(depth_images),
     window(&window),
     context(&context)
 {
 	create(window.getWidth(), window.getHeight());
 	createImageViews();
+	createDepthImages();
 }
 
 SwapChain::~SwapChain()
 {
+	destroyDepthImages();
 	destroyImageViews();
 	context->getLogicalDevice().destroySwapchainKHR(swap_chain);
 }
@@ -61,11 +64,13 @@ void SwapChain::create(uint32_t width, uint32_t height, bool old)
 void SwapChain::recreate(uint32_t width, uint32_t height)
 {
 	vk::SwapchainKHR old_swap_chain = swap_chain;
+	destroyDepthImages();
 	destroyImageViews();
 
 	create(width, height, true);
 	context->getLogicalDevice().destroySwapchainKHR(old_swap_chain);
 	createImageViews();
+	createDepthImages();
 }
 
 void SwapChain::createImageViews()
@@ -103,6 +108,25 @@ void SwapChain::destroyImageViews()
 	image_views.clear();
 }
 
+// one depth attachment per swap chain image, recreated with the swap chain extent
+void SwapChain::createDepthImages()
+{
+	depth_format = chooseDepthFormat();
+	if (!with_depth_images)
+		return;
+
+	depth_images.resize(images.size());
+	for (auto& depth_image : depth_images)
+		depth_image = std::make_unique<Image>(*context, extent, depth_format,
+		                                      vk::ImageUsageFlagBits::eDepthStencilAttachment,
+		                                      vk::ImageAspectFlagBits::eDepth);
+}
+
+void SwapChain::destroyDepthImages()
+{
+	depth_images.clear();
+}
+
 uint32_t SwapChain::acquireNextImage(vk::Semaphore semaphore, vk::Fence fence)
 {
 	auto [result, image_index] = context->getLogicalDevice().acquireNextImageKHR(swap_chain, std::numeric_limits<uint64_t>::max(), semaphore, fence);
@@ -157,6 +181,19 @@ vk::Extent2D SwapChain::chooseSwapExtent(const vk::SurfaceCapabilitiesKHR& capab
 		};
 }
 
+vk::Format SwapChain::chooseDepthFormat()
+{
+	std::array candidates = {vk::Format::eD32Sfloat, vk::Format::eX8D24UnormPack32, vk::Format::eD16Unorm};
+
+	for (auto candidate : candidates) {
+		auto properties = context->getPhysicalDevice().getFormatProperties(candidate);
+		if (properties.optimalTilingFeatures & vk::FormatFeatureFlagBits::eDepthStencilAttachment)
+			return candidate;
+	}
+
+	throw std::runtime_error("Failed to find a supported depth format");
+}
+
 vk::SwapchainKHR SwapChain::get() const
 {
 	return swap_chain;
@@ -191,3 +228,13 @@ const std::vector<vk::ImageView>& SwapChain::getImageViews() const
 {
 	return image_views;
 }
+
+vk::Format SwapChain::getDepthFormat() const
+{
+	return depth_format;
+}
+
+const std::vector<std::unique_ptr<Image>>& SwapChain::getDepthImages() const
+{
+	return depth_images;
+}
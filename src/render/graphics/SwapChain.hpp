@@ -3,6 +3,7 @@
 #include <vulkan/vulkan.hpp>
 
 #include "Context.hpp"
+#include "Image.hpp"
 
 struct SwapChainDetails {
 	vk::SurfaceCapabilitiesKHR        capabilities;
@@ -21,6 +22,10 @@ private:
 	std::vector<vk::Image>     images;
 	std::vector<vk::ImageView> image_views;
 
+	vk::Format                          depth_format;
+	std::vector<std::unique_ptr<Image>> depth_images;
+	bool                                with_depth_images{};
+
 	Window*  window{};
 	Context* context{};
 
@@ -30,13 +35,19 @@ private:
 	void createImageViews();
 	void destroyImageViews();
 
+	void createDepthImages();
+	void destroyDepthImages();
+
 	SwapChainDetails     querySwapChainDetails(uint32_t width, uint32_t height);
 	vk::SurfaceFormatKHR chooseSwapSurfaceFormat(std::span<const vk::SurfaceFormatKHR> surface_formats);
 	vk::PresentModeKHR   chooseSwapPresentMode(std::span<const vk::PresentModeKHR> present_modes);
 	vk::Extent2D         chooseSwapExtent(const vk::SurfaceCapabilitiesKHR& capabilities, uint32_t width, uint32_t height);
+	vk::Format           chooseDepthFormat();
 
 public:
-	SwapChain(Window& window, Context& context);
+	// renderers keeping depth elsewhere, such as in a render graph's transient pool, go without the
+	// per image depth attachments; the depth format is chosen either way
+	SwapChain(Window& window, Context& context, bool depth_images = true);
 
 	SwapChain(const SwapChain&) = delete;
 	SwapChain& operator=(const SwapChain&) = delete;
@@ -57,4 +68,7 @@ public:
 	uint32_t                          getImageCount() const;
 	const std::vector<vk::Image>&     getImages() const;
 	const std::vector<vk::ImageView>& getImageViews() const;
+
+	vk::Format                                 getDepthFormat() const;
+	const std::vector<std::unique_ptr<Image>>& getDepthImages() const;
 };
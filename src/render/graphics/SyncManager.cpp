@@ -24,6 +24,21 @@ vk::Semaphore SyncManager::allocateSemaphore()
 	return semaphore;
 }
 
+vk::Semaphore SyncManager::allocateTimelineSemaphore(uint64_t initial_value)
+{
+	vk::SemaphoreTypeCreateInfo type_info{};
+	type_info.setSemaphoreType(vk::SemaphoreType::eTimeline)
+	    .setInitialValue(initial_value);
+
+	vk::SemaphoreCreateInfo semaphore_info{};
+	semaphore_info.setPNext(&type_info);
+
+	vk::Semaphore semaphore = context->getLogicalDevice().createSemaphore(semaphore_info);
+	semaphore_pool.push_back(semaphore);
+
+	return semaphore;
+}
+
 vk::Fence SyncManager::allocateFence()
 {
 	vk::FenceCreateInfo fence_info{};
@@ -23,6 +23,7 @@ public:
 	~SyncManager();
 
 	vk::Semaphore allocateSemaphore();
+	vk::Semaphore allocateTimelineSemaphore(uint64_t initial_value = 0);
 	vk::Fence     allocateFence();
 
 	vk::Fence nextFence(vk::Fence fence);
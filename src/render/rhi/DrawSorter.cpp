@@ -0,0 +1,155 @@
+#include "DrawSorter.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+
+namespace
+{
+// the float's bits as an unsigned integer that orders like the float, negatives included
+uint32_t orderedBits(float value)
+{
+	auto bits = std::bit_cast<uint32_t>(value);
+	return bits & 0x80000000u ? ~bits : bits | 0x80000000u;
+}
+}        // namespace
+
+uint64_t DrawSorter::makeKey(DrawPass pass, uint32_t pipeline, uint32_t index_type, uint32_t material, float depth)
+{
+	uint64_t pass_field = static_cast<uint64_t>(pass) << 62;
+	uint64_t pipeline_field = std::min(pipeline, (1u << pipeline_bits) - 1);
+	uint64_t index_type_field = std::min(index_type, (1u << index_type_bits) - 1);
+	uint64_t material_field = std::min(material, (1u << material_bits) - 1);
+
+	// the depth's sign, exponent and leading mantissa bits
+	uint64_t depth_field = orderedBits(depth) >> (32 - depth_bits);
+
+	// pipeline, index type and material, in that order from the top of state_bits
+	constexpr uint32_t state_bits = pipeline_bits + index_type_bits + material_bits;
+	uint64_t           state = pipeline_field << (index_type_bits + material_bits) | index_type_field << material_bits | material_field;
+
+	if (pass == DrawPass::Blended)
+		return pass_field | (~depth_field & ((1ull << depth_bits) - 1)) << (62 - depth_bits) | state << (62 - depth_bits - state_bits);
+
+	return pass_field | state << (62 - state_bits) | depth_field << (62 - state_bits - depth_bits);
+}
+
+void DrawSorter::clear()
+{
+	keys.clear();
+	values.clear();
+}
+
+void DrawSorter::reserve(size_t count)
+{
+	keys.reserve(count);
+	values.reserve(count);
+}
+
+void DrawSorter::add(uint64_t key, uint32_t value)
+{
+	keys.push_back(key);
+	values.push_back(value);
+}
+
+void DrawSorter::sort()
+{
+	auto count = static_cast<uint32_t>(keys.size());
+	if (count < 2)
+		return;
+
+	// digits every key shares need no pass, the bits that differ anywhere give them away
+	uint64_t any_set = 0;
+	uint64_t all_set = ~0ull;
+	for (auto key : keys) {
+		any_set |= key;
+		all_set &= key;
+	}
+	auto varying = any_set ^ all_set;
+	if (varying == 0)
+		return;
+
+	std::array<uint32_t, digit_count> shifts{};
+	uint32_t                          digit_total = 0;
+	for (auto shift = static_cast<uint32_t>(std::countr_zero(varying)); shift < 64; shift += radix_bits)
+		if ((varying >> shift) & (radix_size - 1))
+			shifts[digit_total++] = shift;
+
+	// one digit at a time keeps its shift in a register
+	histograms.resize(digit_count);
+	for (uint32_t d = 0; d < digit_total; d++) {
+		auto& histogram = histograms[d];
+		auto  shift = shifts[d];
+
+		histogram.fill(0);
+		for (auto key : keys)
+			histogram[(key >> shift) & (radix_size - 1)]++;
+	}
+
+	// the position a draw was added at sits below as many digits as fit beside it; once those are
+	// sorted, the next ones are read back from its key
+	auto position_bits = static_cast<uint32_t>(std::bit_width(count - 1));
+	auto position_mask = (1ull << position_bits) - 1;
+
+	packed.resize(count);
+	scratch.resize(count);
+
+	for (uint32_t first = 0, last = 0; first < digit_total; first = last) {
+		auto low = shifts[first];
+		auto high = [&](uint32_t d) { return std::min(shifts[d] + radix_bits, 64u); };
+
+		last = first + 1;
+		while (last < digit_total && high(last) - low <= 64 - position_bits)
+			last++;
+
+		auto digit_mask = (1ull << (high(last - 1) - low)) - 1;
+		auto pack = [&](uint32_t i) { return ((keys[i] >> low) & digit_mask) << position_bits | i; };
+
+		for (uint32_t d = first; d < last; d++) {
+			auto& histogram = histograms[d];
+			auto  shift = shifts[d] - low + position_bits;
+
+			uint32_t offset = 0;
+			for (auto& bucket : histogram) {
+				auto size = bucket;
+				bucket = offset;
+				offset += size;
+			}
+
+			auto place = [&](uint64_t entry) { scratch[histogram[(entry >> shift) & (radix_size - 1)]++] = entry; };
+
+			// the first pass of each group packs its digits on the way
+			if (d > first)
+				for (auto entry : packed)
+					place(entry);
+			else if (first == 0)
+				for (uint32_t i = 0; i < count; i++)
+					place(pack(i));
+			else
+				for (auto entry : packed)
+					place(pack(static_cast<uint32_t>(entry & position_mask)));
+
+			packed.swap(scratch);
+		}
+	}
+
+	scratch_values.resize(count);
+	for (uint32_t i = 0; i < count; i++) {
+		auto position = packed[i] & position_mask;
+		scratch[i] = keys[position];
+		scratch_values[i] = values[position];
+	}
+
+	keys.swap(scratch);
+	values.swap(scratch_values);
+}
+
+std::span<const uint64_t> DrawSorter::getKeys() const
+{
+	return keys;
+}
+
+std::span<const uint32_t> DrawSorter::getValues() const
+{
+	return values;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// in drawing order, masked geometry after the opaque so early-z has the most to reject
+enum class DrawPass : uint8_t {
+	Opaque,
+	Masked,
+	Blended,
+};
+
+// orders draws by packed 64-bit keys with an LSD radix sort, stable so equal keys keep the order
+// they were added in
+class DrawSorter {
+private:
+	// 11-bit digits cover makeKey's 50 bits in five passes with 8 KiB histograms
+	static constexpr uint32_t radix_bits = 11;
+	static constexpr uint32_t radix_size = 1u << radix_bits;
+	static constexpr uint32_t digit_count = (64 + radix_bits - 1) / radix_bits;
+
+	std::vector<uint64_t> keys;
+	std::vector<uint32_t> values;
+
+	// the passes move one word per draw, some of the key's digits above the position it was added at
+	std::vector<uint64_t> packed;
+	std::vector<uint64_t> scratch;
+	std::vector<uint32_t> scratch_values;
+
+	// kept between sorts like the rest, so sorting allocates nothing once warmed up
+	std::vector<std::array<uint32_t, radix_size>> histograms;
+
+public:
+	static constexpr uint32_t pipeline_bits = 10;
+	static constexpr uint32_t index_type_bits = 2;
+	static constexpr uint32_t material_bits = 20;
+	static constexpr uint32_t depth_bits = 16;
+
+	// the fields fill the key from the top, the bits below stay clear
+	static constexpr uint32_t key_bits = 2 + pipeline_bits + index_type_bits + material_bits + depth_bits;
+
+	DrawSorter() = default;
+
+	DrawSorter(const DrawSorter&) = delete;
+	DrawSorter& operator=(const DrawSorter&) = delete;
+
+	DrawSorter(DrawSorter&&) noexcept = default;
+	DrawSorter& operator=(DrawSorter&&) noexcept = default;
+
+	~DrawSorter() = default;
+
+	// pass, then pipeline, index type, material and depth front to back; blended draws put depth,
+	// back to front, right below the pass since their order matters more than the state they change.
+	// ids past their field's width are clamped
+	static auto makeKey(DrawPass pass, uint32_t pipeline, uint32_t index_type, uint32_t material, float depth) -> uint64_t;
+
+	void clear();
+	void reserve(size_t count);
+	void add(uint64_t key, uint32_t value);
+
+	// the digits start at the lowest bit any two keys differ in and skip those every key shares, so
+	// makeKey's clear low bits and constant high fields cost nothing
+	void sort();
+
+	auto getKeys() const -> std::span<const uint64_t>;
+	auto getValues() const -> std::span<const uint32_t>;
+};
@@ -1,5 +1,14 @@
 #include "GpuVertex.hpp"
 
+vk::VertexInputBindingDescription GpuVertex::positionBinding(uint32_t binding)
+{
+	return {
+	    binding,
+	    sizeof(GpuPosition),
+	    vk::VertexInputRate::eVertex,
+	};
+}
+
 vk::VertexInputBindingDescription GpuVertex::binding(uint32_t binding)
 {
 	return {
@@ -9,12 +18,21 @@ vk::VertexInputBindingDescription GpuVertex::binding(uint32_t binding)
 	};
 }
 
-std::vector<vk::VertexInputAttributeDescription> GpuVertex::attributes(uint32_t binding)
+std::vector<vk::VertexInputAttributeDescription> GpuVertex::attributes(uint32_t position_binding, uint32_t binding)
 {
 	return {
-	    {0, binding, vk::Format::eR32G32B32Sfloat, offsetof(GpuVertex, pos)},
-	    {1, binding, vk::Format::eR32G32B32Sfloat, offsetof(GpuVertex, normal)},
-	    {2, binding, vk::Format::eR32G32Sfloat, offsetof(GpuVertex, uv)},
-	    {3, binding, vk::Format::eR32G32B32A32Sfloat, offsetof(GpuVertex, color)},
+	    {0, position_binding, vk::Format::eR16G16B16A16Unorm, offsetof(GpuPosition, pos)},
+	    {1, binding, vk::Format::eR16G16Snorm, offsetof(GpuVertex, normal)},
+	    {2, binding, vk::Format::eR16G16Sfloat, offsetof(GpuVertex, uv)},
+	};
+}
+
+vk::DescriptorSetLayoutBinding GpuVertex::storageBinding(uint32_t binding)
+{
+	return {
+	    binding,
+	    vk::DescriptorType::eStorageBuffer,
+	    1,
+	    vk::ShaderStageFlagBits::eVertex,
 	};
 }
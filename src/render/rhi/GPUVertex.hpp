@@ -1,15 +1,40 @@
 #pragma once
 
 #include <glm/glm.hpp>
+#include <glm/gtc/type_precision.hpp>
 
 #include <vulkan/vulkan.hpp>
 
-struct GpuVertex {
+// a vertex as read from a mesh, what static batches are transformed in before compression
+struct MeshVertex {
 	glm::vec3 pos;
 	glm::vec3 normal;
 	glm::vec2 uv;
 	glm::vec4 color;
+};
+
+// the position stream: unorm16 coordinates within the mesh's position box, which each instance's
+// GpuObject carries; the fourth lane pads to eight bytes
+struct GpuPosition {
+	glm::u16vec4 pos;
+};
+
+// the attribute stream next to it, eight bytes: an octahedral snorm16 normal and half float UVs
+struct GpuVertex {
+	uint32_t normal;
+	uint32_t uv;
+
+	// the position stream comes first and is all the depth passes bind
+	static vk::VertexInputBindingDescription                positionBinding(uint32_t binding = {});
+	static vk::VertexInputBindingDescription                binding(uint32_t binding = 1);
+	static std::vector<vk::VertexInputAttributeDescription> attributes(uint32_t position_binding = {}, uint32_t binding = 1);
+
+	// the vertex buffer as a storage buffer, for shaders that fetch their vertices themselves
+	static vk::DescriptorSetLayoutBinding storageBinding(uint32_t binding = {});
+};
 
-	static vk::VertexInputBindingDescription                binding(uint32_t binding = {});
-	static std::vector<vk::VertexInputAttributeDescription> attributes(uint32_t binding = {});
+// the color stream, unorm8 and only for meshes whose source has colors; shaders always fetch it
+// themselves, at the vertex's index plus its object's color_offset, see GpuObject
+struct GpuColor {
+	uint32_t color;
 };
@@ -0,0 +1,220 @@
+#include "GpuCulling.hpp"
+
+#include <cmath>
+#include <vector>
+
+#include "render/graphics/DescriptorManager.hpp"
+
+namespace
+{
+constexpr uint32_t group_size = 64;
+}        // namespace
+
+GpuCulling::GpuCulling(Context& c) :
+    context(&c)
+{
+	// compaction needs the draw count to come from the GPU
+	compact = context->getFeatures().draw_indirect_count;
+
+	ComputePipelineConfig config{};
+	config.entry = "earlyMain";
+	for (uint32_t binding = 0; binding < 11; binding++)
+		if (binding != 7)
+			config.descriptor_bindings.push_back(DescriptorManager::binding(binding, vk::DescriptorType::eStorageBuffer));
+	config.push_constants = {{vk::ShaderStageFlagBits::eCompute, 0, sizeof(GpuCullConstants)}};
+	config.specialization.set(GpuCullSpecialization::Compact, compact);
+
+	getPhase(CullPhase::Early).pipeline = std::make_unique<ComputePipeline>(*context, SHADER_DIR "/cull.spv", config);
+
+	// only the late phase samples the depth pyramid
+	config.entry = "lateMain";
+	config.descriptor_bindings.push_back(DescriptorManager::binding(7, vk::DescriptorType::eSampledImage));
+
+	getPhase(CullPhase::Late).pipeline = std::make_unique<ComputePipeline>(*context, SHADER_DIR "/cull.spv", config);
+
+	std::array<vk::DescriptorPoolSize, 2> pool_sizes{};
+	pool_sizes[0].setType(vk::DescriptorType::eStorageBuffer).setDescriptorCount(20);
+	pool_sizes[1].setType(vk::DescriptorType::eSampledImage).setDescriptorCount(1);
+
+	pool = context->getDescriptorManager().createPool(pool_sizes, 2);
+}
+
+// called whenever the scene's draw list changes, the GPU must be idle
+void GpuCulling::build(const Buffer& source_commands, const Buffer& objects, std::span<const GpuCullInput> inputs, uint32_t buckets,
+                       std::span<const GpuLodDraw> lod_draws, std::span<const GpuLod> lods)
+{
+	auto& descriptor_manager = context->getDescriptorManager();
+
+	draw_count = static_cast<uint32_t>(inputs.size());
+	bucket_count = buckets;
+
+	// every draw counts as visible until the late phase has tested it, and starts at full detail
+	std::vector<uint32_t> visibility(draw_count, 1);
+	std::vector<uint32_t> lod_history(lod_draws.size() * 2, 0);
+
+	input_buffer = Buffer::createFrom(*context, vk::BufferUsageFlagBits::eStorageBuffer, inputs.data(), inputs.size_bytes());
+	visibility_buffer = Buffer::createFrom(*context, vk::BufferUsageFlagBits::eStorageBuffer, visibility.data(), visibility.size() * sizeof(uint32_t));
+	lod_draw_buffer = Buffer::createFrom(*context, vk::BufferUsageFlagBits::eStorageBuffer, lod_draws.data(), lod_draws.size_bytes());
+	lod_buffer = Buffer::createFrom(*context, vk::BufferUsageFlagBits::eStorageBuffer, lods.data(), lods.size_bytes());
+	lod_history_buffer = Buffer::createFrom(*context, vk::BufferUsageFlagBits::eStorageBuffer, lod_history.data(), lod_history.size() * sizeof(uint32_t));
+	statistics_buffer = std::make_unique<Buffer>(*context,
+	                                             sizeof(GpuCullStatistics),
+	                                             vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferDst,
+	                                             vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+
+	descriptor_manager.resetPool(pool);
+
+	for (auto& phase : phases) {
+		phase.command_buffer = std::make_unique<Buffer>(*context,
+		                                                draw_count * sizeof(vk::DrawIndexedIndirectCommand),
+		                                                vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer,
+		                                                vk::MemoryPropertyFlagBits::eDeviceLocal);
+		phase.count_buffer = std::make_unique<Buffer>(*context,
+		                                              bucket_count * sizeof(uint32_t),
+		                                              vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer | vk::BufferUsageFlagBits::eTransferDst,
+		                                              vk::MemoryPropertyFlagBits::eDeviceLocal);
+
+		phase.set = descriptor_manager.allocateSet(pool, phase.pipeline->getDescriptorBindings());
+
+		descriptor_manager.updateSet(phase.set, 0, vk::DescriptorType::eStorageBuffer, &source_commands);
+		descriptor_manager.updateSet(phase.set, 1, vk::DescriptorType::eStorageBuffer, &objects);
+		descriptor_manager.updateSet(phase.set, 2, vk::DescriptorType::eStorageBuffer, input_buffer.get());
+		descriptor_manager.updateSet(phase.set, 3, vk::DescriptorType::eStorageBuffer, phase.command_buffer.get());
+		descriptor_manager.updateSet(phase.set, 4, vk::DescriptorType::eStorageBuffer, phase.count_buffer.get());
+		descriptor_manager.updateSet(phase.set, 5, vk::DescriptorType::eStorageBuffer, visibility_buffer.get());
+		descriptor_manager.updateSet(phase.set, 6, vk::DescriptorType::eStorageBuffer, statistics_buffer.get());
+		descriptor_manager.updateSet(phase.set, 8, vk::DescriptorType::eStorageBuffer, lod_draw_buffer.get());
+		descriptor_manager.updateSet(phase.set, 9, vk::DescriptorType::eStorageBuffer, lod_buffer.get());
+		descriptor_manager.updateSet(phase.set, 10, vk::DescriptorType::eStorageBuffer, lod_history_buffer.get());
+	}
+
+	setDepthPyramid(pyramid);
+}
+
+// the pyramid must stay alive while it is set, resizing it needs another call
+void GpuCulling::setDepthPyramid(const GpuDepthPyramid* depth_pyramid)
+{
+	pyramid = depth_pyramid;
+
+	if (pyramid && draw_count > 0)
+		context->getDescriptorManager().updateSet(getPhase(CullPhase::Late).set,
+		                                          7,
+		                                          vk::DescriptorType::eSampledImage,
+		                                          pyramid->getImage().getView(),
+		                                          GpuDepthPyramid::layout);
+}
+
+bool GpuCulling::isOccluding() const
+{
+	return pyramid != nullptr;
+}
+
+void GpuCulling::setLodSelection(float scale, float threshold, float hysteresis)
+{
+	lod_scale = scale;
+	lod_threshold = threshold;
+	lod_hysteresis = hysteresis;
+}
+
+void GpuCulling::cull(vk::CommandBuffer command, const glm::mat4& view_projection, CullPhase phase)
+{
+	if (draw_count == 0 || (phase == CullPhase::Late && !isOccluding()))
+		return;
+
+	auto& current = getPhase(phase);
+
+	// the previous frame's draws and late phase must be done with the buffers before they are overwritten
+	vk::MemoryBarrier reuse_barrier{};
+	reuse_barrier.setSrcAccessMask(vk::AccessFlagBits::eShaderWrite)
+	    .setDstAccessMask(vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite | vk::AccessFlagBits::eTransferWrite);
+	command.pipelineBarrier(vk::PipelineStageFlagBits::eDrawIndirect | vk::PipelineStageFlagBits::eComputeShader,
+	                        vk::PipelineStageFlagBits::eTransfer | vk::PipelineStageFlagBits::eComputeShader,
+	                        {}, reuse_barrier, nullptr, nullptr);
+
+	if (compact)
+		command.fillBuffer(current.count_buffer->get(), 0, vk::WholeSize, 0);
+	if (phase == CullPhase::Early)
+		command.fillBuffer(statistics_buffer->get(), 0, vk::WholeSize, 0);
+
+	vk::MemoryBarrier clear_barrier{};
+	clear_barrier.setSrcAccessMask(vk::AccessFlagBits::eTransferWrite)
+	    .setDstAccessMask(vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite);
+	command.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eComputeShader, {}, clear_barrier, nullptr, nullptr);
+
+	// the early phase selects the levels into one half of the history, reading the other, and the
+	// late phase reads back what it selected
+	if (phase == CullPhase::Early)
+		lod_frame++;
+
+	GpuCullConstants constants{};
+	constants.view_projection = view_projection;
+	constants.camera_position = getCameraPosition(view_projection);
+	constants.draw_count = draw_count;
+	constants.occlusion = isOccluding();
+	if (pyramid) {
+		auto extent = pyramid->getExtent();
+		constants.pyramid_size = {extent.width, extent.height};
+		constants.mip_count = pyramid->getMipCount();
+	}
+	constants.lod_scale = lod_scale;
+	constants.lod_threshold = lod_threshold;
+	constants.lod_hysteresis = lod_hysteresis;
+	constants.lod_parity = lod_frame & 1;
+
+	current.pipeline->bind(command, {&current.set, 1});
+	current.pipeline->pushConstants(command, constants);
+	current.pipeline->dispatch(command, ComputePipeline::groupCount(draw_count, group_size));
+}
+
+// the camera is where w is 0 for x and y too; orthographic projections have no such point
+glm::vec4 GpuCulling::getCameraPosition(const glm::mat4& view_projection)
+{
+	auto camera = glm::inverse(view_projection) * glm::vec4(0.0f, 0.0f, 1.0f, 0.0f);
+	if (std::abs(camera.w) <= 1e-6f)
+		return glm::vec4(0.0f);
+
+	return glm::vec4(glm::vec3(camera) / camera.w, 1.0f);
+}
+
+void GpuCulling::barrier(vk::CommandBuffer command) const
+{
+	vk::MemoryBarrier memory_barrier{};
+	memory_barrier.setSrcAccessMask(vk::AccessFlagBits::eShaderWrite)
+	    .setDstAccessMask(vk::AccessFlagBits::eIndirectCommandRead);
+
+	command.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eDrawIndirect, {}, memory_barrier, nullptr, nullptr);
+}
+
+const Buffer& GpuCulling::getCommandBuffer(CullPhase phase) const
+{
+	return *getPhase(phase).command_buffer;
+}
+
+const Buffer& GpuCulling::getCountBuffer(CullPhase phase) const
+{
+	return *getPhase(phase).count_buffer;
+}
+
+bool GpuCulling::isCompacting() const
+{
+	return compact;
+}
+
+GpuCullStatistics GpuCulling::getStatistics() const
+{
+	GpuCullStatistics statistics{};
+	if (statistics_buffer)
+		statistics_buffer->download(&statistics, sizeof(statistics));
+
+	return statistics;
+}
+
+GpuCulling::Phase& GpuCulling::getPhase(CullPhase phase)
+{
+	return phases[static_cast<size_t>(phase)];
+}
+
+const GpuCulling::Phase& GpuCulling::getPhase(CullPhase phase) const
+{
+	return phases[static_cast<size_t>(phase)];
+}
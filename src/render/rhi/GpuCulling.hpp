@@ -0,0 +1,95 @@
+#pragma once
+
+#include <array>
+#include <memory>
+
+#include <vulkan/vulkan.hpp>
+#include <glm/glm.hpp>
+
+#include "GpuUniforms.hpp"
+#include "GpuDepthPyramid.hpp"
+#include "render/graphics/Context.hpp"
+#include "render/graphics/Buffer.hpp"
+#include "render/graphics/ComputePipeline.hpp"
+
+// two-phase occlusion culling: the early phase draws what was visible last frame, the late phase
+// tests the rest against a depth pyramid built in between
+enum class CullPhase : uint8_t {
+	Early,
+	Late,
+};
+
+// culls a scene's draws on the GPU and writes the indirect commands the scene draws with
+class GpuCulling {
+private:
+	struct Phase {
+		std::unique_ptr<ComputePipeline> pipeline;
+		std::unique_ptr<Buffer>          command_buffer;
+		std::unique_ptr<Buffer>          count_buffer;
+		vk::DescriptorSet                set;
+	};
+
+	std::array<Phase, 2> phases;
+
+	std::unique_ptr<Buffer> input_buffer;
+	std::unique_ptr<Buffer> visibility_buffer;
+	std::unique_ptr<Buffer> statistics_buffer;
+	std::unique_ptr<Buffer> lod_draw_buffer;
+	std::unique_ptr<Buffer> lod_buffer;
+	std::unique_ptr<Buffer> lod_history_buffer;
+
+	vk::DescriptorPool pool;
+
+	const GpuDepthPyramid* pyramid{};
+
+	uint32_t draw_count{};
+	uint32_t bucket_count{};
+	bool     compact{};
+
+	float    lod_scale{};
+	float    lod_threshold{};
+	float    lod_hysteresis{};
+	uint32_t lod_frame{};
+
+	Context* context{};
+
+	auto getPhase(CullPhase phase) -> Phase&;
+	auto getPhase(CullPhase phase) const -> const Phase&;
+
+public:
+	GpuCulling(Context& context);
+
+	GpuCulling(const GpuCulling&) = delete;
+	GpuCulling& operator=(const GpuCulling&) = delete;
+
+	GpuCulling(GpuCulling&&) noexcept = default;
+	GpuCulling& operator=(GpuCulling&&) noexcept = default;
+
+	~GpuCulling() = default;
+
+	// every input's lod_draw indexes lod_draws, whose levels index lods
+	void build(const Buffer& source_commands, const Buffer& objects, std::span<const GpuCullInput> inputs, uint32_t bucket_count,
+	           std::span<const GpuLodDraw> lod_draws, std::span<const GpuLod> lods);
+
+	// occlusion culling runs once a pyramid is set, null goes back to frustum culling only
+	void setDepthPyramid(const GpuDepthPyramid* pyramid);
+	bool isOccluding() const;
+
+	// see GpuCullConstants, the selection takes effect from the next early phase
+	void setLodSelection(float scale, float threshold, float hysteresis);
+
+	void cull(vk::CommandBuffer command, const glm::mat4& view_projection, CullPhase phase = CullPhase::Early);
+
+	// the point every clip space ray starts from, w 0 for projections without one
+	static auto getCameraPosition(const glm::mat4& view_projection) -> glm::vec4;
+
+	// makes the results visible to indirect draws for callers outside the render graph
+	void barrier(vk::CommandBuffer command) const;
+
+	auto getCommandBuffer(CullPhase phase = CullPhase::Early) const -> const Buffer&;
+	auto getCountBuffer(CullPhase phase = CullPhase::Early) const -> const Buffer&;
+	bool isCompacting() const;
+
+	// counters of the last culled frame, only valid once that frame has finished on the GPU
+	auto getStatistics() const -> GpuCullStatistics;
+};
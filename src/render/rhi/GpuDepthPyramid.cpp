@@ -0,0 +1,129 @@
+#include "GpuDepthPyramid.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+
+#include "render/graphics/DescriptorManager.hpp"
+
+namespace
+{
+constexpr uint32_t group_size = 8;
+constexpr uint32_t max_mips = 16;
+}        // namespace
+
+GpuDepthPyramid::GpuDepthPyramid(Context& c, vk::Extent2D depth) :
+    depth_extent(depth), context(&c)
+{
+	ComputePipelineConfig config{};
+	config.descriptor_bindings = {
+	    DescriptorManager::binding(0, vk::DescriptorType::eSampledImage),
+	    DescriptorManager::binding(1, vk::DescriptorType::eStorageImage),
+	};
+	config.push_constants = {{vk::ShaderStageFlagBits::eCompute, 0, sizeof(GpuPyramidConstants)}};
+
+	pipeline = std::make_unique<ComputePipeline>(*context, SHADER_DIR "/hiz.spv", config);
+
+	std::array<vk::DescriptorPoolSize, 2> pool_sizes{};
+	pool_sizes[0].setType(vk::DescriptorType::eSampledImage).setDescriptorCount(max_mips);
+	pool_sizes[1].setType(vk::DescriptorType::eStorageImage).setDescriptorCount(max_mips);
+
+	pool = context->getDescriptorManager().createPool(pool_sizes, max_mips);
+
+	create();
+}
+
+void GpuDepthPyramid::create()
+{
+	auto& descriptor_manager = context->getDescriptorManager();
+
+	vk::Extent2D extent{std::max(depth_extent.width / 2, 1u), std::max(depth_extent.height / 2, 1u)};
+	auto         mip_count = std::min<uint32_t>(std::bit_width(std::max(extent.width, extent.height)), max_mips);
+
+	image = std::make_unique<Image>(*context,
+	                                extent,
+	                                vk::Format::eR32Sfloat,
+	                                vk::ImageUsageFlagBits::eStorage | vk::ImageUsageFlagBits::eSampled,
+	                                vk::ImageAspectFlagBits::eColor,
+	                                mip_count);
+
+	// the render graph imports the pyramid in this layout every frame
+	context->execute([&](vk::CommandBuffer command) {
+		vk::ImageMemoryBarrier barrier{};
+		barrier.setOldLayout(vk::ImageLayout::eUndefined)
+		    .setNewLayout(layout)
+		    .setDstAccessMask(vk::AccessFlagBits::eShaderRead)
+		    .setSrcQueueFamilyIndex(vk::QueueFamilyIgnored)
+		    .setDstQueueFamilyIndex(vk::QueueFamilyIgnored)
+		    .setImage(image->get())
+		    .setSubresourceRange({vk::ImageAspectFlagBits::eColor, 0, vk::RemainingMipLevels, 0, 1});
+
+		command.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe, vk::PipelineStageFlagBits::eComputeShader, {}, nullptr, nullptr, barrier);
+	});
+
+	descriptor_manager.resetPool(pool);
+	sets.clear();
+	source_view = nullptr;
+
+	// each level reads the one above it, level 0 reads the depth buffer once build() provides it
+	for (uint32_t level = 0; level < mip_count; level++) {
+		auto set = descriptor_manager.allocateSet(pool, pipeline->getDescriptorBindings());
+		if (level > 0)
+			descriptor_manager.updateSet(set, 0, vk::DescriptorType::eSampledImage, image->getMipView(level - 1), vk::ImageLayout::eGeneral);
+		descriptor_manager.updateSet(set, 1, vk::DescriptorType::eStorageImage, image->getMipView(level), vk::ImageLayout::eGeneral);
+		sets.push_back(set);
+	}
+}
+
+void GpuDepthPyramid::resize(vk::Extent2D depth)
+{
+	if (depth == depth_extent)
+		return;
+
+	depth_extent = depth;
+	create();
+}
+
+void GpuDepthPyramid::build(vk::CommandBuffer command, vk::ImageView depth_view)
+{
+	// transient depth buffers keep their view until the pool reallocates them
+	if (depth_view != source_view) {
+		context->getDescriptorManager().updateSet(sets.front(), 0, vk::DescriptorType::eSampledImage, depth_view, vk::ImageLayout::eShaderReadOnlyOptimal);
+		source_view = depth_view;
+	}
+
+	vk::MemoryBarrier level_barrier{};
+	level_barrier.setSrcAccessMask(vk::AccessFlagBits::eShaderWrite)
+	    .setDstAccessMask(vk::AccessFlagBits::eShaderRead);
+
+	for (uint32_t level = 0; level < getMipCount(); level++) {
+		GpuPyramidConstants constants{};
+		auto                source = level == 0 ? depth_extent : getExtent(level - 1);
+		auto                target = getExtent(level);
+		constants.source_size = {source.width, source.height};
+		constants.target_size = {target.width, target.height};
+
+		if (level > 0)
+			command.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eComputeShader, {}, level_barrier, nullptr, nullptr);
+
+		pipeline->bind(command, {&sets[level], 1});
+		pipeline->pushConstants(command, constants);
+		pipeline->dispatch(command, ComputePipeline::groupCount(target.width, group_size), ComputePipeline::groupCount(target.height, group_size));
+	}
+}
+
+const Image& GpuDepthPyramid::getImage() const
+{
+	return *image;
+}
+
+vk::Extent2D GpuDepthPyramid::getExtent(uint32_t level) const
+{
+	auto extent = image->getExtent();
+	return {std::max(extent.width >> level, 1u), std::max(extent.height >> level, 1u)};
+}
+
+uint32_t GpuDepthPyramid::getMipCount() const
+{
+	return image->getMipLevels();
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <vulkan/vulkan.hpp>
+
+#include "GpuUniforms.hpp"
+#include "render/graphics/Context.hpp"
+#include "render/graphics/Image.hpp"
+#include "render/graphics/ComputePipeline.hpp"
+
+// a mip chain holding the farthest depth under each texel, sampled by occlusion culling;
+// level 0 is half the depth buffer's size and each level halves the one above
+class GpuDepthPyramid {
+private:
+	std::unique_ptr<Image>           image;
+	std::unique_ptr<ComputePipeline> pipeline;
+
+	vk::DescriptorPool             pool;
+	std::vector<vk::DescriptorSet> sets;
+	vk::ImageView                  source_view;
+
+	vk::Extent2D depth_extent;
+
+	Context* context{};
+
+	void create();
+
+public:
+	GpuDepthPyramid(Context& context, vk::Extent2D depth_extent);
+
+	GpuDepthPyramid(const GpuDepthPyramid&) = delete;
+	GpuDepthPyramid& operator=(const GpuDepthPyramid&) = delete;
+
+	GpuDepthPyramid(GpuDepthPyramid&&) noexcept = default;
+	GpuDepthPyramid& operator=(GpuDepthPyramid&&) noexcept = default;
+
+	~GpuDepthPyramid() = default;
+
+	// recreates the pyramid when the depth buffer changes size, the GPU must be idle
+	void resize(vk::Extent2D depth_extent);
+
+	// expects the depth in the shader read-only layout and the pyramid in the general layout
+	void build(vk::CommandBuffer command, vk::ImageView depth_view);
+
+	auto getImage() const -> const Image&;
+	auto getExtent(uint32_t level = 0) const -> vk::Extent2D;
+	auto getMipCount() const -> uint32_t;
+
+	// the layout the pyramid is left in between frames
+	static constexpr vk::ImageLayout layout = vk::ImageLayout::eShaderReadOnlyOptimal;
+};
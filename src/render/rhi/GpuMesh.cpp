@@ -1,21 +1,52 @@
 #include "GpuMesh.hpp"
 
+#include <cstring>
 #include <numeric>
 
-#include "render/graphics/Context.hpp"
-#include "render/graphics/Buffer.hpp"
 #include "scene/components/SubMesh.hpp"
 #include "GpuVertex.hpp"
 
-GpuMesh::GpuMesh(Context& context, const SubMesh& submesh) :
-    context(&context), submesh(&submesh)
+namespace
+{
+// copied as they are when the widths match
+template <typename T>
+uint32_t appendIndices(const SubMesh& submesh, std::vector<T>& scene_indices)
+{
+	auto first = static_cast<uint32_t>(scene_indices.size());
+
+	auto data = submesh.getIndexData();
+	if (data.size() == submesh.getIndicesCount() * sizeof(T)) {
+		scene_indices.resize(first + submesh.getIndicesCount());
+		std::memcpy(scene_indices.data() + first, data.data(), data.size());
+	} else {
+		auto indices = submesh.getIndices();
+		scene_indices.insert(scene_indices.end(), indices.begin(), indices.end());
+	}
+
+	return first;
+}
+
+template <typename T>
+uint32_t appendLodIndices(const SubMesh& submesh, std::vector<T>& scene_indices)
+{
+	auto first = static_cast<uint32_t>(scene_indices.size());
+	for (auto index : submesh.getLodIndices())
+		scene_indices.push_back(static_cast<T>(index));
+	return first;
+}
+}        // namespace
+
+GpuMesh::GpuMesh(const SubMesh& submesh, std::vector<MeshVertex>& scene_vertices, MeshIndices& scene_indices, bool uint8_indices) :
+    submesh(&submesh)
 {
 	const auto& vertices = submesh.getVertices();
-	const auto& indices = submesh.getIndices();
 	const auto& attributes = submesh.getAttributes();
 
+	vertex_offset = static_cast<uint32_t>(scene_vertices.size());
 	vertex_count = submesh.getVerticesCount();
 	index_count = submesh.getIndicesCount();
+	if (vertices.empty())
+		vertex_count = 0;
 
 	if (!vertices.empty() && vertex_count > 0) {
 		auto source_stride = std::accumulate(attributes.begin(), attributes.end(), 0u,
@@ -27,62 +58,95 @@ GpuMesh::GpuMesh(Context& context, const SubMesh& submesh) :
 		const auto* normal_attribute = submesh.getAttribute("NORMAL");
 		const auto* uv_attribute = submesh.getAttribute("TEXCOORD_0");
 		const auto* color_attribute = submesh.getAttribute("COLOR_0");
+		has_color = color_attribute != nullptr;
 
-		std::vector<GpuVertex> gpu_vertices(vertex_count);
-		const uint8_t*         src_data = reinterpret_cast<const uint8_t*>(vertices.data());
+		std::vector<MeshVertex> mesh_vertices(vertex_count);
+		const uint8_t*          src_data = reinterpret_cast<const uint8_t*>(vertices.data());
 
 		for (uint32_t i = 0; i < vertex_count; i++) {
 			const uint8_t* vertex_data = src_data + i * source_stride;
 
 			if (pos_attribute)
-				std::memcpy(&gpu_vertices[i].pos, vertex_data + pos_attribute->offset, sizeof(glm::vec3));
+				std::memcpy(&mesh_vertices[i].pos, vertex_data + pos_attribute->offset, sizeof(glm::vec3));
 			else
-				gpu_vertices[i].pos = glm::vec3(0.0f);
+				mesh_vertices[i].pos = glm::vec3(0.0f);
 
 			if (normal_attribute)
-				std::memcpy(&gpu_vertices[i].normal, vertex_data + normal_attribute->offset, sizeof(glm::vec3));
+				std::memcpy(&mesh_vertices[i].normal, vertex_data + normal_attribute->offset, sizeof(glm::vec3));
 			else
-				gpu_vertices[i].normal = glm::vec3(0.0f, 0.0f, 1.0f);
+				mesh_vertices[i].normal = glm::vec3(0.0f, 0.0f, 1.0f);
 
 			if (uv_attribute)
-				std::memcpy(&gpu_vertices[i].uv, vertex_data + uv_attribute->offset, sizeof(glm::vec2));
+				std::memcpy(&mesh_vertices[i].uv, vertex_data + uv_attribute->offset, sizeof(glm::vec2));
 			else
-				gpu_vertices[i].uv = glm::vec2(0.0f);
+				mesh_vertices[i].uv = glm::vec2(0.0f);
 
 			if (color_attribute)
-				std::memcpy(&gpu_vertices[i].color, vertex_data + color_attribute->offset, sizeof(glm::vec4));
+				std::memcpy(&mesh_vertices[i].color, vertex_data + color_attribute->offset, sizeof(glm::vec4));
 			else
-				gpu_vertices[i].color = glm::vec4(1.0f);
+				mesh_vertices[i].color = glm::vec4(1.0f);
+		}
+
+		position_min = position_max = mesh_vertices.front().pos;
+		for (const auto& vertex : mesh_vertices) {
+			position_min = glm::min(position_min, vertex.pos);
+			position_max = glm::max(position_max, vertex.pos);
+		}
+
+		// the loader fills the submesh bounds, meshes built in code may not have any
+		if (const auto& bounds = submesh.getBounds(); !bounds.isEmpty()) {
+			bounds_min = bounds.getMin();
+			bounds_max = bounds.getMax();
+		} else {
+			bounds_min = position_min;
+			bounds_max = position_max;
 		}
 
-		vertex_buffer = Buffer::createFrom(
-		    *this->context,
-		    vk::BufferUsageFlagBits::eVertexBuffer,
-		    gpu_vertices.data(),
-		    gpu_vertices.size() * sizeof(GpuVertex));
+		scene_vertices.insert(scene_vertices.end(), mesh_vertices.begin(), mesh_vertices.end());
 	}
 
-	if (!indices.empty()) {
-		index_buffer = Buffer::createFrom(
-		    *this->context,
-		    vk::BufferUsageFlagBits::eIndexBuffer,
-		    indices.data(),
-		    indices.size() * sizeof(uint32_t));
+	// indices stay local to the submesh, draws add vertex_offset
+	meshlets = submesh.getMeshlets();
+	index_type = submesh.getIndexType();
+	if (index_type == IndexType::Uint8 && !uint8_indices)
+		index_type = IndexType::Uint16;
+
+	uint32_t first_lod_index{};
+	switch (index_type) {
+		case IndexType::Uint8:
+			first_index = appendIndices(submesh, scene_indices.uint8);
+			first_lod_index = appendLodIndices(submesh, scene_indices.uint8);
+			break;
+		case IndexType::Uint16:
+			first_index = appendIndices(submesh, scene_indices.uint16);
+			first_lod_index = appendLodIndices(submesh, scene_indices.uint16);
+			break;
+		default:
+			first_index = appendIndices(submesh, scene_indices.uint32);
+			first_lod_index = appendLodIndices(submesh, scene_indices.uint32);
 	}
-}
 
-void GpuMesh::draw()
-{
+	lods.push_back({first_index, index_count, 0.0f});
+	for (auto lod : submesh.getLods()) {
+		lod.first_index += first_lod_index;
+		lods.push_back(lod);
+	}
 }
 
-vk::Buffer GpuMesh::getVertexBuffer() const
+GpuMesh::GpuMesh(const SubMesh& submesh, uint32_t vertex_offset, uint32_t first_index, uint32_t vertex_count, uint32_t index_count,
+                 IndexType index_type, const glm::vec3& bounds_min, const glm::vec3& bounds_max, bool has_color) :
+    vertex_offset(vertex_offset), first_index(first_index), vertex_count(vertex_count), index_count(index_count), index_type(index_type),
+    has_color(has_color), bounds_min(bounds_min), bounds_max(bounds_max), position_min(bounds_min), position_max(bounds_max), lods{{first_index, index_count, 0.0f}}, submesh(&submesh)
+{}
+
+uint32_t GpuMesh::getVertexOffset() const
 {
-	return vertex_buffer->get();
+	return vertex_offset;
 }
 
-vk::Buffer GpuMesh::getIndexBuffer() const
+uint32_t GpuMesh::getFirstIndex() const
 {
-	return index_buffer->get();
+	return first_index;
 }
 
 uint32_t GpuMesh::getVertexCount() const
@@ -94,3 +158,58 @@ uint32_t GpuMesh::getIndexCount() const
 {
 	return index_count;
 }
+
+IndexType GpuMesh::getIndexType() const
+{
+	return index_type;
+}
+
+bool GpuMesh::hasColor() const
+{
+	return has_color;
+}
+
+uint32_t GpuMesh::getFirstColor() const
+{
+	return first_color;
+}
+
+void GpuMesh::setFirstColor(uint32_t first_color)
+{
+	this->first_color = first_color;
+}
+
+glm::vec3 GpuMesh::getBoundsMin() const
+{
+	return bounds_min;
+}
+
+glm::vec3 GpuMesh::getBoundsMax() const
+{
+	return bounds_max;
+}
+
+glm::vec3 GpuMesh::getPositionMin() const
+{
+	return position_min;
+}
+
+glm::vec3 GpuMesh::getPositionMax() const
+{
+	return position_max;
+}
+
+std::span<const Meshlet> GpuMesh::getMeshlets() const
+{
+	return meshlets;
+}
+
+std::span<const MeshLod> GpuMesh::getLods() const
+{
+	return lods;
+}
+
+const SubMesh& GpuMesh::getSubmesh() const
+{
+	return *submesh;
+}
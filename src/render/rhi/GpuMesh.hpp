@@ -3,25 +3,49 @@
 #include <vulkan/vulkan.hpp>
 
 #include "GpuUniforms.hpp"
-#include "render/graphics/Buffer.hpp"
+#include "GpuVertex.hpp"
 #include "scene/components/SubMesh.hpp"
 
+// the scene's indices, one array per width; a mesh's first index counts within its own width's
+struct MeshIndices {
+	std::vector<uint8_t>  uint8;
+	std::vector<uint16_t> uint16;
+	std::vector<uint32_t> uint32;
+};
+
+// a submesh's range inside the scene's shared vertex, position and index buffers; the position
+// stream holds the same vertices at the same indices, quantized within the box of the positions
 class GpuMesh {
 private:
-	std::unique_ptr<Buffer> vertex_buffer;
-	std::unique_ptr<Buffer> index_buffer;
+	uint32_t  vertex_offset{};
+	uint32_t  first_index{};
+	uint32_t  vertex_count{};
+	uint32_t  index_count{};
+	IndexType index_type{IndexType::Uint32};
 
-	std::vector<GpuUniforms> uniform_data;
+	// whether the source has colors, and where they start in the color stream
+	bool     has_color{};
+	uint32_t first_color{};
 
-	uint32_t vertex_count{};
-	uint32_t index_count{};
+	glm::vec3 bounds_min{0.0f};
+	glm::vec3 bounds_max{0.0f};
 
-	const SubMesh* submesh{};
+	glm::vec3 position_min{0.0f};
+	glm::vec3 position_max{0.0f};
 
-	Context* context{};
+	std::span<const Meshlet> meshlets;
+	std::vector<MeshLod>     lods;
+
+	const SubMesh* submesh{};
 
 public:
-	GpuMesh(Context& context, const SubMesh& submesh);
+	// keeps the submesh's index width, but widens 8-bit indices to 16 bits without uint8_indices
+	GpuMesh(const SubMesh& submesh, std::vector<MeshVertex>& vertices, MeshIndices& indices, bool uint8_indices);
+
+	// a range already in the scene's buffers, such as a static batch drawn with submesh's material;
+	// the bounds are also the positions' box
+	GpuMesh(const SubMesh& submesh, uint32_t vertex_offset, uint32_t first_index, uint32_t vertex_count, uint32_t index_count,
+	        IndexType index_type, const glm::vec3& bounds_min, const glm::vec3& bounds_max, bool has_color);
 
 	GpuMesh(const GpuMesh&) = delete;
 	GpuMesh& operator=(const GpuMesh&) = delete;
@@ -31,11 +55,33 @@ public:
 
 	~GpuMesh() = default;
 
-	void draw();
-
-	vk::Buffer getVertexBuffer() const;
-	vk::Buffer getIndexBuffer() const;
-
+	uint32_t getVertexOffset() const;
+	uint32_t getFirstIndex() const;
 	uint32_t getVertexCount() const;
 	uint32_t getIndexCount() const;
+	auto     getIndexType() const -> IndexType;
+
+	// meshes without colors are drawn white and take no room in the color stream, whose layout the
+	// scene sets once every mesh is known
+	bool     hasColor() const;
+	uint32_t getFirstColor() const;
+	void     setFirstColor(uint32_t first_color);
+
+	// local space bounds of the positions
+	glm::vec3 getBoundsMin() const;
+	glm::vec3 getBoundsMax() const;
+
+	// the box the positions are quantized to, tight around them unlike bounds read from a file
+	glm::vec3 getPositionMin() const;
+	glm::vec3 getPositionMax() const;
+
+	// the submesh's meshlets, their indices count from first_index; ranges made of several submeshes
+	// have none
+	auto getMeshlets() const -> std::span<const Meshlet>;
+
+	// every level of detail, the full one first with no error; the coarser levels' indices follow
+	// the mesh's own in the same width, ranges made of several submeshes have only the full one
+	auto getLods() const -> std::span<const MeshLod>;
+
+	auto getSubmesh() const -> const SubMesh&;
 };
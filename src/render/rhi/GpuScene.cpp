@@ -1,25 +1,986 @@
 #include "GpuScene.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <map>
+#include <optional>
+#include <print>
+#include <unordered_map>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/matrix_access.hpp>
+
 #include "render/rhi/GpuMesh.hpp"
+#include "render/rhi/VertexCompressor.hpp"
+#include "scene/base/Node.hpp"
+#include "scene/components/Mesh.hpp"
 #include "scene/components/SubMesh.hpp"
 
-GpuScene::GpuScene(Context& context, const Scene& scene) :
+namespace
+{
+DrawPass drawPass(const Material* material)
+{
+	if (!material)
+		return DrawPass::Opaque;
+
+	switch (material->getAlphaMode()) {
+		case AlphaMode::Mask:
+			return DrawPass::Masked;
+		case AlphaMode::Blend:
+			return DrawPass::Blended;
+		default:
+			return DrawPass::Opaque;
+	}
+}
+
+vk::IndexType vulkanIndexType(IndexType type)
+{
+	switch (type) {
+		case IndexType::Uint8:
+			return vk::IndexType::eUint8EXT;
+		case IndexType::Uint16:
+			return vk::IndexType::eUint16;
+		default:
+			return vk::IndexType::eUint32;
+	}
+}
+
+// the i-th index of a mesh, read at its width
+uint32_t meshIndex(const MeshIndices& indices, const GpuMesh& mesh, uint32_t i)
+{
+	switch (mesh.getIndexType()) {
+		case IndexType::Uint8:
+			return indices.uint8[mesh.getFirstIndex() + i];
+		case IndexType::Uint16:
+			return indices.uint16[mesh.getFirstIndex() + i];
+		default:
+			return indices.uint32[mesh.getFirstIndex() + i];
+	}
+}
+}        // namespace
+
+GpuScene::GpuScene(Context& context, const Scene& scene, bool static_batching) :
     context(&context), scene(&scene)
 {
-	auto submeshes = scene.getComponents<SubMesh>();
+	uploadGeometry(static_batching);
+
+	draws = scene_draws;
+	buildCommands();
+}
+
+// every submesh goes into one vertex and one index buffer so draws never rebind them, and so do
+// the static batches made from them
+void GpuScene::uploadGeometry(bool static_batching)
+{
+	auto submeshes = scene->getComponents<SubMesh>();
+
+	std::vector<MeshVertex> vertices;
+	MeshIndices             indices;
+
+	bool uint8_indices = context->getFeatures().index_type_uint8;
 
 	gpu_meshes.reserve(submeshes.size());
 	for (const auto* submesh : submeshes)
 		if (submesh && submesh->isVisible())
-			gpu_meshes.push_back(std::make_unique<GpuMesh>(*this->context, *submesh));
+			gpu_meshes.push_back(std::make_unique<GpuMesh>(*submesh, vertices, indices, uint8_indices));
+
+	collectDraws();
+
+	batch_statistics = {.draws_before = static_cast<uint32_t>(scene_draws.size())};
+	if (static_batching)
+		batchStatic(vertices, indices);
+	batch_statistics.draws_after = static_cast<uint32_t>(scene_draws.size());
+	if (static_batching)
+		std::println("Static batching: draws {} -> {}, {} batches of {} draws",
+		             batch_statistics.draws_before, batch_statistics.draws_after, batch_statistics.batch_count, batch_statistics.batched_draws);
+
+	// the meshes' ranges follow each other, batches last, and each is quantized within its own box;
+	// only those with colors add to the color stream, a batch has them when any of its draws did
+	VertexCompressor compressor;
+	for (const auto& mesh : gpu_meshes)
+		mesh->setFirstColor(compressor.add(std::span(vertices).subspan(mesh->getVertexOffset(), mesh->getVertexCount()),
+		                                   mesh->getPositionMin(), mesh->getPositionMax(), mesh->hasColor()));
+	compression_statistics = compressor.getStatistics();
+	std::println("Vertex compression: {} vertices, {} with colors, {} -> {} bytes, max error position {:.6f} of extent, normal {:.3f} deg, uv {:.6f}, color {:.4f}",
+	             compression_statistics.vertex_count, compression_statistics.colored_count, compression_statistics.bytes_before, compression_statistics.bytes_after,
+	             compression_statistics.max_position_error, compression_statistics.max_normal_error,
+	             compression_statistics.max_uv_error, compression_statistics.max_color_error);
+
+	// both streams are also storage buffers for shaders that pull their vertices; the positions are
+	// all the passes that only need depth read
+	const auto& gpu_vertices = compressor.getVertices();
+	const auto& gpu_positions = compressor.getPositions();
+	vertex_buffer = Buffer::createFrom(*context,
+	                                   vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eStorageBuffer,
+	                                   gpu_vertices.data(),
+	                                   gpu_vertices.size() * sizeof(GpuVertex));
+	position_buffer = Buffer::createFrom(*context,
+	                                     vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eStorageBuffer,
+	                                     gpu_positions.data(),
+	                                     gpu_positions.size() * sizeof(GpuPosition));
+
+	// a scene without colors still binds one, which nothing reads
+	auto gpu_colors = compressor.getColors();
+	if (gpu_colors.empty())
+		gpu_colors.push_back(VertexCompressor::encodeColor(glm::vec4(1.0f)));
+	color_buffer = Buffer::createFrom(*context, vk::BufferUsageFlagBits::eStorageBuffer, gpu_colors.data(), gpu_colors.size() * sizeof(GpuColor));
+
+	// indices keep their width, so most meshes take half the index memory and bandwidth they did
+	auto upload_indices = [&](IndexType type, const auto& data) {
+		if (!data.empty())
+			index_buffers[static_cast<size_t>(type)] = Buffer::createFrom(*context, vk::BufferUsageFlagBits::eIndexBuffer, data.data(), data.size() * sizeof(data[0]));
+	};
+	upload_indices(IndexType::Uint8, indices.uint8);
+	upload_indices(IndexType::Uint16, indices.uint16);
+	upload_indices(IndexType::Uint32, indices.uint32);
+
+	cpu_positions.clear();
+	cpu_positions.reserve(vertices.size());
+	for (const auto& vertex : vertices)
+		cpu_positions.push_back(vertex.pos);
+	cpu_indices = std::move(indices);
+}
+
+// one draw per submesh of every node instancing a mesh
+void GpuScene::collectDraws()
+{
+	std::unordered_map<const SubMesh*, uint32_t> mesh_indices;
+	for (uint32_t i = 0; i < gpu_meshes.size(); i++)
+		if (gpu_meshes[i]->getIndexCount() > 0)
+			mesh_indices[&gpu_meshes[i]->getSubmesh()] = i;
+
+	for (const auto* mesh : scene->getComponents<Mesh>())
+		for (auto* node : mesh->getNodes())
+			for (const auto* submesh : mesh->getSubmeshes())
+				if (auto it = mesh_indices.find(submesh); it != mesh_indices.end())
+					scene_draws.push_back({.mesh = it->second, .transform = &node->getTransform(), .node = node, .occluder = node->isOccluder()});
+
+	// scenes without mesh instances draw each submesh once at the origin
+	if (scene_draws.empty())
+		for (uint32_t i = 0; i < gpu_meshes.size(); i++)
+			if (gpu_meshes[i]->getIndexCount() > 0)
+				scene_draws.push_back({i});
+}
+
+// small submeshes of nodes nothing moves are put in world space and merged per material and
+// shader, so a batch is one draw however many copies went in; blended ones stay apart to keep
+// sorting back to front
+void GpuScene::batchStatic(std::vector<MeshVertex>& vertices, MeshIndices& indices)
+{
+	// larger submeshes cost little per draw next to their vertices, larger batches cull poorly; a
+	// batch's indices then always fit 16 bits
+	constexpr uint32_t max_source_vertices = 1024;
+	constexpr uint32_t max_batch_vertices = 65536;
+
+	std::map<std::pair<const Material*, std::string>, std::vector<uint32_t>> groups;
+	for (uint32_t i = 0; i < scene_draws.size(); i++) {
+		const auto& draw = scene_draws[i];
+		const auto& mesh = *gpu_meshes[draw.mesh];
+		const auto& submesh = mesh.getSubmesh();
+
+		if (!draw.node || Scene::isDynamic(*draw.node) || mesh.getVertexCount() > max_source_vertices ||
+		    drawPass(submesh.getMaterial()) == DrawPass::Blended)
+			continue;
+
+		groups[{submesh.getMaterial(), submesh.getShaderName()}].push_back(i);
+	}
+
+	std::vector<uint8_t> batched(scene_draws.size(), 0);
+	std::vector<Draw>    batch_draws;
+
+	for (const auto& [key, members] : groups) {
+		if (members.size() < 2)
+			continue;
+
+		for (size_t first = 0; first < members.size();) {
+			auto batch_mesh = static_cast<uint32_t>(gpu_meshes.size());
+			auto vertex_offset = static_cast<uint32_t>(vertices.size());
+			auto first_index = static_cast<uint32_t>(indices.uint16.size());
+			auto bounds_min = glm::vec3(std::numeric_limits<float>::infinity());
+			auto bounds_max = glm::vec3(-std::numeric_limits<float>::infinity());
+			bool has_color = false;
+
+			size_t last = first;
+			for (; last < members.size(); last++) {
+				const auto& draw = scene_draws[members[last]];
+				const auto& mesh = *gpu_meshes[draw.mesh];
+
+				auto base = static_cast<uint32_t>(vertices.size()) - vertex_offset;
+				if (last > first && base + mesh.getVertexCount() > max_batch_vertices)
+					break;
+
+				auto world = draw.transform->getWorldMatrix() * draw.offset;
+				auto normal_matrix = glm::transpose(glm::inverse(glm::mat3(world)));
+
+				for (uint32_t v = 0; v < mesh.getVertexCount(); v++) {
+					auto vertex = vertices[mesh.getVertexOffset() + v];
+					vertex.pos = glm::vec3(world * glm::vec4(vertex.pos, 1.0f));
+					if (auto normal = normal_matrix * vertex.normal; glm::dot(normal, normal) > 0.0f)
+						vertex.normal = glm::normalize(normal);
+
+					bounds_min = glm::min(bounds_min, vertex.pos);
+					bounds_max = glm::max(bounds_max, vertex.pos);
+					vertices.push_back(vertex);
+				}
+
+				for (uint32_t j = 0; j < mesh.getIndexCount(); j++)
+					indices.uint16.push_back(static_cast<uint16_t>(meshIndex(indices, mesh, j) + base));
+
+				has_color = has_color || mesh.hasColor();
+				batched[members[last]] = 1;
+			}
+
+			const auto& submesh = gpu_meshes[scene_draws[members[first]].mesh]->getSubmesh();
+			gpu_meshes.push_back(std::make_unique<GpuMesh>(submesh,
+			                                               vertex_offset,
+			                                               first_index,
+			                                               static_cast<uint32_t>(vertices.size()) - vertex_offset,
+			                                               static_cast<uint32_t>(indices.uint16.size()) - first_index,
+			                                               IndexType::Uint16,
+			                                               bounds_min,
+			                                               bounds_max,
+			                                               has_color));
+
+			batch_draws.push_back({batch_mesh});
+			batch_statistics.batch_count++;
+			batch_statistics.batched_draws += static_cast<uint32_t>(last - first);
+
+			first = last;
+		}
+	}
+
+	std::vector<Draw> remaining;
+	for (uint32_t i = 0; i < scene_draws.size(); i++)
+		if (!batched[i])
+			remaining.push_back(scene_draws[i]);
+
+	remaining.insert(remaining.end(), batch_draws.begin(), batch_draws.end());
+	scene_draws = std::move(remaining);
+}
+
+// pipelines are numbered in shader name order and materials in order of first use, so the draws
+// sort the same way every time the scene loads
+void GpuScene::buildCommands()
+{
+	std::map<std::string, uint32_t>               pipelines;
+	std::unordered_map<const Material*, uint32_t> materials;
+	for (const auto& draw : draws) {
+		const auto& submesh = gpu_meshes[draw.mesh]->getSubmesh();
+		pipelines.try_emplace(submesh.getShaderName());
+		materials.try_emplace(submesh.getMaterial(), static_cast<uint32_t>(materials.size()));
+	}
+
+	uint32_t pipeline_count = 0;
+	for (auto& [name, pipeline] : pipelines)
+		pipeline = pipeline_count++;
+
+	// instances of a submesh end up next to each other, the key sort is stable
+	std::ranges::stable_sort(draws, {}, &Draw::mesh);
+
+	draw_sorter.clear();
+	draw_sorter.reserve(draws.size());
+	for (uint32_t i = 0; i < draws.size(); i++) {
+		auto&       draw = draws[i];
+		const auto& submesh = gpu_meshes[draw.mesh]->getSubmesh();
+
+		draw.pass = drawPass(submesh.getMaterial());
+		draw.pipeline = pipelines[submesh.getShaderName()];
+		draw.material = materials[submesh.getMaterial()];
+
+		auto index_type = static_cast<uint32_t>(gpu_meshes[draw.mesh]->getIndexType());
+		draw_sorter.add(DrawSorter::makeKey(draw.pass, draw.pipeline, index_type, draw.material, 0.0f), i);
+	}
+	draw_sorter.sort();
+
+	std::vector<Draw> sorted;
+	sorted.reserve(draws.size());
+	for (auto i : draw_sorter.getValues())
+		sorted.push_back(draws[i]);
+	draws = std::move(sorted);
+
+	buckets.clear();
+	commands.clear();
+	objects.resize(draws.size());
+
+	cpu_culler.resize(static_cast<uint32_t>(draws.size()));
+	cpu_culled = false;
+	cpu_occluded.assign(draws.size(), 0);
+	cpu_occluded_count = 0;
+	cpu_lods.assign(draws.size(), 0);
+
+	std::vector<GpuCullInput> cull_inputs;
+	cull_inputs.reserve(draws.size());
+
+	// each mesh's levels once, each command's draw pointing at them
+	std::vector<GpuLod>     lods;
+	std::vector<GpuLodDraw> lod_draws;
+	std::vector<uint32_t>   mesh_lods(gpu_meshes.size(), std::numeric_limits<uint32_t>::max());
+
+	for (uint32_t i = 0; i < draws.size(); i++) {
+		const auto& draw = draws[i];
+		const auto& mesh = *gpu_meshes[draw.mesh];
+
+		objects[i].position_min = mesh.getPositionMin();
+		objects[i].position_extent = mesh.getPositionMax() - mesh.getPositionMin();
+		objects[i].color_offset = mesh.getFirstColor() - mesh.getVertexOffset();
+		objects[i].colored = mesh.hasColor();
+
+		// blended instances stay apart so they still sort back to front
+		if (instancing && i > 0 && draw.mesh == draws[i - 1].mesh && draw.pass != DrawPass::Blended) {
+			commands.back().instanceCount++;
+			continue;
+		}
+
+		if (i == 0 || draw.pass != draws[i - 1].pass || draw.pipeline != draws[i - 1].pipeline ||
+		    mesh.getIndexType() != gpu_meshes[draws[i - 1].mesh]->getIndexType())
+			buckets.push_back({mesh.getSubmesh().getShaderName(), mesh.getIndexType(), static_cast<uint32_t>(commands.size()), 0});
+		buckets.back().draw_count++;
+
+		cull_inputs.push_back({
+		    .bounds_min = mesh.getBoundsMin(),
+		    .bucket = static_cast<uint32_t>(buckets.size() - 1),
+		    .bounds_max = mesh.getBoundsMax(),
+		    .bucket_first = buckets.back().first_draw,
+		    .lod_draw = static_cast<uint32_t>(commands.size()),
+		});
+
+		if (mesh_lods[draw.mesh] == std::numeric_limits<uint32_t>::max()) {
+			mesh_lods[draw.mesh] = static_cast<uint32_t>(lods.size());
+			for (const auto& lod : mesh.getLods())
+				lods.push_back({lod.first_index, lod.index_count, lod.error});
+		}
+
+		auto center = (mesh.getBoundsMin() + mesh.getBoundsMax()) * 0.5f;
+		lod_draws.push_back({
+		    .sphere = glm::vec4(center, glm::length(mesh.getBoundsMax() - center)),
+		    .first_lod = mesh_lods[draw.mesh],
+		    .lod_count = static_cast<uint32_t>(mesh.getLods().size()),
+		});
+
+		commands.push_back(vk::DrawIndexedIndirectCommand()
+		                       .setIndexCount(mesh.getIndexCount())
+		                       .setInstanceCount(1)
+		                       .setFirstIndex(mesh.getFirstIndex())
+		                       .setVertexOffset(static_cast<int32_t>(mesh.getVertexOffset()))
+		                       .setFirstInstance(i));
+	}
+
+	std::vector<uint32_t> counts;
+	for (const auto& bucket : buckets)
+		counts.push_back(bucket.draw_count);
+
+	indirect_buffer = Buffer::createFrom(*context,
+	                                     vk::BufferUsageFlagBits::eIndirectBuffer | vk::BufferUsageFlagBits::eStorageBuffer,
+	                                     commands.data(),
+	                                     commands.size() * sizeof(vk::DrawIndexedIndirectCommand));
+	count_buffer = Buffer::createFrom(*context,
+	                                  vk::BufferUsageFlagBits::eIndirectBuffer | vk::BufferUsageFlagBits::eStorageBuffer,
+	                                  counts.data(),
+	                                  counts.size() * sizeof(uint32_t));
+
+	// the CPU path splits a command by the levels its instances are drawn at
+	size_t sorted_count = 0;
+	for (const auto& command : commands)
+		sorted_count += std::min<size_t>(command.instanceCount, gpu_meshes[draws[command.firstInstance].mesh]->getLods().size());
+
+	sorted_commands.reserve(sorted_count);
+	sorted_objects.reserve(objects.size());
+	sorted_buffer.reset();
+	if (!commands.empty())
+		sorted_buffer = std::make_unique<Buffer>(*context,
+		                                         sorted_count * sizeof(vk::DrawIndexedIndirectCommand),
+		                                         vk::BufferUsageFlagBits::eIndirectBuffer,
+		                                         vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+
+	object_buffer.reset();
+	if (!objects.empty())
+		object_buffer = std::make_unique<Buffer>(*context,
+		                                         objects.size() * sizeof(GpuObject),
+		                                         vk::BufferUsageFlagBits::eStorageBuffer,
+		                                         vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+
+	update();
+
+	if (commands.empty()) {
+		culling.reset();
+		return;
+	}
+
+	buildClusters(cull_inputs);
+
+	if (!culling) {
+		culling = std::make_unique<GpuCulling>(*context);
+		culling->setDepthPyramid(depth_pyramid);
+	}
+	culling->build(cluster_buffer ? *cluster_buffer : *indirect_buffer, *object_buffer, cull_inputs, static_cast<uint32_t>(buckets.size()), lod_draws, lods);
+}
+
+// the meshlets' index ranges become commands of their own in their draw's bucket, which the GPU
+// culls and compacts like any other, so no mesh shaders are needed; the CPU path keeps drawing
+// whole meshes. The meshlets are all of the full detail, one more command draws the coarser levels
+void GpuScene::buildClusters(std::vector<GpuCullInput>& cull_inputs)
+{
+	cluster_commands.clear();
+	cluster_buckets.clear();
+	cluster_buffer.reset();
+
+	bool clustered = meshlet_culling && std::ranges::any_of(commands, [&](const auto& command) {
+		return !gpu_meshes[draws[command.firstInstance].mesh]->getMeshlets().empty();
+	});
+	if (!clustered)
+		return;
+
+	std::vector<GpuCullInput> cluster_inputs;
+	for (const auto& bucket : buckets) {
+		auto& cluster_bucket = cluster_buckets.emplace_back(bucket);
+		cluster_bucket.first_draw = static_cast<uint32_t>(cluster_commands.size());
+		cluster_bucket.draw_count = 0;
+
+		for (uint32_t c = bucket.first_draw; c < bucket.first_draw + bucket.draw_count; c++) {
+			const auto& command = commands[c];
+			const auto& mesh = *gpu_meshes[draws[command.firstInstance].mesh];
+
+			auto input = cull_inputs[c];
+			input.bucket_first = cluster_bucket.first_draw;
+
+			auto meshlets = mesh.getMeshlets();
+			if (meshlets.empty()) {
+				cluster_commands.push_back(command);
+				cluster_inputs.push_back(input);
+				cluster_bucket.draw_count++;
+				continue;
+			}
+
+			// both sides of double sided materials are meant to be seen
+			const auto* material = mesh.getSubmesh().getMaterial();
+			bool        double_sided = material && material->getDoubleSided();
+
+			for (const auto& meshlet : meshlets) {
+				auto cluster = command;
+				cluster_commands.push_back(cluster.setFirstIndex(command.firstIndex + meshlet.first_index).setIndexCount(meshlet.index_count));
+
+				input.bounds_min = meshlet.bounds_min;
+				input.bounds_max = meshlet.bounds_max;
+				input.sphere = glm::vec4(meshlet.center, meshlet.radius);
+				input.cone = double_sided ? glm::vec4(0.0f, 0.0f, 0.0f, 1.0f) : glm::vec4(meshlet.cone_axis, meshlet.cone_cutoff);
+				input.lod_mode = GpuLodMode::Meshlet;
+				cluster_inputs.push_back(input);
+			}
+			cluster_bucket.draw_count += static_cast<uint32_t>(meshlets.size());
+
+			if (mesh.getLods().size() > 1) {
+				auto coarse = cull_inputs[c];
+				coarse.bucket_first = cluster_bucket.first_draw;
+				coarse.lod_mode = GpuLodMode::Coarse;
+				cluster_commands.push_back(command);
+				cluster_inputs.push_back(coarse);
+				cluster_bucket.draw_count++;
+			}
+		}
+	}
+
+	cull_inputs = std::move(cluster_inputs);
+	cluster_buffer = Buffer::createFrom(*context,
+	                                    vk::BufferUsageFlagBits::eIndirectBuffer | vk::BufferUsageFlagBits::eStorageBuffer,
+	                                    cluster_commands.data(),
+	                                    cluster_commands.size() * sizeof(vk::DrawIndexedIndirectCommand));
+}
+
+void GpuScene::update()
+{
+	if (objects.empty())
+		return;
+
+	for (uint32_t i = 0; i < draws.size(); i++) {
+		auto world = draws[i].transform ? draws[i].transform->getWorldMatrix() : glm::mat4(1.0f);
+		objects[i].model = world * draws[i].offset;
+
+		const auto& mesh = *gpu_meshes[draws[i].mesh];
+		cpu_culler.setBounds(i, mesh.getBoundsMin(), mesh.getBoundsMax(), objects[i].model);
+	}
+
+	object_buffer->upload(objects.data(), objects.size() * sizeof(GpuObject));
+}
+
+void GpuScene::draw(vk::CommandBuffer command_buffer, SceneVertexStream stream)
+{
+	draw(command_buffer, CullPhase::Early, stream);
+	if (isOcclusionCulled())
+		draw(command_buffer, CullPhase::Late, stream);
+}
+
+// without occlusion culling every draw belongs to the early phase
+void GpuScene::draw(vk::CommandBuffer command_buffer, CullPhase phase, SceneVertexStream stream)
+{
+	if (commands.empty() || !vertex_buffer)
+		return;
+	if (phase == CullPhase::Late && !isOcclusionCulled())
+		return;
+
+	if (!vertex_pulling && stream == SceneVertexStream::Position)
+		command_buffer.bindVertexBuffers(0, position_buffer->get(), {0});
+	else if (!vertex_pulling)
+		command_buffer.bindVertexBuffers(0, {position_buffer->get(), vertex_buffer->get()}, {0, 0});
+
+	// non-zero firstInstance in indirect commands needs drawIndirectFirstInstance
+	const auto& features = context->getFeatures();
+	bool        indirect = draw_mode == SceneDrawMode::Indirect && features.draw_indirect_first_instance;
+
+	constexpr uint32_t stride = sizeof(vk::DrawIndexedIndirectCommand);
+
+	// culled draws are compacted and counted when the count can come from the GPU
+	bool gpu_count = isGpuCulled() ? culling->isCompacting() : features.draw_indirect_count;
+
+	auto draw_range = [&](vk::Buffer draw_buffer, uint32_t first, uint32_t draw_count) {
+		if (features.multi_draw_indirect)
+			command_buffer.drawIndexedIndirect(draw_buffer, first * stride, draw_count, stride);
+		else
+			for (uint32_t i = first; i < first + draw_count; i++)
+				command_buffer.drawIndexedIndirect(draw_buffer, i * stride, 1, stride);
+	};
+
+	// the CPU path already sorted what it kept, and has no counts; the GPU path culls meshlets as
+	// commands of their own when there are any
+	bool        sorted = cpu_culled && !isGpuCulled();
+	bool        clustered = isGpuCulled() && cluster_buffer;
+	const auto& draw_buckets = sorted ? sorted_buckets : clustered ? cluster_buckets : buckets;
+	const auto& draw_commands = sorted ? sorted_commands : commands;
+
+	auto draw_buffer = sorted ? sorted_buffer->get() : getIndirectBuffer(phase).get();
+	auto count = getCountBuffer(phase).get();
+
+	std::optional<IndexType> bound_indices;
+	for (uint32_t b = 0; b < draw_buckets.size(); b++) {
+		const auto& bucket = draw_buckets[b];
+
+		if (bucket.index_type != bound_indices) {
+			command_buffer.bindIndexBuffer(index_buffers[static_cast<size_t>(bucket.index_type)]->get(), 0, vulkanIndexType(bucket.index_type));
+			bound_indices = bucket.index_type;
+		}
+
+		if (!indirect) {
+			for (uint32_t i = bucket.first_draw; i < bucket.first_draw + bucket.draw_count; i++) {
+				const auto& command = draw_commands[i];
+				command_buffer.drawIndexed(command.indexCount, command.instanceCount, command.firstIndex, command.vertexOffset, command.firstInstance);
+			}
+			continue;
+		}
+
+		if (gpu_count && !sorted)
+			command_buffer.drawIndexedIndirectCount(draw_buffer, bucket.first_draw * stride, count, b * sizeof(uint32_t), bucket.draw_count, stride);
+		else
+			draw_range(draw_buffer, bucket.first_draw, bucket.draw_count);
+	}
+}
+
+void GpuScene::cull(vk::CommandBuffer command_buffer, const glm::mat4& view_projection, CullPhase phase)
+{
+	if (isGpuCulled()) {
+		culling->setLodSelection(lod_scale, lod_threshold, lod_hysteresis);
+		culling->cull(command_buffer, view_projection, phase);
+		return;
+	}
+
+	if (phase != CullPhase::Early)
+		return;
+
+	// debug builds check the SIMD kernel against the scalar reference every frame
+#ifndef NDEBUG
+	if (auto mismatches = cpu_culler.validate(view_projection))
+		std::println("Frustum culler: {} kernel disagrees with the scalar path on {} boxes", FrustumCuller::getKernelName(), mismatches);
+#else
+	cpu_culler.cull(view_projection);
+#endif
+	cpu_culled = true;
+
+	std::ranges::fill(cpu_occluded, 0);
+	cpu_occluded_count = 0;
+	if (cpu_occlusion)
+		cullOcclusion(view_projection);
+
+	sortDraws(view_projection);
+}
+
+// rasterizes the biggest boxes on screen within a triangle budget, then tests the other draws the
+// frustum kept against them
+void GpuScene::cullOcclusion(const glm::mat4& view_projection)
+{
+	constexpr uint32_t max_occluders = 16;
+	constexpr uint32_t triangle_budget = 32768;
+	// boxes narrower than this, as a fraction of their distance, rarely hide anything
+	constexpr float min_size = 0.1f;
+
+	const auto& bounds = cpu_culler.getBounds();
+	auto        row3 = glm::row(view_projection, 3);
+
+	// the box's extent over its distance from the camera, squared, roughly how much screen it covers
+	auto screen_size = [&](uint32_t i) {
+		float distance = row3.x * bounds.center_x[i] + row3.y * bounds.center_y[i] + row3.z * bounds.center_z[i] + row3.w;
+		float extent = bounds.extent_x[i] * bounds.extent_x[i] + bounds.extent_y[i] * bounds.extent_y[i] + bounds.extent_z[i] * bounds.extent_z[i];
+		return extent / std::max(distance * distance, 1e-6f);
+	};
+
+	occluders.clear();
+	for (uint32_t i = 0; i < draws.size(); i++)
+		if (cpu_culler.isVisible(i) && (draws[i].occluder || screen_size(i) >= min_size * min_size))
+			occluders.push_back(i);
+
+	// marked draws first, then by size
+	std::ranges::sort(occluders, std::greater{}, [&](uint32_t i) {
+		return std::pair{draws[i].occluder, screen_size(i)};
+	});
+
+	occlusion_culler.clear();
+
+	uint32_t triangles = 0;
+	uint32_t count = 0;
+	for (auto i : occluders) {
+		const auto& mesh = *gpu_meshes[draws[i].mesh];
+		if (count == max_occluders || triangles + mesh.getIndexCount() / 3 > triangle_budget)
+			break;
+
+		auto positions = std::span(cpu_positions).subspan(mesh.getVertexOffset(), mesh.getVertexCount());
+		auto model_view_projection = view_projection * objects[i].model;
+		switch (mesh.getIndexType()) {
+			case IndexType::Uint8:
+				occlusion_culler.addOccluder(positions, std::span(cpu_indices.uint8).subspan(mesh.getFirstIndex(), mesh.getIndexCount()), model_view_projection);
+				break;
+			case IndexType::Uint16:
+				occlusion_culler.addOccluder(positions, std::span(cpu_indices.uint16).subspan(mesh.getFirstIndex(), mesh.getIndexCount()), model_view_projection);
+				break;
+			default:
+				occlusion_culler.addOccluder(positions, std::span(cpu_indices.uint32).subspan(mesh.getFirstIndex(), mesh.getIndexCount()), model_view_projection);
+		}
+
+		triangles += mesh.getIndexCount() / 3;
+		count++;
+	}
+
+	if (count == 0)
+		return;
+
+	occlusion_culler.rasterize();
+
+	// an occluder never hides itself, the depth it leaves lies behind its box's nearest point
+	for (uint32_t i = 0; i < draws.size(); i++) {
+		if (!cpu_culler.isVisible(i))
+			continue;
+
+		const auto& mesh = *gpu_meshes[draws[i].mesh];
+		if (occlusion_culler.isOccluded(mesh.getBoundsMin(), mesh.getBoundsMax(), view_projection * objects[i].model)) {
+			cpu_occluded[i] = 1;
+			cpu_occluded_count++;
+		}
+	}
 }
 
-void GpuScene::draw(vk::CommandBuffer command_buffer)
+// opaque draws front to back so early-z rejects more, blended ones back to front; the depth is the
+// nearest kept instance's box center's w, its distance along the view direction
+void GpuScene::sortDraws(const glm::mat4& view_projection)
 {
-	for (size_t i = 0; i < gpu_meshes.size(); i++)
-		if (auto& gpu_mesh = gpu_meshes[i]; gpu_mesh) {
-			command_buffer.bindVertexBuffers(0, gpu_mesh->getVertexBuffer(), {0});
-			command_buffer.bindIndexBuffer(gpu_mesh->getIndexBuffer(), 0, vk::IndexType::eUint32);
-			command_buffer.drawIndexed(gpu_mesh->getIndexCount(), 1, 0, 0, 0);
+	const auto& bounds = cpu_culler.getBounds();
+	auto        row3 = glm::row(view_projection, 3);
+
+	draw_sorter.clear();
+	for (uint32_t c = 0; c < commands.size(); c++) {
+		const auto& command = commands[c];
+
+		float nearest = std::numeric_limits<float>::infinity();
+		for (uint32_t i = command.firstInstance; i < command.firstInstance + command.instanceCount; i++)
+			if (isCpuVisible(i))
+				nearest = std::min(nearest, row3.x * bounds.center_x[i] + row3.y * bounds.center_y[i] + row3.z * bounds.center_z[i] + row3.w);
+
+		if (nearest == std::numeric_limits<float>::infinity())
+			continue;
+
+		const auto& draw = draws[command.firstInstance];
+		auto        index_type = static_cast<uint32_t>(gpu_meshes[draw.mesh]->getIndexType());
+		draw_sorter.add(DrawSorter::makeKey(draw.pass, draw.pipeline, index_type, draw.material, nearest), c);
+	}
+	draw_sorter.sort();
+
+	// the kept instances are packed in drawing order, so instanced draws skip the hidden ones; this
+	// replaces what update() uploaded, the GPU path being the only reader of that layout. runs of
+	// one index type become buckets, only their index buffer needs binding. A command is split by
+	// the levels its instances are drawn at, finest first
+	auto camera = GpuCulling::getCameraPosition(view_projection);
+
+	sorted_commands.clear();
+	sorted_objects.clear();
+	sorted_buckets.clear();
+	cpu_triangles_full = 0;
+	cpu_triangles_drawn = 0;
+	for (auto c : draw_sorter.getValues()) {
+		const auto& command = commands[c];
+
+		const auto& mesh = *gpu_meshes[draws[command.firstInstance].mesh];
+		if (sorted_buckets.empty() || sorted_buckets.back().index_type != mesh.getIndexType())
+			sorted_buckets.push_back({mesh.getSubmesh().getShaderName(), mesh.getIndexType(), static_cast<uint32_t>(sorted_commands.size()), 0});
+
+		for (uint32_t i = command.firstInstance; i < command.firstInstance + command.instanceCount; i++)
+			if (isCpuVisible(i))
+				cpu_lods[i] = static_cast<uint8_t>(selectLod(i, camera));
+
+		auto lods = mesh.getLods();
+		for (uint32_t level = 0; level < lods.size(); level++) {
+			auto first = static_cast<uint32_t>(sorted_objects.size());
+			for (uint32_t i = command.firstInstance; i < command.firstInstance + command.instanceCount; i++)
+				if (isCpuVisible(i) && cpu_lods[i] == level)
+					sorted_objects.push_back(objects[i]);
+
+			auto instance_count = static_cast<uint32_t>(sorted_objects.size()) - first;
+			if (instance_count == 0)
+				continue;
+
+			auto split = command;
+			sorted_commands.push_back(split.setFirstIndex(lods[level].first_index)
+			                              .setIndexCount(lods[level].index_count)
+			                              .setFirstInstance(first)
+			                              .setInstanceCount(instance_count));
+			sorted_buckets.back().draw_count++;
+
+			cpu_triangles_full += lods.front().index_count / 3 * instance_count;
+			cpu_triangles_drawn += lods[level].index_count / 3 * instance_count;
 		}
+	}
+
+	if (sorted_commands.empty())
+		return;
+
+	sorted_buffer->upload(sorted_commands.data(), sorted_commands.size() * sizeof(vk::DrawIndexedIndirectCommand));
+	object_buffer->upload(sorted_objects.data(), sorted_objects.size() * sizeof(GpuObject));
+}
+
+// see selectLod in cull.slang, the world box's half diagonal standing in for the scaled sphere
+uint32_t GpuScene::selectLod(uint32_t draw, const glm::vec4& camera) const
+{
+	auto lods = gpu_meshes[draws[draw].mesh]->getLods();
+	if (lods.size() <= 1 || lod_scale <= 0.0f || lod_threshold <= 0.0f || camera.w == 0.0f)
+		return 0;
+
+	const auto& bounds = cpu_culler.getBounds();
+	glm::vec3   center(bounds.center_x[draw], bounds.center_y[draw], bounds.center_z[draw]);
+	glm::vec3   extent(bounds.extent_x[draw], bounds.extent_y[draw], bounds.extent_z[draw]);
+
+	float distance = glm::length(center - glm::vec3(camera)) - glm::length(extent);
+	if (distance <= 0.0f)
+		return 0;
+
+	const auto& model = objects[draw].model;
+	float       scale = std::max({glm::length(glm::vec3(model[0])), glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2]))});
+	float       density = lod_scale * scale / distance;
+
+	uint32_t level = 0;
+	for (uint32_t lod = 1; lod < lods.size(); lod++) {
+		float threshold = lod_threshold * (lod > cpu_lods[draw] ? 1.0f - lod_hysteresis : 1.0f);
+		if (lods[lod].error * density > threshold)
+			break;
+		level = lod;
+	}
+
+	return level;
+}
+
+bool GpuScene::isCpuVisible(uint32_t draw) const
+{
+	return cpu_culler.isVisible(draw) && !cpu_occluded[draw];
+}
+
+void GpuScene::cullBarrier(vk::CommandBuffer command_buffer) const
+{
+	if (isGpuCulled())
+		culling->barrier(command_buffer);
+}
+
+// direct draws are recorded from the CPU copy of the commands and cannot be culled
+bool GpuScene::isGpuCulled() const
+{
+	return gpu_culling && culling && draw_mode == SceneDrawMode::Indirect && context->getFeatures().draw_indirect_first_instance;
+}
+
+void GpuScene::setGpuCulling(bool enabled)
+{
+	gpu_culling = enabled;
+}
+
+void GpuScene::setDepthPyramid(const GpuDepthPyramid* pyramid)
+{
+	depth_pyramid = pyramid;
+	if (culling)
+		culling->setDepthPyramid(depth_pyramid);
+}
+
+bool GpuScene::isOcclusionCulled() const
+{
+	return isGpuCulled() && culling->isOccluding();
+}
+
+GpuCullStatistics GpuScene::getCullStatistics() const
+{
+	if (isGpuCulled())
+		return culling->getStatistics();
+
+	GpuCullStatistics statistics{};
+	if (cpu_culled) {
+		statistics.frustum_culled = cpu_culler.getCount() - cpu_culler.getVisibleCount();
+		statistics.occlusion_culled = cpu_occluded_count;
+		statistics.drawn = cpu_culler.getVisibleCount() - cpu_occluded_count;
+		statistics.triangles_full = cpu_triangles_full;
+		statistics.triangles_drawn = cpu_triangles_drawn;
+	}
+
+	return statistics;
+}
+
+void GpuScene::setCpuOcclusion(bool enabled)
+{
+	cpu_occlusion = enabled;
+}
+
+const StaticBatchStatistics& GpuScene::getBatchStatistics() const
+{
+	return batch_statistics;
+}
+
+bool GpuScene::isVertexPulling() const
+{
+	return vertex_pulling;
+}
+
+void GpuScene::setVertexPulling(bool enabled)
+{
+	vertex_pulling = enabled;
+}
+
+void GpuScene::setMeshletCulling(bool enabled)
+{
+	if (meshlet_culling == enabled)
+		return;
+
+	meshlet_culling = enabled;
+	buildCommands();
+}
+
+bool GpuScene::isMeshletCulling() const
+{
+	return meshlet_culling;
+}
+
+// the pixels one unit covers one unit in front of the camera
+void GpuScene::setLodProjection(float fov, float viewport_height)
+{
+	lod_scale = viewport_height / (2.0f * std::tan(fov * 0.5f));
+}
+
+void GpuScene::setLodThreshold(float pixels)
+{
+	lod_threshold = pixels;
+}
+
+float GpuScene::getLodThreshold() const
+{
+	return lod_threshold;
+}
+
+void GpuScene::setInstancing(bool enabled)
+{
+	if (instancing == enabled)
+		return;
+
+	instancing = enabled;
+	buildCommands();
+}
+
+bool GpuScene::isInstancing() const
+{
+	return instancing;
+}
+
+void GpuScene::replicateDraws(uint32_t draw_count)
+{
+	if (scene_draws.empty())
+		return;
+
+	constexpr float    spacing = 4.0f;
+	constexpr uint32_t grid = 64;
+
+	draws.clear();
+	draws.reserve(draw_count);
+	for (uint32_t i = 0; i < draw_count; i++) {
+		auto copy = i / static_cast<uint32_t>(scene_draws.size());
+
+		auto draw = scene_draws[i % scene_draws.size()];
+		draw.offset = glm::translate(glm::mat4(1.0f), glm::vec3(copy % grid, 0.0f, copy / grid) * spacing);
+		draws.push_back(draw);
+	}
+
+	buildCommands();
+}
+
+SceneDrawMode GpuScene::getDrawMode() const
+{
+	return draw_mode;
+}
+
+void GpuScene::setDrawMode(SceneDrawMode draw_mode)
+{
+	this->draw_mode = draw_mode;
+}
+
+uint32_t GpuScene::getDrawCount() const
+{
+	return static_cast<uint32_t>(commands.size());
+}
+
+uint32_t GpuScene::getInstanceCount() const
+{
+	return static_cast<uint32_t>(draws.size());
+}
+
+uint32_t GpuScene::getBucketCount() const
+{
+	return static_cast<uint32_t>(buckets.size());
+}
+
+// the commands the GPU culls, one per meshlet for meshes that have them
+uint32_t GpuScene::getClusterCount() const
+{
+	return static_cast<uint32_t>(cluster_buffer ? cluster_commands.size() : commands.size());
+}
+
+const Buffer& GpuScene::getVertexBuffer() const
+{
+	return *vertex_buffer;
+}
+
+const Buffer& GpuScene::getPositionBuffer() const
+{
+	return *position_buffer;
+}
+
+const Buffer& GpuScene::getColorBuffer() const
+{
+	return *color_buffer;
+}
+
+const VertexCompressionStatistics& GpuScene::getCompressionStatistics() const
+{
+	return compression_statistics;
+}
+
+const Buffer& GpuScene::getObjectBuffer() const
+{
+	return *object_buffer;
+}
+
+const Buffer& GpuScene::getIndirectBuffer(CullPhase phase) const
+{
+	return isGpuCulled() ? culling->getCommandBuffer(phase) : *indirect_buffer;
+}
+
+const Buffer& GpuScene::getCountBuffer(CullPhase phase) const
+{
+	return isGpuCulled() ? culling->getCountBuffer(phase) : *count_buffer;
 }
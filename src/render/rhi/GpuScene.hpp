@@ -1,22 +1,146 @@
 #pragma once
 
+#include <array>
 #include <memory>
 #include <vector>
 
 #include "GpuMesh.hpp"
+#include "GpuUniforms.hpp"
+#include "GpuCulling.hpp"
+#include "DrawSorter.hpp"
+#include "VertexCompressor.hpp"
+#include "render/culling/FrustumCuller.hpp"
+#include "render/culling/OcclusionCuller.hpp"
 #include "render/graphics/Context.hpp"
+#include "render/graphics/Buffer.hpp"
 #include "scene/base/Scene.hpp"
 
+enum class SceneDrawMode : uint8_t {
+	Direct,          // one drawIndexed per draw, recording cost grows with the draw count
+	Indirect,        // one drawIndexedIndirect(Count) per bucket
+};
+
+// draws of the scene before and after static batching
+struct StaticBatchStatistics {
+	uint32_t draws_before{};
+	uint32_t draws_after{};
+	uint32_t batch_count{};
+	uint32_t batched_draws{};
+};
+
+enum class SceneVertexStream : uint8_t {
+	Full,            // the positions and the other attributes, see GpuVertex
+	Position,        // the positions alone, for passes that only write depth
+};
+
 class GpuScene {
 private:
+	// one instance of a submesh, the instances of one share a command and sit next to each other
+	struct Draw {
+		uint32_t    mesh{};
+		Transform*  transform{};
+		const Node* node{};
+		glm::mat4   offset{1.0f};
+		bool        occluder{};
+		DrawPass    pass{};
+		uint32_t    pipeline{};
+		uint32_t    material{};
+	};
+
+	// commands sharing a pass, pipeline and index type, contiguous in the indirect buffer
+	struct Bucket {
+		std::string shader_name;
+		IndexType   index_type{};
+		uint32_t    first_draw{};
+		uint32_t    draw_count{};
+	};
+
 	Context*     context{};
 	const Scene* scene{};
 
 	std::vector<std::unique_ptr<GpuMesh>> gpu_meshes;
 
+	StaticBatchStatistics batch_statistics;
+
+	VertexCompressionStatistics compression_statistics;
+
+	std::vector<Draw>                           scene_draws;
+	std::vector<Draw>                           draws;
+	std::vector<Bucket>                         buckets;
+	std::vector<GpuObject>                      objects;
+	std::vector<vk::DrawIndexedIndirectCommand> commands;
+
+	std::unique_ptr<Buffer> vertex_buffer;
+	std::unique_ptr<Buffer> position_buffer;
+	std::unique_ptr<Buffer> color_buffer;
+	std::unique_ptr<Buffer> object_buffer;
+	std::unique_ptr<Buffer> indirect_buffer;
+	std::unique_ptr<Buffer> count_buffer;
+
+	// one per index width, by IndexType, left empty for widths no mesh uses
+	std::array<std::unique_ptr<Buffer>, 3> index_buffers;
+
+	std::unique_ptr<GpuCulling> culling;
+	const GpuDepthPyramid*      depth_pyramid{};
+
+	// what the GPU culls when any draw's mesh has meshlets: the commands with those draws split into
+	// one per meshlet, in the same buckets
+	std::vector<vk::DrawIndexedIndirectCommand> cluster_commands;
+	std::vector<Bucket>                         cluster_buckets;
+	std::unique_ptr<Buffer>                     cluster_buffer;
+
+	// culls on the CPU whenever the GPU does not, draw() then skips the hidden draws
+	FrustumCuller cpu_culler;
+	bool          cpu_culled{};
+
+	// CPU copies of the positions and indices, what occluders are rasterized from
+	std::vector<glm::vec3> cpu_positions;
+	MeshIndices            cpu_indices;
+
+	OcclusionCuller       occlusion_culler;
+	std::vector<uint8_t>  cpu_occluded;
+	std::vector<uint32_t> occluders;
+	uint32_t              cpu_occluded_count{};
+	bool                  cpu_occlusion{true};
+
+	// the CPU path's visible commands by sort key each frame, and their kept instances in that order
+	DrawSorter                                  draw_sorter;
+	std::vector<vk::DrawIndexedIndirectCommand> sorted_commands;
+	std::vector<GpuObject>                      sorted_objects;
+	std::vector<Bucket>                         sorted_buckets;
+	std::unique_ptr<Buffer>                     sorted_buffer;
+
+	// level of detail selection, see setLodProjection; the CPU path keeps each draw's level from
+	// the last frame it was visible in, for the hysteresis
+	float                lod_scale{};
+	float                lod_threshold{1.0f};
+	std::vector<uint8_t> cpu_lods;
+	uint32_t             cpu_triangles_full{};
+	uint32_t             cpu_triangles_drawn{};
+
+	SceneDrawMode draw_mode{SceneDrawMode::Indirect};
+	bool          gpu_culling{true};
+	bool          instancing{true};
+	bool          vertex_pulling{};
+	bool          meshlet_culling{true};
+
+	void uploadGeometry(bool static_batching);
+	void collectDraws();
+	void batchStatic(std::vector<MeshVertex>& vertices, MeshIndices& indices);
+	void buildCommands();
+	void buildClusters(std::vector<GpuCullInput>& cull_inputs);
+	auto selectLod(uint32_t draw, const glm::vec4& camera) const -> uint32_t;
+
+	void cullOcclusion(const glm::mat4& view_projection);
+	void sortDraws(const glm::mat4& view_projection);
+	bool isCpuVisible(uint32_t draw) const;
+
 public:
+	// how much tighter the threshold is for going to a coarser level than for staying at one
+	static constexpr float lod_hysteresis = 0.25f;
+
 	GpuScene() = default;
-	GpuScene(Context& context, const Scene& scene);
+	GpuScene(Context& context, const Scene& scene, bool static_batching = false);
 
 	GpuScene(const GpuScene&) = delete;
 	GpuScene& operator=(const GpuScene&) = delete;
@@ -26,5 +150,69 @@ public:
 
 	~GpuScene() = default;
 
-	void draw(vk::CommandBuffer command_buffer);
+	// refreshes the per-draw world matrices
+	void update();
+
+	// draws both culling phases, or only the given one, from the stream the bound pipeline reads
+	void draw(vk::CommandBuffer command_buffer, SceneVertexStream stream = SceneVertexStream::Full);
+	void draw(vk::CommandBuffer command_buffer, CullPhase phase, SceneVertexStream stream = SceneVertexStream::Full);
+
+	// records a culling dispatch, must happen outside of rendering and before the phase is drawn
+	void cull(vk::CommandBuffer command_buffer, const glm::mat4& view_projection, CullPhase phase = CullPhase::Early);
+	void cullBarrier(vk::CommandBuffer command_buffer) const;
+	bool isGpuCulled() const;
+	void setGpuCulling(bool enabled);
+
+	// enables occlusion culling against the pyramid, which the caller rebuilds between the phases
+	void setDepthPyramid(const GpuDepthPyramid* pyramid);
+	bool isOcclusionCulled() const;
+	auto getCullStatistics() const -> GpuCullStatistics;
+
+	// occlusion culling on the CPU, used whenever the GPU does not cull; the largest boxes on screen
+	// occlude, and so do the draws of nodes marked with Node::setOccluder
+	void setCpuOcclusion(bool enabled);
+
+	auto getBatchStatistics() const -> const StaticBatchStatistics&;
+
+	// how much the vertex streams shrank and the largest error it caused, measured at upload
+	auto getCompressionStatistics() const -> const VertexCompressionStatistics&;
+
+	// leaves the vertex buffer unbound, for pipelines whose shaders fetch vertices from it as a
+	// storage buffer
+	bool isVertexPulling() const;
+	void setVertexPulling(bool enabled);
+
+	// culls the draws of meshes with meshlets one meshlet at a time when the GPU culls, by frustum,
+	// normal cone and occlusion; rebuilds the buffers like setInstancing
+	void setMeshletCulling(bool enabled);
+	bool isMeshletCulling() const;
+
+	// draws each instance of a mesh with levels of detail at the coarsest level whose error covers
+	// at most the threshold in pixels, 0 keeping the full detail, for a vertical field of view in
+	// radians over viewport_height pixels. The GPU selects once per command, at its closest instance
+	void setLodProjection(float fov, float viewport_height);
+	void setLodThreshold(float pixels);
+	auto getLodThreshold() const -> float;
+
+	// one command per submesh for all the nodes referencing it; rebuilds the buffers, so the object
+	// binding has to be refreshed
+	void setInstancing(bool enabled);
+	bool isInstancing() const;
+
+	// repeats the scene's draws until there are draw_count of them, used to measure recording cost
+	void replicateDraws(uint32_t draw_count);
+
+	auto getDrawMode() const -> SceneDrawMode;
+	void setDrawMode(SceneDrawMode draw_mode);
+
+	auto getDrawCount() const -> uint32_t;
+	auto getInstanceCount() const -> uint32_t;
+	auto getBucketCount() const -> uint32_t;
+	auto getClusterCount() const -> uint32_t;
+	auto getVertexBuffer() const -> const Buffer&;
+	auto getPositionBuffer() const -> const Buffer&;
+	auto getColorBuffer() const -> const Buffer&;
+	auto getObjectBuffer() const -> const Buffer&;
+	auto getIndirectBuffer(CullPhase phase = CullPhase::Early) const -> const Buffer&;
+	auto getCountBuffer(CullPhase phase = CullPhase::Early) const -> const Buffer&;
 };
@@ -9,3 +9,13 @@ vk::DescriptorSetLayoutBinding GpuTransform::binding(uint32_t binding)
 	    vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment,
 	};
 }
+
+vk::DescriptorSetLayoutBinding GpuObject::binding(uint32_t binding)
+{
+	return {
+	    binding,
+	    vk::DescriptorType::eStorageBuffer,
+	    1,
+	    vk::ShaderStageFlagBits::eVertex,
+	};
+}
@@ -3,6 +3,20 @@
 #include <vulkan/vulkan.hpp>
 #include <glm/glm.hpp>
 
+// specialization constant ids declared in default.slang
+enum class GpuSpecialization : uint32_t {
+	Textured = 0,
+	AlphaTest = 1,
+	AlphaCutoff = 2,
+	LightCount = 3,
+	QualityTier = 4,
+};
+
+// specialization constant ids declared in cull.slang
+enum class GpuCullSpecialization : uint32_t {
+	Compact = 0,
+};
+
 struct GpuUniforms {
 };
 
@@ -13,3 +27,91 @@ struct GpuTransform : public GpuUniforms {
 
 	static vk::DescriptorSetLayoutBinding binding(uint32_t binding = {});
 };
+
+// per-instance data, indexed by the instance index of each draw; positions decode to
+// position_min + position_extent * q from their unorm16 q, see GpuPosition. Instances of meshes
+// with colors find a vertex's at its index plus color_offset in the color stream, wrapping around,
+// the others are white
+struct GpuObject : public GpuUniforms {
+	glm::mat4 model;
+	glm::vec3 position_min{0.0f};
+	uint32_t  color_offset{};
+	glm::vec3 position_extent{0.0f};
+	uint32_t  colored{};
+
+	static vk::DescriptorSetLayoutBinding binding(uint32_t binding = {});
+};
+
+// how a culled command draws its draw's levels of detail, matches the LOD_ constants in cull.slang
+enum class GpuLodMode : uint32_t {
+	Whole = 0,          // whichever level is selected, the command's range replaced by it
+	Meshlet = 1,        // one meshlet of the full detail, drawn only while that is selected
+	Coarse = 2,         // the coarser levels of a draw split into meshlets, drawn only while one is
+};
+
+// per-draw input of the culling pass, matches CullInput in cull.slang; a draw of a meshlet carries
+// its bounding sphere and normal cone, see Meshlet, other draws a cutoff of 1 that never culls
+struct GpuCullInput {
+	glm::vec3  bounds_min;
+	uint32_t   bucket;
+	glm::vec3  bounds_max;
+	uint32_t   bucket_first;
+	glm::vec4  sphere{0.0f};                             // center, radius
+	glm::vec4  cone{0.0f, 0.0f, 0.0f, 1.0f};             // axis, cutoff
+	uint32_t   lod_draw{};                               // the GpuLodDraw of the draw it came from
+	GpuLodMode lod_mode{GpuLodMode::Whole};
+	glm::uvec2 padding{0u};
+};
+
+// what a draw's level is selected from, shared by all the commands split from it; its levels are a
+// range of the GpuLod table, the full detail first
+struct GpuLodDraw {
+	glm::vec4  sphere{0.0f};        // center, radius of the whole mesh
+	uint32_t   first_lod{};
+	uint32_t   lod_count{};
+	glm::uvec2 padding{0u};
+};
+
+// an index range of a level of detail and its error in local units, see MeshLod
+struct GpuLod {
+	uint32_t first_index{};
+	uint32_t index_count{};
+	float    error{};
+	uint32_t padding{};
+};
+
+// the frustum planes are taken from view_projection in the shader; camera_position.w is 0 for
+// projections without one, which skip the cone test and keep the full detail. lod_scale is the
+// pixels a unit covers one unit away from the camera, 0 to keep every draw at full detail, and
+// lod_parity picks the half of the selection history written this frame
+struct GpuCullConstants {
+	glm::mat4 view_projection;
+	glm::vec4 camera_position;
+	glm::vec2 pyramid_size;
+	uint32_t  draw_count;
+	uint32_t  mip_count;
+	uint32_t  occlusion;
+	float     lod_scale;
+	float     lod_threshold;
+	float     lod_hysteresis;
+	uint32_t  lod_parity;
+};
+
+// counters written by the culling pass, matches the statistics buffer in cull.slang; each command
+// lands in exactly one of the culled, drawn and lod skipped counts. The triangles are those of the
+// drawn commands' instances, at full detail and at the level they were drawn at. The CPU path fills
+// the same fields counting instances instead of commands
+struct GpuCullStatistics {
+	uint32_t frustum_culled;
+	uint32_t occlusion_culled;
+	uint32_t backface_culled;
+	uint32_t triangles_full;
+	uint32_t triangles_drawn;
+	uint32_t drawn;
+	uint32_t lod_skipped;
+};
+
+struct GpuPyramidConstants {
+	glm::uvec2 source_size;
+	glm::uvec2 target_size;
+};
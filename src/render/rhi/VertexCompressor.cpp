@@ -0,0 +1,144 @@
+#include "VertexCompressor.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include <glm/gtc/packing.hpp>
+
+namespace
+{
+constexpr float position_steps = 65535.0f;
+
+// folds the unit sphere onto an octahedron and the octahedron's lower half over the upper one's
+// square, a uniform enough spread that two snorm16 lanes keep normals within a hundredth of a degree
+glm::vec2 encodeOctahedral(const glm::vec3& normal)
+{
+	float length = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+	if (length <= 0.0f)
+		return {0.0f, 0.0f};
+
+	auto folded = glm::vec2(normal) / length;
+	if (normal.z < 0.0f) {
+		auto sign = glm::vec2(folded.x >= 0.0f ? 1.0f : -1.0f, folded.y >= 0.0f ? 1.0f : -1.0f);
+		folded = (1.0f - glm::abs(glm::vec2(folded.y, folded.x))) * sign;
+	}
+	return folded;
+}
+
+glm::vec3 decodeOctahedral(const glm::vec2& encoded)
+{
+	auto  normal = glm::vec3(encoded, 1.0f - std::abs(encoded.x) - std::abs(encoded.y));
+	float fold = std::max(-normal.z, 0.0f);
+	normal.x += normal.x >= 0.0f ? -fold : fold;
+	normal.y += normal.y >= 0.0f ? -fold : fold;
+	return glm::normalize(normal);
+}
+}        // namespace
+
+uint32_t VertexCompressor::add(std::span<const MeshVertex> mesh_vertices, const glm::vec3& min, const glm::vec3& max, bool color)
+{
+	auto  first_color = static_cast<uint32_t>(colors.size());
+	float extent = std::max({max.x - min.x, max.y - min.y, max.z - min.z});
+
+	for (const auto& vertex : mesh_vertices) {
+		auto position = encodePosition(vertex.pos, min, max);
+		auto packed = encode(vertex);
+		positions.push_back(position);
+		vertices.push_back(packed);
+
+		auto decoded = decode(packed);
+		if (extent > 0.0f)
+			statistics.max_position_error = std::max(statistics.max_position_error, glm::length(decodePosition(position, min, max) - vertex.pos) / extent);
+
+		// normals are compared by direction only, the shader normalizes them anyway
+		if (auto length = glm::length(vertex.normal); length > 0.0f) {
+			float cosine = std::clamp(glm::dot(decoded.normal, vertex.normal / length), -1.0f, 1.0f);
+			statistics.max_normal_error = std::max(statistics.max_normal_error, glm::degrees(std::acos(cosine)));
+		}
+
+		auto uv_error = glm::abs(decoded.uv - vertex.uv);
+		statistics.max_uv_error = std::max({statistics.max_uv_error, uv_error.x, uv_error.y});
+
+		if (!color)
+			continue;
+
+		auto packed_color = encodeColor(vertex.color);
+		colors.push_back(packed_color);
+
+		auto color_error = glm::abs(decodeColor(packed_color) - glm::clamp(vertex.color, 0.0f, 1.0f));
+		statistics.max_color_error = std::max({statistics.max_color_error, color_error.x, color_error.y, color_error.z, color_error.w});
+	}
+
+	auto count = static_cast<uint32_t>(mesh_vertices.size());
+	statistics.vertex_count += count;
+	statistics.colored_count += color ? count : 0;
+	statistics.bytes_before += count * sizeof(MeshVertex);
+	statistics.bytes_after += count * (sizeof(GpuPosition) + sizeof(GpuVertex) + (color ? sizeof(GpuColor) : 0));
+
+	return first_color;
+}
+
+// a flat axis has nothing to quantize and stays at min
+GpuPosition VertexCompressor::encodePosition(const glm::vec3& pos, const glm::vec3& min, const glm::vec3& max)
+{
+	auto extent = max - min;
+	auto unit = glm::vec3(0.0f);
+	for (int axis = 0; axis < 3; axis++)
+		if (extent[axis] > 0.0f)
+			unit[axis] = std::clamp((pos[axis] - min[axis]) / extent[axis], 0.0f, 1.0f);
+
+	return {glm::u16vec4(glm::round(unit * position_steps), 0)};
+}
+
+GpuVertex VertexCompressor::encode(const MeshVertex& vertex)
+{
+	return {
+	    glm::packSnorm2x16(encodeOctahedral(vertex.normal)),
+	    glm::packHalf2x16(vertex.uv),
+	};
+}
+
+GpuColor VertexCompressor::encodeColor(const glm::vec4& color)
+{
+	return {glm::packUnorm4x8(color)};
+}
+
+glm::vec3 VertexCompressor::decodePosition(const GpuPosition& position, const glm::vec3& min, const glm::vec3& max)
+{
+	return min + (max - min) * (glm::vec3(position.pos) / position_steps);
+}
+
+MeshVertex VertexCompressor::decode(const GpuVertex& vertex)
+{
+	return {
+	    glm::vec3(0.0f),
+	    decodeOctahedral(glm::unpackSnorm2x16(vertex.normal)),
+	    glm::unpackHalf2x16(vertex.uv),
+	    glm::vec4(1.0f),
+	};
+}
+
+glm::vec4 VertexCompressor::decodeColor(const GpuColor& color)
+{
+	return glm::unpackUnorm4x8(color.color);
+}
+
+const std::vector<GpuPosition>& VertexCompressor::getPositions() const
+{
+	return positions;
+}
+
+const std::vector<GpuVertex>& VertexCompressor::getVertices() const
+{
+	return vertices;
+}
+
+const std::vector<GpuColor>& VertexCompressor::getColors() const
+{
+	return colors;
+}
+
+const VertexCompressionStatistics& VertexCompressor::getStatistics() const
+{
+	return statistics;
+}
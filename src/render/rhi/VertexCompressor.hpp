@@ -0,0 +1,59 @@
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include "GpuVertex.hpp"
+
+// what compressing a scene's vertices cost, the largest error of any vertex; bytes_before counts
+// the four float32 attributes every vertex used to take, color included whether it had any
+struct VertexCompressionStatistics {
+	uint32_t vertex_count{};
+	uint32_t colored_count{};
+	uint64_t bytes_before{};
+	uint64_t bytes_after{};
+	float    max_position_error{};        // a fraction of the mesh's largest extent
+	float    max_normal_error{};          // in degrees
+	float    max_uv_error{};
+	float    max_color_error{};
+};
+
+// packs meshes' vertices into the position, attribute and color streams, measuring the error of
+// each vertex by decoding it again
+class VertexCompressor {
+private:
+	std::vector<GpuPosition> positions;
+	std::vector<GpuVertex>   vertices;
+	std::vector<GpuColor>    colors;
+
+	VertexCompressionStatistics statistics;
+
+public:
+	VertexCompressor() = default;
+
+	VertexCompressor(const VertexCompressor&) = delete;
+	VertexCompressor& operator=(const VertexCompressor&) = delete;
+
+	VertexCompressor(VertexCompressor&&) noexcept = default;
+	VertexCompressor& operator=(VertexCompressor&&) noexcept = default;
+
+	~VertexCompressor() = default;
+
+	// appends a mesh whose positions all lie within min and max, where they are quantized to; its
+	// colors only go in the color stream with color, returns where they start there
+	auto add(std::span<const MeshVertex> mesh_vertices, const glm::vec3& min, const glm::vec3& max, bool color = true) -> uint32_t;
+
+	static auto encodePosition(const glm::vec3& pos, const glm::vec3& min, const glm::vec3& max) -> GpuPosition;
+	static auto encode(const MeshVertex& vertex) -> GpuVertex;
+	static auto encodeColor(const glm::vec4& color) -> GpuColor;
+
+	// the inverses of the above, what the shaders compute; decode leaves the color white
+	static auto decodePosition(const GpuPosition& position, const glm::vec3& min, const glm::vec3& max) -> glm::vec3;
+	static auto decode(const GpuVertex& vertex) -> MeshVertex;
+	static auto decodeColor(const GpuColor& color) -> glm::vec4;
+
+	auto getPositions() const -> const std::vector<GpuPosition>&;
+	auto getVertices() const -> const std::vector<GpuVertex>&;
+	auto getColors() const -> const std::vector<GpuColor>&;
+	auto getStatistics() const -> const VertexCompressionStatistics&;
+};
@@ -0,0 +1,309 @@
+#include "MeshOptimizer.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+
+#include <glm/glm.hpp>
+
+namespace
+{
+constexpr uint32_t no_vertex = std::numeric_limits<uint32_t>::max();
+
+glm::vec3 readPosition(std::span<const uint8_t> vertices, uint32_t stride, uint32_t position_offset, uint32_t vertex)
+{
+	glm::vec3 position;
+	std::memcpy(&position, &vertices[vertex * stride + position_offset], sizeof(glm::vec3));
+	return position;
+}
+}        // namespace
+
+MeshOptimizationStatistics MeshOptimizer::optimize(std::vector<uint8_t>& vertices, uint32_t stride, std::vector<uint32_t>& indices, std::optional<uint32_t> position_offset)
+{
+	MeshOptimizationStatistics statistics{};
+	if (stride == 0)
+		return statistics;
+
+	uint32_t vertex_count = static_cast<uint32_t>(vertices.size() / stride);
+	statistics.vertices_before = vertex_count;
+	statistics.vertices_after = vertex_count;
+
+	indices.resize(indices.size() / 3 * 3);
+	auto triangle_count = static_cast<float>(indices.size() / 3);
+	if (indices.empty())
+		return statistics;
+	if (std::ranges::any_of(indices, [&](uint32_t index) { return index >= vertex_count; }))
+		throw std::runtime_error("Vertex index out of range");
+
+	auto misses = static_cast<float>(getCacheMisses(indices, vertex_count));
+	statistics.acmr_before = misses / triangle_count;
+	statistics.atvr_before = misses / static_cast<float>(vertex_count);
+
+	vertex_count = weld(vertices, stride, indices);
+	auto clusters = optimizeVertexCache(indices, vertex_count);
+	if (position_offset)
+		optimizeOverdraw(indices, clusters, vertices, stride, *position_offset);
+	optimizeVertexFetch(vertices, stride, indices);
+
+	measure(statistics, indices, static_cast<uint32_t>(vertices.size() / stride));
+
+	return statistics;
+}
+
+// compacts in place, each kept vertex only ever moving towards the front, so the map can key on
+// the bytes where they were moved to
+uint32_t MeshOptimizer::weld(std::vector<uint8_t>& vertices, uint32_t stride, std::span<uint32_t> indices)
+{
+	auto vertex_count = static_cast<uint32_t>(vertices.size() / stride);
+
+	std::unordered_map<std::string_view, uint32_t> unique_vertices;
+	unique_vertices.reserve(vertex_count);
+
+	std::vector<uint32_t> remap(vertex_count);
+	uint32_t              unique_count = 0;
+	for (uint32_t vertex = 0; vertex < vertex_count; vertex++) {
+		std::string_view bytes(reinterpret_cast<const char*>(&vertices[vertex * stride]), stride);
+		if (auto it = unique_vertices.find(bytes); it != unique_vertices.end()) {
+			remap[vertex] = it->second;
+			continue;
+		}
+
+		if (unique_count != vertex)
+			std::memmove(&vertices[unique_count * stride], &vertices[vertex * stride], stride);
+		unique_vertices.emplace(std::string_view(reinterpret_cast<const char*>(&vertices[unique_count * stride]), stride), unique_count);
+		remap[vertex] = unique_count++;
+	}
+	vertices.resize(unique_count * stride);
+
+	for (auto& index : indices)
+		index = remap[index];
+
+	return unique_count;
+}
+
+// fans around one vertex at a time, moving on to the neighbour that has been in the cache longest
+// without its remaining triangles pushing it out, or, at a dead end, to the most recently used
+// vertex that still has triangles left
+std::vector<uint32_t> MeshOptimizer::optimizeVertexCache(std::span<uint32_t> indices, uint32_t vertex_count)
+{
+	auto triangle_count = static_cast<uint32_t>(indices.size() / 3);
+
+	// the triangles around each vertex, packed one vertex after another
+	std::vector<uint32_t> live(vertex_count);
+	for (auto index : indices)
+		live[index]++;
+
+	std::vector<uint32_t> offsets(vertex_count + 1);
+	for (uint32_t vertex = 0; vertex < vertex_count; vertex++)
+		offsets[vertex + 1] = offsets[vertex] + live[vertex];
+
+	std::vector<uint32_t> adjacency(indices.size());
+	std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+	for (uint32_t index = 0; index < indices.size(); index++)
+		adjacency[fill[indices[index]]++] = index / 3;
+
+	std::vector<uint32_t> timestamps(vertex_count);
+	std::vector<bool>     emitted(triangle_count);
+	std::vector<uint32_t> dead_end;
+	std::vector<uint32_t> candidates;
+	std::vector<uint32_t> output;
+	std::vector<uint32_t> clusters;
+	output.reserve(indices.size());
+
+	uint32_t time = cache_size + 1;
+	uint32_t cursor = 0;
+
+	auto skipDeadEnd = [&]() -> uint32_t {
+		while (!dead_end.empty()) {
+			auto vertex = dead_end.back();
+			dead_end.pop_back();
+			if (live[vertex] > 0)
+				return vertex;
+		}
+		for (; cursor < vertex_count; cursor++)
+			if (live[cursor] > 0)
+				return cursor;
+		return no_vertex;
+	};
+
+	auto fanning = skipDeadEnd();
+	if (fanning != no_vertex)
+		clusters.push_back(0);
+
+	while (fanning != no_vertex) {
+		candidates.clear();
+		for (uint32_t entry = offsets[fanning]; entry < offsets[fanning + 1]; entry++) {
+			auto triangle = adjacency[entry];
+			if (emitted[triangle])
+				continue;
+
+			for (uint32_t corner = 0; corner < 3; corner++) {
+				auto vertex = indices[triangle * 3 + corner];
+				output.push_back(vertex);
+				dead_end.push_back(vertex);
+				candidates.push_back(vertex);
+				live[vertex]--;
+				if (time - timestamps[vertex] > cache_size)
+					timestamps[vertex] = time++;
+			}
+			emitted[triangle] = true;
+		}
+
+		uint32_t next = no_vertex;
+		int64_t  best = -1;
+		for (auto vertex : candidates) {
+			if (live[vertex] == 0)
+				continue;
+
+			int64_t priority = 0;
+			if (time - timestamps[vertex] + 2 * live[vertex] <= cache_size)
+				priority = time - timestamps[vertex];
+			if (priority > best) {
+				best = priority;
+				next = vertex;
+			}
+		}
+
+		if (next == no_vertex) {
+			next = skipDeadEnd();
+			if (next != no_vertex && clusters.back() != output.size() / 3)
+				clusters.push_back(static_cast<uint32_t>(output.size() / 3));
+		}
+		fanning = next;
+	}
+
+	std::copy(output.begin(), output.end(), indices.begin());
+	return clusters;
+}
+
+void MeshOptimizer::optimizeOverdraw(std::span<uint32_t> indices, std::span<const uint32_t> clusters, std::span<const uint8_t> vertices, uint32_t stride, uint32_t position_offset)
+{
+	auto triangle_count = static_cast<uint32_t>(indices.size() / 3);
+	auto vertex_count = static_cast<uint32_t>(vertices.size() / stride);
+	if (clusters.empty() || triangle_count == 0)
+		return;
+
+	// splitting where the cache has seen a full turnover since the last split costs at most one
+	// refill, and is only done once the cluster so far is about as cache friendly as the whole mesh
+	float threshold = overdraw_threshold * static_cast<float>(getCacheMisses(indices, vertex_count)) / static_cast<float>(triangle_count);
+
+	std::vector<uint32_t> starts;
+	std::vector<uint32_t> timestamps(vertex_count);
+	uint32_t              time = cache_size + 1;
+	uint32_t              misses = 0;
+	size_t                next_cluster = 0;
+	for (uint32_t triangle = 0; triangle < triangle_count; triangle++) {
+		bool hard = next_cluster < clusters.size() && clusters[next_cluster] == triangle;
+		bool soft = misses >= cache_size && static_cast<float>(misses) <= threshold * static_cast<float>(triangle - starts.back());
+		if (hard || soft) {
+			starts.push_back(triangle);
+			misses = 0;
+		}
+		if (hard)
+			next_cluster++;
+
+		for (uint32_t corner = 0; corner < 3; corner++) {
+			auto vertex = indices[triangle * 3 + corner];
+			if (time - timestamps[vertex] > cache_size) {
+				timestamps[vertex] = time++;
+				misses++;
+			}
+		}
+	}
+	starts.push_back(triangle_count);
+
+	// area weighted, the cross product's length being twice the triangle's area
+	auto cluster_count = starts.size() - 1;
+	std::vector<glm::vec3> centroids(cluster_count, glm::vec3(0.0f));
+	std::vector<glm::vec3> normals(cluster_count, glm::vec3(0.0f));
+	std::vector<float>     areas(cluster_count);
+	glm::vec3              mesh_centroid(0.0f);
+	float                  mesh_area = 0.0f;
+	for (size_t cluster = 0; cluster < cluster_count; cluster++) {
+		for (uint32_t triangle = starts[cluster]; triangle < starts[cluster + 1]; triangle++) {
+			auto a = readPosition(vertices, stride, position_offset, indices[triangle * 3 + 0]);
+			auto b = readPosition(vertices, stride, position_offset, indices[triangle * 3 + 1]);
+			auto c = readPosition(vertices, stride, position_offset, indices[triangle * 3 + 2]);
+
+			auto  normal = glm::cross(b - a, c - a);
+			float area = glm::length(normal);
+			centroids[cluster] += (a + b + c) * (area / 3.0f);
+			normals[cluster] += normal;
+			areas[cluster] += area;
+		}
+		mesh_centroid += centroids[cluster];
+		mesh_area += areas[cluster];
+	}
+	if (mesh_area <= 0.0f)
+		return;
+	mesh_centroid /= mesh_area;
+
+	std::vector<float> sort_keys(cluster_count);
+	for (size_t cluster = 0; cluster < cluster_count; cluster++) {
+		float length = glm::length(normals[cluster]);
+		if (areas[cluster] > 0.0f && length > 0.0f)
+			sort_keys[cluster] = glm::dot(centroids[cluster] / areas[cluster] - mesh_centroid, normals[cluster] / length);
+	}
+
+	std::vector<uint32_t> order(cluster_count);
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(), [&](uint32_t lhs, uint32_t rhs) {
+		return sort_keys[lhs] > sort_keys[rhs];
+	});
+
+	std::vector<uint32_t> sorted;
+	sorted.reserve(indices.size());
+	for (auto cluster : order)
+		sorted.insert(sorted.end(), indices.begin() + starts[cluster] * 3, indices.begin() + starts[cluster + 1] * 3);
+	std::copy(sorted.begin(), sorted.end(), indices.begin());
+}
+
+void MeshOptimizer::optimizeVertexFetch(std::vector<uint8_t>& vertices, uint32_t stride, std::span<uint32_t> indices)
+{
+	auto vertex_count = static_cast<uint32_t>(vertices.size() / stride);
+
+	std::vector<uint32_t> remap(vertex_count, no_vertex);
+	std::vector<uint8_t>  reordered;
+	reordered.reserve(vertices.size());
+
+	uint32_t used = 0;
+	for (auto& index : indices) {
+		if (remap[index] == no_vertex) {
+			remap[index] = used++;
+			reordered.insert(reordered.end(), vertices.begin() + index * stride, vertices.begin() + (index + 1) * stride);
+		}
+		index = remap[index];
+	}
+
+	vertices = std::move(reordered);
+}
+
+void MeshOptimizer::measure(MeshOptimizationStatistics& statistics, std::span<const uint32_t> indices, uint32_t vertex_count)
+{
+	if (indices.empty() || vertex_count == 0)
+		return;
+
+	auto misses = static_cast<float>(getCacheMisses(indices, vertex_count));
+	statistics.vertices_after = vertex_count;
+	statistics.acmr_after = misses / static_cast<float>(indices.size() / 3);
+	statistics.atvr_after = misses / static_cast<float>(vertex_count);
+}
+
+uint32_t MeshOptimizer::getCacheMisses(std::span<const uint32_t> indices, uint32_t vertex_count)
+{
+	// a vertex is still cached while fewer than cache_size others went in after it
+	std::vector<uint32_t> timestamps(vertex_count);
+	uint32_t              time = cache_size + 1;
+	uint32_t              misses = 0;
+	for (auto index : indices) {
+		if (time - timestamps[index] > cache_size) {
+			timestamps[index] = time++;
+			misses++;
+		}
+	}
+	return misses;
+}
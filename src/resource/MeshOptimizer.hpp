@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+// what optimizing a submesh changed; ACMR counts the vertices transformed per triangle and ATVR per
+// vertex, both through a FIFO post-transform cache of MeshOptimizer::cache_size entries
+struct MeshOptimizationStatistics {
+	uint32_t vertices_before{};
+	uint32_t vertices_after{};
+	float    acmr_before{};
+	float    acmr_after{};
+	float    atvr_before{};
+	float    atvr_after{};
+};
+
+// import time reordering of indexed triangle lists over interleaved vertices of any layout; the
+// steps are public for meshes built elsewhere but only make sense in the order optimize() runs them
+class MeshOptimizer {
+public:
+	static constexpr uint32_t cache_size = 16;
+
+	// how much worse than the whole mesh's ACMR a cluster may get for overdraw's sake
+	static constexpr float overdraw_threshold = 1.05f;
+
+	// welds, reorders and compacts the vertices in place; without a position offset the triangles
+	// keep the cache order, there being nothing to sort them for overdraw by
+	static auto optimize(std::vector<uint8_t>& vertices, uint32_t stride, std::vector<uint32_t>& indices, std::optional<uint32_t> position_offset = {}) -> MeshOptimizationStatistics;
+
+	// merges bitwise identical vertices, returns how many are left
+	static auto weld(std::vector<uint8_t>& vertices, uint32_t stride, std::span<uint32_t> indices) -> uint32_t;
+
+	// Tipsify (Sander et al.), returns the first triangle of each run it had to restart elsewhere
+	static auto optimizeVertexCache(std::span<uint32_t> indices, uint32_t vertex_count) -> std::vector<uint32_t>;
+
+	// splits those runs where the cache has turned over anyway and draws the outward facing clusters
+	// at the mesh's rim first, as they tend to hide the rest
+	static void optimizeOverdraw(std::span<uint32_t> indices, std::span<const uint32_t> clusters, std::span<const uint8_t> vertices, uint32_t stride, uint32_t position_offset);
+
+	// renumbers the vertices in the order the triangles first use them, dropping those none does
+	static void optimizeVertexFetch(std::vector<uint8_t>& vertices, uint32_t stride, std::span<uint32_t> indices);
+
+	static auto getCacheMisses(std::span<const uint32_t> indices, uint32_t vertex_count) -> uint32_t;
+
+	// fills in the after fields, again when something reordered the triangles since
+	static void measure(MeshOptimizationStatistics& statistics, std::span<const uint32_t> indices, uint32_t vertex_count);
+};
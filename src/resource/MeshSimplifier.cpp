@@ -0,0 +1,150 @@
+#include "MeshSimplifier.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+
+#include "MeshOptimizer.hpp"
+
+namespace
+{
+constexpr uint32_t none = std::numeric_limits<uint32_t>::max();
+constexpr uint32_t cell_bits = 21;
+
+uint64_t cellKey(const glm::vec3& position, const glm::vec3& origin, float cell_size)
+{
+	constexpr auto last = static_cast<float>((1u << cell_bits) - 1);
+	auto           cell = glm::clamp(glm::floor((position - origin) / cell_size), glm::vec3(0.0f), glm::vec3(last));
+	return static_cast<uint64_t>(cell.x) | static_cast<uint64_t>(cell.y) << cell_bits | static_cast<uint64_t>(cell.z) << (cell_bits * 2);
+}
+}        // namespace
+
+std::vector<MeshLod> MeshSimplifier::buildLods(std::span<const glm::vec3> positions, std::span<const uint32_t> indices, std::vector<uint32_t>& lod_indices)
+{
+	std::vector<MeshLod> lods;
+	if (indices.size() < 3)
+		return lods;
+
+	auto bounds_min = positions[indices.front()];
+	auto bounds_max = bounds_min;
+	for (auto index : indices) {
+		bounds_min = glm::min(bounds_min, positions[index]);
+		bounds_max = glm::max(bounds_max, positions[index]);
+	}
+	auto  size = bounds_max - bounds_min;
+	float extent = std::max({size.x, size.y, size.z});
+	if (extent <= 0.0f)
+		return lods;
+
+	auto                  previous_triangles = indices.size() / 3;
+	float                 previous_error = 0.0f;
+	std::vector<uint32_t> level;
+	for (uint32_t lod = 0; lod < max_levels; lod++) {
+		auto target = static_cast<size_t>(static_cast<float>(previous_triangles) * reduction);
+		if (target < min_triangles)
+			break;
+
+		// the finest grid that gets down to the target; coarser grids leave fewer triangles, nearly
+		// always, which is all a binary search needs to land close
+		uint32_t resolution = 0;
+		uint32_t low = 1;
+		uint32_t high = max_resolution;
+		while (low <= high) {
+			uint32_t middle = low + (high - low) / 2;
+			level.clear();
+			simplify(positions, indices, extent / static_cast<float>(middle), level);
+			if (level.size() / 3 <= target) {
+				resolution = middle;
+				low = middle + 1;
+			} else {
+				high = middle - 1;
+			}
+		}
+
+		level.clear();
+		float error = resolution ? simplify(positions, indices, extent / static_cast<float>(resolution), level) : 0.0f;
+		if (level.empty())
+			break;
+
+		MeshOptimizer::optimizeVertexCache(level, static_cast<uint32_t>(positions.size()));
+
+		// every level is simplified from the full detail, so a coarser one may measure a hair better
+		previous_error = std::max(error, previous_error);
+		lods.push_back({static_cast<uint32_t>(lod_indices.size()), static_cast<uint32_t>(level.size()), previous_error});
+		lod_indices.insert(lod_indices.end(), level.begin(), level.end());
+		previous_triangles = level.size() / 3;
+	}
+
+	return lods;
+}
+
+// the vertex a cell keeps is the one nearest the mean of those in it, so it stays on the surface
+float MeshSimplifier::simplify(std::span<const glm::vec3> positions, std::span<const uint32_t> indices, float cell_size, std::vector<uint32_t>& output)
+{
+	auto origin = positions[indices.front()];
+	for (auto index : indices)
+		origin = glm::min(origin, positions[index]);
+
+	std::unordered_map<uint64_t, uint32_t> cells;
+	std::vector<uint32_t>                  vertex_cells(positions.size(), none);
+	std::vector<glm::vec3>                 sums;
+	std::vector<uint32_t>                  counts;
+	for (auto index : indices) {
+		if (vertex_cells[index] != none)
+			continue;
+
+		auto [it, inserted] = cells.try_emplace(cellKey(positions[index], origin, cell_size), static_cast<uint32_t>(sums.size()));
+		if (inserted) {
+			sums.emplace_back(0.0f);
+			counts.push_back(0);
+		}
+		vertex_cells[index] = it->second;
+		sums[it->second] += positions[index];
+		counts[it->second]++;
+	}
+
+	std::vector<uint32_t> representatives(sums.size(), none);
+	std::vector<float>    distances(sums.size(), std::numeric_limits<float>::max());
+	for (uint32_t vertex = 0; vertex < positions.size(); vertex++) {
+		auto cell = vertex_cells[vertex];
+		if (cell == none)
+			continue;
+
+		auto  mean = sums[cell] / static_cast<float>(counts[cell]);
+		auto  offset = positions[vertex] - mean;
+		float distance = glm::dot(offset, offset);
+		if (distance < distances[cell]) {
+			distances[cell] = distance;
+			representatives[cell] = vertex;
+		}
+	}
+
+	float error = 0.0f;
+	for (uint32_t vertex = 0; vertex < positions.size(); vertex++)
+		if (vertex_cells[vertex] != none)
+			error = std::max(error, glm::length(positions[vertex] - positions[representatives[vertex_cells[vertex]]]));
+
+	// rotated to start at the smallest index, which keeps the winding, so duplicates sort together
+	std::vector<std::array<uint32_t, 3>> triangles;
+	triangles.reserve(indices.size() / 3);
+	for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+		std::array<uint32_t, 3> triangle;
+		for (uint32_t corner = 0; corner < 3; corner++)
+			triangle[corner] = representatives[vertex_cells[indices[i + corner]]];
+		if (triangle[0] == triangle[1] || triangle[1] == triangle[2] || triangle[0] == triangle[2])
+			continue;
+
+		std::ranges::rotate(triangle, std::ranges::min_element(triangle));
+		triangles.push_back(triangle);
+	}
+	std::ranges::sort(triangles);
+	auto duplicates = std::ranges::unique(triangles);
+	triangles.erase(duplicates.begin(), duplicates.end());
+
+	for (const auto& triangle : triangles)
+		output.insert(output.end(), triangle.begin(), triangle.end());
+
+	return error;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "scene/components/SubMesh.hpp"
+
+// import time levels of detail by vertex clustering: every vertex snaps to one of the vertices in
+// its cell of a uniform grid, and the triangles that collapse go. Coarse, but it needs no new
+// vertices, so every level indexes the submesh's own
+class MeshSimplifier {
+public:
+	static constexpr uint32_t max_levels = 4;
+
+	// the triangles each level aims for, relative to the one before it
+	static constexpr float reduction = 0.5f;
+
+	// meshes this small gain nothing from another draw's worth of indices
+	static constexpr uint32_t min_triangles = 64;
+
+	// the finest grid tried, in cells along the longest side of the bounds
+	static constexpr uint32_t max_resolution = 4096;
+
+	// the levels after the full detail one, their indices appended to lod_indices
+	static auto buildLods(std::span<const glm::vec3> positions, std::span<const uint32_t> indices, std::vector<uint32_t>& lod_indices) -> std::vector<MeshLod>;
+
+	// clusters with cells cell_size wide, appends what is left of the triangles to output and returns
+	// how far the farthest vertex moved
+	static auto simplify(std::span<const glm::vec3> positions, std::span<const uint32_t> indices, float cell_size, std::vector<uint32_t>& output) -> float;
+};
@@ -0,0 +1,173 @@
+#include "MeshletBuilder.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+constexpr uint32_t none = std::numeric_limits<uint32_t>::max();
+}        // namespace
+
+std::vector<Meshlet> MeshletBuilder::build(std::span<const glm::vec3> positions, std::span<uint32_t> indices)
+{
+	auto triangle_count = static_cast<uint32_t>(indices.size() / 3);
+	auto vertex_count = static_cast<uint32_t>(positions.size());
+
+	// the triangles around each vertex, packed one vertex after another
+	std::vector<uint32_t> offsets(vertex_count + 1);
+	for (uint32_t index = 0; index < triangle_count * 3; index++)
+		offsets[indices[index] + 1]++;
+	for (uint32_t vertex = 0; vertex < vertex_count; vertex++)
+		offsets[vertex + 1] += offsets[vertex];
+
+	std::vector<uint32_t> adjacency(triangle_count * 3);
+	std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+	for (uint32_t index = 0; index < triangle_count * 3; index++)
+		adjacency[fill[indices[index]]++] = index / 3;
+
+	// which meshlet last took each vertex, so counting a triangle's new vertices needs no set
+	std::vector<uint32_t> owner(vertex_count, none);
+	std::vector<bool>     emitted(triangle_count);
+	std::vector<uint32_t> candidates;
+	std::vector<uint32_t> output;
+	std::vector<Meshlet>  meshlets;
+	output.reserve(triangle_count * 3);
+
+	uint32_t cursor = 0;
+	uint32_t meshlet_vertices = 0;
+	uint32_t meshlet_triangles = 0;
+	auto     meshlet_id = static_cast<uint32_t>(meshlets.size());
+
+	auto new_vertices = [&](uint32_t triangle) {
+		uint32_t count = 0;
+		for (uint32_t corner = 0; corner < 3; corner++) {
+			auto vertex = indices[triangle * 3 + corner];
+			// a degenerate triangle names one vertex twice but adds it once
+			bool repeated = (corner > 0 && vertex == indices[triangle * 3]) || (corner > 1 && vertex == indices[triangle * 3 + 1]);
+			if (owner[vertex] != meshlet_id && !repeated)
+				count++;
+		}
+		return count;
+	};
+
+	auto close = [&]() {
+		if (meshlet_triangles == 0)
+			return;
+
+		auto first_index = static_cast<uint32_t>(output.size()) - meshlet_triangles * 3;
+		auto meshlet = computeBounds(positions, std::span(output).subspan(first_index));
+		meshlet.first_index = first_index;
+		meshlet.index_count = meshlet_triangles * 3;
+		meshlet.vertex_count = meshlet_vertices;
+		meshlets.push_back(meshlet);
+
+		meshlet_id = static_cast<uint32_t>(meshlets.size());
+		meshlet_vertices = 0;
+		meshlet_triangles = 0;
+		candidates.clear();
+	};
+
+	auto add = [&](uint32_t triangle) {
+		meshlet_vertices += new_vertices(triangle);
+		meshlet_triangles++;
+		emitted[triangle] = true;
+
+		for (uint32_t corner = 0; corner < 3; corner++) {
+			auto vertex = indices[triangle * 3 + corner];
+			output.push_back(vertex);
+			if (owner[vertex] == meshlet_id)
+				continue;
+
+			owner[vertex] = meshlet_id;
+			for (uint32_t entry = offsets[vertex]; entry < offsets[vertex + 1]; entry++)
+				if (!emitted[adjacency[entry]])
+					candidates.push_back(adjacency[entry]);
+		}
+	};
+
+	while (true) {
+		// the neighbour adding the fewest vertices, the first one found on ties
+		uint32_t best = none;
+		uint32_t best_cost = std::numeric_limits<uint32_t>::max();
+		if (meshlet_triangles < max_triangles) {
+			std::erase_if(candidates, [&](uint32_t triangle) { return emitted[triangle]; });
+			for (auto triangle : candidates) {
+				auto cost = new_vertices(triangle);
+				if (cost < best_cost && meshlet_vertices + cost <= max_vertices) {
+					best = triangle;
+					best_cost = cost;
+					if (cost == 0)
+						break;
+				}
+			}
+		}
+
+		// without a neighbour that fits, the next triangle in the optimized order fills the meshlet
+		// up if it can, those lie close to the last ones
+		if (best == none) {
+			while (cursor < triangle_count && emitted[cursor])
+				cursor++;
+			if (cursor == triangle_count)
+				break;
+
+			if (meshlet_triangles == max_triangles || meshlet_vertices + new_vertices(cursor) > max_vertices)
+				close();
+			best = cursor;
+		}
+
+		add(best);
+	}
+	close();
+
+	std::copy(output.begin(), output.end(), indices.begin());
+
+	return meshlets;
+}
+
+// the sphere is centered on the box, the cone's axis is the mean of the triangles' unit normals
+Meshlet MeshletBuilder::computeBounds(std::span<const glm::vec3> positions, std::span<const uint32_t> indices)
+{
+	Meshlet meshlet{};
+	if (indices.empty())
+		return meshlet;
+
+	meshlet.bounds_min = meshlet.bounds_max = positions[indices.front()];
+	for (auto index : indices) {
+		meshlet.bounds_min = glm::min(meshlet.bounds_min, positions[index]);
+		meshlet.bounds_max = glm::max(meshlet.bounds_max, positions[index]);
+	}
+
+	meshlet.center = (meshlet.bounds_min + meshlet.bounds_max) * 0.5f;
+	for (auto index : indices)
+		meshlet.radius = std::max(meshlet.radius, glm::length(positions[index] - meshlet.center));
+
+	std::vector<glm::vec3> normals;
+	normals.reserve(indices.size() / 3);
+	for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+		auto normal = glm::cross(positions[indices[i + 1]] - positions[indices[i]], positions[indices[i + 2]] - positions[indices[i]]);
+		if (float length = glm::length(normal); length > 0.0f)
+			normals.push_back(normal / length);
+	}
+
+	auto axis = glm::vec3(0.0f);
+	for (const auto& normal : normals)
+		axis += normal;
+
+	float axis_length = glm::length(axis);
+	if (axis_length <= 0.0f)
+		return meshlet;
+	meshlet.cone_axis = axis / axis_length;
+
+	float min_dot = 1.0f;
+	for (const auto& normal : normals)
+		min_dot = std::min(min_dot, glm::dot(normal, meshlet.cone_axis));
+
+	// every normal lies within acos(min_dot) of the axis, all of them face away once the view
+	// direction is within 90 degrees minus that of the axis
+	min_dot -= cone_margin;
+	if (min_dot > 0.0f)
+		meshlet.cone_cutoff = std::sqrt(1.0f - min_dot * min_dot);
+
+	return meshlet;
+}
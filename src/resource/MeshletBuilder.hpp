@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "scene/components/SubMesh.hpp"
+
+// splits indexed triangle lists into meshlets small enough to cull one by one, the limits those of
+// a mesh shader workgroup even though they are drawn as plain index ranges
+class MeshletBuilder {
+public:
+	static constexpr uint32_t max_vertices = 64;
+	static constexpr uint32_t max_triangles = 124;
+
+	// how much wider than its triangles' normals a cone is made, for the positions' quantization
+	static constexpr float cone_margin = 0.02f;
+
+	// grows each meshlet from the triangles next to it that add the fewest vertices, and reorders
+	// the indices so every meshlet's triangles are contiguous
+	static auto build(std::span<const glm::vec3> positions, std::span<uint32_t> indices) -> std::vector<Meshlet>;
+
+	// the bounds and normal cone of a range of triangles
+	static auto computeBounds(std::span<const glm::vec3> positions, std::span<const uint32_t> indices) -> Meshlet;
+};
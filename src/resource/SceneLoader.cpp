@@ -4,11 +4,17 @@
 
 #include "SceneLoader.hpp"
 
+#include <numeric>
+#include <optional>
 #include <queue>
 #include <print>
 #include <stdexcept>
 
-std::unique_ptr<Scene> SceneLoader::loadScene(std::string_view file_path)
+#include "MeshOptimizer.hpp"
+#include "MeshletBuilder.hpp"
+#include "MeshSimplifier.hpp"
+
+std::unique_ptr<Scene> SceneLoader::loadScene(std::string_view file_path, const SceneLoadOptions& options)
 {
 	// Load Scene
 	tinygltf::Model    model;
@@ -42,7 +48,9 @@ std::unique_ptr<Scene> SceneLoader::loadScene(std::string_view file_path)
 	for (const auto& tfmesh : model.meshes) {
 		auto mesh = parseMesh(tfmesh);
 		for (auto index = 0; index < tfmesh.primitives.size(); index++) {
-			auto submesh = parseSubmesh(tfmesh, model, index);
+			auto submesh = parseSubmesh(tfmesh, model, index, options);
+			if (const auto& bounds = submesh->getBounds(); !bounds.isEmpty())
+				mesh->updateBounds({bounds.getMin(), bounds.getMax()});
 			mesh->addSubmesh(*submesh);
 			scene->addComponent(std::move(submesh));
 		}
@@ -188,6 +196,10 @@ std::unique_ptr<Node> SceneLoader::parseNode(const tinygltf::Node& tfnode, size_
 		    matrix[8], matrix[9], matrix[10], matrix[11],
 		    matrix[12], matrix[13], matrix[14], matrix[15]));
 
+	// marked in the node's extras: "extras": {"occluder": true}
+	if (const auto& occluder = tfnode.extras.Get("occluder"); occluder.IsBool())
+		node->setOccluder(occluder.Get<bool>());
+
 	return node;
 }
 
@@ -198,7 +210,7 @@ std::unique_ptr<Mesh> SceneLoader::parseMesh(const tinygltf::Mesh& tfmesh)
 	return mesh;
 }
 
-std::unique_ptr<SubMesh> SceneLoader::parseSubmesh(const tinygltf::Mesh& tfmesh, const tinygltf::Model& model, uint32_t index)
+std::unique_ptr<SubMesh> SceneLoader::parseSubmesh(const tinygltf::Mesh& tfmesh, const tinygltf::Model& model, uint32_t index, const SceneLoadOptions& options)
 {
 	auto submesh = std::make_unique<SubMesh>(std::format("{}_Primitive_{}", tfmesh.name, index));
 
@@ -256,31 +268,89 @@ std::unique_ptr<SubMesh> SceneLoader::parseSubmesh(const tinygltf::Mesh& tfmesh,
 		}
 	}
 
-	std::vector<float> vertices_data(vertices_raw_data.size() / sizeof(float));
-	std::memcpy(vertices_data.data(), vertices_raw_data.data(), vertices_raw_data.size());
-	submesh->setVertices(std::move(vertices_data), vertex_count);
-
 	// Load Indices
+	std::vector<uint32_t> indices;
+	std::vector<Meshlet>  meshlet_data;
+	std::vector<MeshLod>  lod_data;
+	std::vector<uint32_t> lod_indices;
 	if (tfprimitive.indices >= 0) {
 		auto indices_raw_data = getAttributeDataView(model, tfprimitive.indices);
 		auto index_byte_size = getAttributeSize(&model, tfprimitive.indices);
 
-		std::vector<uint32_t> indices_data;
 		switch (index_byte_size) {
 		case 1:
-			indices_data = convertData<uint8_t, uint32_t>(indices_raw_data);
+			indices = convertData<uint8_t, uint32_t>(indices_raw_data);
 			break;
 		case 2:
-			indices_data = convertData<uint16_t, uint32_t>(indices_raw_data);
+			indices = convertData<uint16_t, uint32_t>(indices_raw_data);
 			break;
 		case 4:
-			indices_data = convertData<uint32_t, uint32_t>(indices_raw_data);
+			indices = convertData<uint32_t, uint32_t>(indices_raw_data);
 			break;
 		default:
 			throw std::runtime_error("Unsupported index byte size");
 		}
+	}
+
+	// Optimize, unindexed triangle lists come out indexed once their corners are welded
+	if (tfprimitive.mode == TINYGLTF_MODE_TRIANGLES && vertex_count > 0 && vertex_stride > 0) {
+		if (tfprimitive.indices < 0) {
+			indices.resize(vertex_count);
+			std::iota(indices.begin(), indices.end(), 0);
+		}
+
+		std::optional<uint32_t> position_offset;
+		if (const auto* position = submesh->getAttribute("POSITION"))
+			position_offset = position->offset;
+
+		auto statistics = MeshOptimizer::optimize(vertices_raw_data, vertex_stride, indices, position_offset);
+		vertex_count = statistics.vertices_after;
+
+		auto read_positions = [&]() {
+			std::vector<glm::vec3> positions(vertex_count);
+			for (uint32_t vertex_index = 0; vertex_index < vertex_count; vertex_index++)
+				std::memcpy(&positions[vertex_index], &vertices_raw_data[vertex_index * vertex_stride + *position_offset], sizeof(glm::vec3));
+			return positions;
+		};
+
+		// meshlets reorder the triangles again, the vertices follow them into first-use order
+		if (options.meshlets && position_offset) {
+			meshlet_data = MeshletBuilder::build(read_positions(), indices);
+			MeshOptimizer::optimizeVertexFetch(vertices_raw_data, vertex_stride, indices);
+			MeshOptimizer::measure(statistics, indices, vertex_count);
+		}
+
+		// last, as the levels index the vertices where they finally are
+		if (options.lods && position_offset) {
+			lod_data = MeshSimplifier::buildLods(read_positions(), indices, lod_indices);
+			for (const auto& lod : lod_data)
+				std::println("LOD of {}: triangles {} -> {}, error {:.4f}", submesh->getName(), indices.size() / 3, lod.index_count / 3, lod.error);
+		}
+
+		std::println("Optimized {}: vertices {} -> {}, ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}",
+		             submesh->getName(),
+		             statistics.vertices_before, statistics.vertices_after,
+		             statistics.acmr_before, statistics.acmr_after,
+		             statistics.atvr_before, statistics.atvr_after);
+	}
+
+	std::vector<float> vertices_data(vertices_raw_data.size() / sizeof(float));
+	std::memcpy(vertices_data.data(), vertices_raw_data.data(), vertices_raw_data.size());
+	submesh->setVertices(std::move(vertices_data), vertex_count);
+
+	// kept at the narrowest width that holds them
+	if (!indices.empty())
+		submesh->setIndices(std::span<const uint32_t>(indices));
+	submesh->setMeshlets(std::move(meshlet_data));
+	submesh->setLods(std::move(lod_data), std::move(lod_indices));
+
+	// Compute Bounds
+	if (const auto* position = submesh->getAttribute("POSITION")) {
+		std::vector<glm::vec3> positions(vertex_count);
+		for (uint32_t vertex_index = 0; vertex_index < vertex_count; vertex_index++)
+			std::memcpy(&positions[vertex_index], &vertices_raw_data[vertex_index * vertex_stride + position->offset], sizeof(glm::vec3));
 
-		submesh->setIndices(std::move(indices_data));
+		submesh->updateBounds(positions, submesh->getIndices());
 	}
 
 	return submesh;
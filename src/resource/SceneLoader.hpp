@@ -13,6 +13,12 @@
 #include "scene/components/Material.hpp"
 #include "scene/components/Light.hpp"
 
+// the import time work beyond optimizing, for every triangle primitive
+struct SceneLoadOptions {
+	bool meshlets{false};        // see MeshletBuilder
+	bool lods{false};            // see MeshSimplifier
+};
+
 class SceneLoader {
 	template <typename S, typename D>
 	static std::vector<D> convertData(std::span<const uint8_t> data);
@@ -26,12 +32,12 @@ class SceneLoader {
 	static int      getAttributeFormat(const tinygltf::Model* model, uint32_t accessor_id);
 
 public:
-	static std::unique_ptr<Scene>   loadScene(std::string_view file_path);
+	static std::unique_ptr<Scene>   loadScene(std::string_view file_path, const SceneLoadOptions& options = {});
 	static std::unique_ptr<SubMesh> loadModel(const tinygltf::Model& tfmodel, uint32_t index);
 
 	static std::unique_ptr<Node>     parseNode(const tinygltf::Node& tfnode, size_t index);
 	static std::unique_ptr<Mesh>     parseMesh(const tinygltf::Mesh& tfmesh);
-	static std::unique_ptr<SubMesh>  parseSubmesh(const tinygltf::Mesh& tfmesh, const tinygltf::Model& model, uint32_t index);
+	static std::unique_ptr<SubMesh>  parseSubmesh(const tinygltf::Mesh& tfmesh, const tinygltf::Model& model, uint32_t index, const SceneLoadOptions& options = {});
 	static std::unique_ptr<Camera>   parseCamera(const tinygltf::Camera& tfcamera);
 	static std::unique_ptr<Light>    parseLight(const tinygltf::Light& tflight);
 	static std::unique_ptr<Material> parseMaterial(const tinygltf::Material& tfmaterial);
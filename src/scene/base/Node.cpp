@@ -44,6 +44,16 @@ Transform& Node::getTransform()
 	return transform;
 }
 
+bool Node::isOccluder() const
+{
+	return occluder;
+}
+
+void Node::setOccluder(bool occluder)
+{
+	this->occluder = occluder;
+}
+
 Component& Node::getComponent(std::type_index type) const
 {
 	return *components.at(type);
@@ -14,6 +14,7 @@ private:
 	std::string name;
 	Node*       parent{};
 	Transform   transform;
+	bool        occluder{};
 
 	std::vector<Node*> children;
 
@@ -43,6 +44,10 @@ public:
 
 	Transform& getTransform();
 
+	// marked to hide what lies behind it whenever the renderer culls occlusion on the CPU
+	bool isOccluder() const;
+	void setOccluder(bool occluder);
+
 	template <typename T>
 	T&         getComponent() const;
 	Component& getComponent(std::type_index type) const;
@@ -1,7 +1,10 @@
 #include "Scene.hpp"
 
+#include <array>
 #include <queue>
 
+#include "scene/components/Mesh.hpp"
+
 Scene::Scene(std::string name) :
     name(std::move(name))
 {}
@@ -152,8 +155,85 @@ Node* Scene::findNode(const std::string& name)
 	return nullptr;
 }
 
+bool Scene::isDynamic(const Node& node)
+{
+	for (const auto* current = &node; current; current = current->getParent())
+		if (!current->getBehaviours().empty())
+			return true;
+
+	return false;
+}
+
+const BVH& Scene::getStaticIndex() const
+{
+	return static_index;
+}
+
+const LooseOctree& Scene::getDynamicIndex() const
+{
+	return dynamic_index;
+}
+
+std::optional<SceneHit> Scene::raycast(const glm::vec3& origin, const glm::vec3& direction, float max_distance) const
+{
+	struct Candidate {
+		const SpatialIndex* index{};
+		SpatialHit          hit;
+	};
+
+	std::array<const SpatialIndex*, 2> indices = {&static_index, &dynamic_index};
+
+	std::vector<Candidate>  candidates;
+	std::vector<SpatialHit> hits;
+	for (const auto* index : indices) {
+		hits.clear();
+		index->queryRay(origin, direction, max_distance, hits);
+		for (const auto& hit : hits)
+			candidates.push_back({index, hit});
+	}
+
+	std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+		return a.hit.distance < b.hit.distance;
+	});
+
+	std::optional<SceneHit> closest;
+	float                   limit = max_distance;
+
+	for (const auto& candidate : candidates) {
+		// every remaining box starts past the nearest triangle found so far
+		if (candidate.hit.distance > limit)
+			break;
+
+		const auto& instance = candidate.index->getInstance(candidate.hit.instance);
+
+		// an affine inverse keeps the parameter along the ray, so local distances are world ones
+		auto inverse = glm::inverse(instance.node->getTransform().getWorldMatrix());
+		auto local_origin = glm::vec3(inverse * glm::vec4(origin, 1.0f));
+		auto local_direction = glm::vec3(inverse * glm::vec4(direction, 0.0f));
+
+		for (const auto* submesh : instance.mesh->getSubmeshes()) {
+			auto hit = submesh->getTriangleBvh().raycast(local_origin, local_direction, limit);
+			if (!hit)
+				continue;
+
+			limit = hit->distance;
+			closest = SceneHit{instance.node, submesh, hit->triangle, hit->distance, origin + direction * hit->distance};
+		}
+	}
+
+	return closest;
+}
+
 void Scene::start()
 {
+	std::vector<SpatialIndex::Instance> static_instances;
+	std::vector<SpatialIndex::Instance> dynamic_instances;
+	for (const auto& instance : SpatialIndex::collectInstances(*this))
+		(isDynamic(*instance.node) ? dynamic_instances : static_instances).push_back(instance);
+
+	static_index.build(std::move(static_instances));
+	dynamic_index.build(std::move(dynamic_instances));
+
 	for (auto& behaviour : behaviours) {
 		if (!behaviour->isStarted() && behaviour->isEnabled()) {
 			behaviour->start();
@@ -173,4 +253,8 @@ void Scene::update(float dt)
 			behaviour->update(dt);
 		}
 	}
+
+	if (static_index.update() > 0 && static_index.isDegraded())
+		static_index.rebuild();
+	dynamic_index.update();
 }
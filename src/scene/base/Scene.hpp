@@ -1,12 +1,25 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 #include <typeindex>
 #include <algorithm>
 
 #include "Node.hpp"
+#include "scene/spatial/BVH.hpp"
+#include "scene/spatial/LooseOctree.hpp"
+
+class SubMesh;
+
+struct SceneHit {
+	Node*          node{};
+	const SubMesh* submesh{};
+	uint32_t       triangle{};
+	float          distance{};
+	glm::vec3      position{0.0f};
+};
 
 class Scene : public Entity {
 private:
@@ -21,6 +34,9 @@ private:
 	std::vector<std::unique_ptr<Behaviour>> behaviours;
 	std::vector<Behaviour*>                 tickable_behaviours;
 
+	BVH         static_index;
+	LooseOctree dynamic_index;
+
 public:
 	Scene() = default;
 	Scene(std::string name);
@@ -77,6 +93,18 @@ public:
 
 	Node* findNode(const std::string& name);
 
+	// whether the node or one of its ancestors has behaviours, which may move it
+	static bool isDynamic(const Node& node);
+
+	// mesh instances by world bounds, built on start and updated after behaviours ran; instances
+	// under a node with behaviours go to the dynamic index, which follows movement more cheaply
+	auto getStaticIndex() const -> const BVH&;
+	auto getDynamicIndex() const -> const LooseOctree&;
+
+	// the nearest triangle along a world space ray, boxes from both indices are visited nearest
+	// first and each submesh is traced in its local space; distances are in units of direction
+	auto raycast(const glm::vec3& origin, const glm::vec3& direction, float max_distance) const -> std::optional<SceneHit>;
+
 	void start();
 	void update(float dt);
 };
@@ -1,5 +1,7 @@
 #include "AABB.hpp"
 
+#include <limits>
+
 AABB::AABB() :
     min(0.0f),
     max(0.0f)
@@ -7,9 +9,10 @@ AABB::AABB() :
 	reset();
 }
 
-AABB::AABB(const glm::vec3& min, const glm::vec3& max)
+AABB::AABB(const glm::vec3& min, const glm::vec3& max) :
+    min(min),
+    max(max)
 {
-	reset();
 }
 
 std::type_index AABB::getType()
@@ -33,22 +36,34 @@ void AABB::update(const std::vector<glm::vec3>& vertex_data, const std::vector<u
 			update(vertex_id);
 }
 
+// the box around the eight transformed corners, glm matrices transform column vectors
 void AABB::transform(const glm::mat4& transform)
 {
-	min = max = glm::vec4(min, 1.0f) * transform;
-	update(glm::vec4(min.x, min.y, max.z, 1.0f) * transform);
-	update(glm::vec4(min.x, max.y, min.z, 1.0f) * transform);
-	update(glm::vec4(min.x, max.y, max.z, 1.0f) * transform);
-	update(glm::vec4(max.x, min.y, min.z, 1.0f) * transform);
-	update(glm::vec4(max.x, min.y, max.z, 1.0f) * transform);
-	update(glm::vec4(max.x, max.y, min.z, 1.0f) * transform);
-	update(glm::vec4(max, 1.0f) * transform);
+	if (isEmpty())
+		return;
+
+	auto old_min = min;
+	auto old_max = max;
+
+	reset();
+	for (uint32_t i = 0; i < 8; i++) {
+		glm::vec3 corner = {i & 1 ? old_max.x : old_min.x,
+		                    i & 2 ? old_max.y : old_min.y,
+		                    i & 4 ? old_max.z : old_min.z};
+		update(glm::vec3(transform * glm::vec4(corner, 1.0f)));
+	}
 }
 
+// an empty box that any point grows, numeric_limits has no glm::vec3 specialization
 void AABB::reset()
 {
-	min = std::numeric_limits<glm::vec3>::max();
-	max = std::numeric_limits<glm::vec3>::min();
+	min = glm::vec3(std::numeric_limits<float>::max());
+	max = glm::vec3(std::numeric_limits<float>::lowest());
+}
+
+bool AABB::isEmpty() const
+{
+	return min.x > max.x || min.y > max.y || min.z > max.z;
 }
 
 glm::vec3 AABB::getScale() const
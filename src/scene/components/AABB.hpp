@@ -29,6 +29,7 @@ public:
 	void update(const std::vector<glm::vec3>& vertex_data, const std::vector<uint32_t>& index_data);
 	void transform(const glm::mat4& transform);
 	void reset();
+	bool isEmpty() const;
 
 	glm::vec3 getScale() const;
 	glm::vec3 getCenter() const;
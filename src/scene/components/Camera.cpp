@@ -114,7 +114,7 @@ glm::vec3 PerspectiveCamera::getRight()
 
 glm::mat4 PerspectiveCamera::getProjection()
 {
-	return glm::perspective(glm::radians(fov), aspect_ratio, near_plane, far_plane);
+	return glm::perspective(fov, aspect_ratio, near_plane, far_plane);
 }
 
 OrthoCamera::OrthoCamera(const std::string& name) :
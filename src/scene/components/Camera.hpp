@@ -40,7 +40,7 @@ public:
 class PerspectiveCamera : public Camera {
 private:
 	float aspect_ratio{1.0f};
-	float fov{45.0f};
+	float fov{glm::radians(45.0f)};        // vertical, in radians like glTF
 	float far_plane{100.0f};
 	float near_plane{0.1f};
 
@@ -39,7 +39,7 @@ void Material::setAlphaCutoff(float alpha_cutoff)
 	this->alpha_cutoff = alpha_cutoff;
 }
 
-AlphaMode Material::getAlphaMode()
+AlphaMode Material::getAlphaMode() const
 {
 	return alpha_mode;
 }
@@ -46,7 +46,7 @@ public:
 	float getAlphaCutoff() const;
 	void  setAlphaCutoff(float alpha_cutoff);
 
-	auto getAlphaMode() -> AlphaMode;
+	auto getAlphaMode() const -> AlphaMode;
 	void setAlphaMode(AlphaMode alpha_mode);
 
 	auto getTextures() -> std::unordered_map<std::string, Texture*>&;
@@ -1,5 +1,60 @@
 #include "SubMesh.hpp"
 
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <numeric>
+
+namespace
+{
+uint32_t indexSize(IndexType type)
+{
+	switch (type) {
+		case IndexType::Uint8:
+			return sizeof(uint8_t);
+		case IndexType::Uint16:
+			return sizeof(uint16_t);
+		default:
+			return sizeof(uint32_t);
+	}
+}
+
+template <typename T>
+void storeIndices(std::span<const T> indices, std::vector<uint8_t>& data)
+{
+	data.resize(indices.size() * sizeof(T));
+	std::memcpy(data.data(), indices.data(), data.size());
+}
+
+template <typename T>
+std::vector<uint32_t> widenIndices(const std::vector<uint8_t>& data, uint32_t count)
+{
+	std::vector<T> stored(count);
+	std::memcpy(stored.data(), data.data(), count * sizeof(T));
+	return {stored.begin(), stored.end()};
+}
+
+template <typename T>
+IndexType narrowIndices(std::span<const T> indices, std::vector<uint8_t>& data)
+{
+	uint32_t largest = indices.empty() ? 0 : *std::ranges::max_element(indices);
+
+	if (largest <= std::numeric_limits<uint8_t>::max()) {
+		std::vector<uint8_t> narrow(indices.begin(), indices.end());
+		storeIndices<uint8_t>(narrow, data);
+		return IndexType::Uint8;
+	}
+	if (largest <= std::numeric_limits<uint16_t>::max()) {
+		std::vector<uint16_t> narrow(indices.begin(), indices.end());
+		storeIndices<uint16_t>(narrow, data);
+		return IndexType::Uint16;
+	}
+
+	storeIndices<T>(indices, data);
+	return IndexType::Uint32;
+}
+}        // namespace
+
 SubMesh::SubMesh(const std::string& name) :
     Component{name}
 {}
@@ -28,17 +83,76 @@ void SubMesh::setVertices(std::vector<float> vertex_data, uint32_t count)
 {
 	this->vertex_data = std::move(vertex_data);
 	vertices_count = count;
+	triangle_bvh.reset();
+}
+
+std::vector<uint32_t> SubMesh::getIndices() const
+{
+	switch (index_type) {
+		case IndexType::Uint8:
+			return widenIndices<uint8_t>(index_data, indices_count);
+		case IndexType::Uint16:
+			return widenIndices<uint16_t>(index_data, indices_count);
+		default:
+			return widenIndices<uint32_t>(index_data, indices_count);
+	}
+}
+
+void SubMesh::setIndices(std::span<const uint8_t> indices)
+{
+	index_type = narrowIndices(indices, index_data);
+	indices_count = static_cast<uint32_t>(indices.size());
+	triangle_bvh.reset();
+}
+
+void SubMesh::setIndices(std::span<const uint16_t> indices)
+{
+	index_type = narrowIndices(indices, index_data);
+	indices_count = static_cast<uint32_t>(indices.size());
+	triangle_bvh.reset();
+}
+
+void SubMesh::setIndices(std::span<const uint32_t> indices)
+{
+	index_type = narrowIndices(indices, index_data);
+	indices_count = static_cast<uint32_t>(indices.size());
+	triangle_bvh.reset();
+}
+
+IndexType SubMesh::getIndexType() const
+{
+	return index_type;
 }
 
-auto SubMesh::getIndices() const -> const std::vector<uint32_t>&
+std::span<const uint8_t> SubMesh::getIndexData() const
 {
-	return index_data;
+	return std::span(index_data).first(indices_count * indexSize(index_type));
 }
 
-void SubMesh::setIndices(std::vector<uint32_t> index_data)
+std::span<const Meshlet> SubMesh::getMeshlets() const
 {
-	this->index_data = std::move(index_data);
-	indices_count = static_cast<uint32_t>(this->index_data.size());
+	return meshlets;
+}
+
+void SubMesh::setMeshlets(std::vector<Meshlet> meshlets)
+{
+	this->meshlets = std::move(meshlets);
+}
+
+std::span<const MeshLod> SubMesh::getLods() const
+{
+	return lods;
+}
+
+std::span<const uint32_t> SubMesh::getLodIndices() const
+{
+	return lod_indices;
+}
+
+void SubMesh::setLods(std::vector<MeshLod> lods, std::vector<uint32_t> lod_indices)
+{
+	this->lods = std::move(lods);
+	this->lod_indices = std::move(lod_indices);
 }
 
 auto SubMesh::getAttributes() const -> const std::unordered_map<std::string, VertexAttribute>&
@@ -62,6 +176,55 @@ void SubMesh::setAttribute(const std::string& attribute_name, const VertexAttrib
 	vertex_attributes[attribute_name] = attribute;
 }
 
+// vertices are interleaved with the attributes packed back to back, see SceneLoader::parseSubmesh
+std::vector<glm::vec3> SubMesh::getPositions() const
+{
+	const auto* position = getAttribute("POSITION");
+	if (!position || vertex_data.empty())
+		return {};
+
+	auto stride = std::accumulate(vertex_attributes.begin(), vertex_attributes.end(), 0u, [](uint32_t sum, const auto& pair) {
+		return sum + pair.second.size;
+	});
+
+	auto count = std::min<size_t>(vertices_count, vertex_data.size() * sizeof(float) / stride);
+
+	std::vector<glm::vec3> positions(count);
+	const auto*            data = reinterpret_cast<const uint8_t*>(vertex_data.data());
+	for (size_t i = 0; i < count; i++)
+		std::memcpy(&positions[i], data + i * stride + position->offset, sizeof(glm::vec3));
+
+	return positions;
+}
+
+// unindexed submeshes are a plain triangle list
+const TriangleBVH& SubMesh::getTriangleBvh() const
+{
+	if (!triangle_bvh) {
+		auto positions = getPositions();
+		auto indices = getIndices();
+
+		if (indices.empty()) {
+			indices.resize(positions.size());
+			std::iota(indices.begin(), indices.end(), 0u);
+		}
+
+		triangle_bvh = std::make_unique<TriangleBVH>(positions, indices);
+	}
+
+	return *triangle_bvh;
+}
+
+const AABB& SubMesh::getBounds() const
+{
+	return bounds;
+}
+
+void SubMesh::updateBounds(const std::vector<glm::vec3>& vertex_data, const std::vector<uint32_t>& index_data)
+{
+	bounds.update(vertex_data, index_data);
+}
+
 const Material* SubMesh::getMaterial() const
 {
 	return material;
@@ -1,11 +1,17 @@
 #pragma once
 
+#include <memory>
+#include <span>
 #include <string>
 #include <vector>
 #include <unordered_map>
 
+#include <glm/glm.hpp>
+
 #include "scene/base/Component.hpp"
+#include "AABB.hpp"
 #include "Material.hpp"
+#include "scene/spatial/TriangleBVH.hpp"
 
 struct VertexAttribute {
 	int      format = 0;
@@ -13,6 +19,36 @@ struct VertexAttribute {
 	uint32_t offset = 0;
 };
 
+// a cluster of a submesh's triangles, contiguous in its indices; the cone holds every triangle's
+// normal around cone_axis, cone_cutoff being the sine of its half angle, 1 where it is too wide for
+// all of them to ever face away together
+struct Meshlet {
+	uint32_t  first_index{};
+	uint32_t  index_count{};
+	uint32_t  vertex_count{};
+	glm::vec3 bounds_min{0.0f};
+	glm::vec3 bounds_max{0.0f};
+	glm::vec3 center{0.0f};
+	float     radius{};
+	glm::vec3 cone_axis{0.0f};
+	float     cone_cutoff{1.0f};
+};
+
+// a coarser level of detail over the same vertices, a range of its own indices; error is how far,
+// in local units, its surface may lie from the full detail one
+struct MeshLod {
+	uint32_t first_index{};
+	uint32_t index_count{};
+	float    error{};
+};
+
+// the width of a submesh's indices, the narrowest that holds its largest one
+enum class IndexType : uint8_t {
+	Uint8,
+	Uint16,
+	Uint32,
+};
+
 class SubMesh : public Component {
 private:
 	const Material* material{};
@@ -21,11 +57,22 @@ private:
 	uint32_t vertices_count{0};
 	uint32_t indices_count{0};
 
-	std::vector<float>    vertex_data;
-	std::vector<uint32_t> index_data;
+	std::vector<float>   vertex_data;
+	std::vector<uint8_t> index_data;
+	IndexType            index_type{IndexType::Uint32};
+
+	std::vector<Meshlet> meshlets;
+
+	std::vector<MeshLod>  lods;
+	std::vector<uint32_t> lod_indices;
 
 	std::unordered_map<std::string, VertexAttribute> vertex_attributes;
 
+	AABB bounds;
+
+	// built on the first ray cast, dropped when the geometry changes
+	mutable std::unique_ptr<TriangleBVH> triangle_bvh;
+
 	bool visible{true};
 
 public:
@@ -47,14 +94,42 @@ public:
 	auto getVertices() const -> const std::vector<float>&;
 	void setVertices(std::vector<float> vertex_data, uint32_t count = 0);
 
-	auto getIndices() const -> const std::vector<uint32_t>&;
-	void setIndices(std::vector<uint32_t> index_data);
+	// the indices widened to 32 bits, a copy
+	auto getIndices() const -> std::vector<uint32_t>;
+
+	// stored in the narrowest type that holds the largest index, whatever type they come in
+	void setIndices(std::span<const uint8_t> indices);
+	void setIndices(std::span<const uint16_t> indices);
+	void setIndices(std::span<const uint32_t> indices);
+
+	// the stored indices as they are, getIndicesCount() of getIndexType()
+	auto getIndexType() const -> IndexType;
+	auto getIndexData() const -> std::span<const uint8_t>;
+
+	// empty unless the loader was asked for them; ranges of the indices, so set after them
+	auto getMeshlets() const -> std::span<const Meshlet>;
+	void setMeshlets(std::vector<Meshlet> meshlets);
+
+	// empty unless the loader was asked for them, finest first; the indices stay the full detail
+	auto getLods() const -> std::span<const MeshLod>;
+	auto getLodIndices() const -> std::span<const uint32_t>;
+	void setLods(std::vector<MeshLod> lods, std::vector<uint32_t> lod_indices);
 
 	auto getAttributes() const -> const std::unordered_map<std::string, VertexAttribute>&;
 	auto getAttribute(const std::string& name) -> VertexAttribute*;
 	auto getAttribute(const std::string& name) const -> const VertexAttribute*;
 	void setAttribute(const std::string& name, const VertexAttribute& attribute);
 
+	// the POSITION attribute of every vertex, empty without one
+	auto getPositions() const -> std::vector<glm::vec3>;
+
+	// local space triangles for ray casts, not safe to build from several threads at once
+	auto getTriangleBvh() const -> const TriangleBVH&;
+
+	// local space bounds of the positions, filled by the loader
+	auto getBounds() const -> const AABB&;
+	void updateBounds(const std::vector<glm::vec3>& vertex_data, const std::vector<uint32_t>& index_data = {});
+
 	auto getMaterial() const -> const Material*;
 	void setMaterial(const Material& material);
 
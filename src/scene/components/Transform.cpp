@@ -68,9 +68,22 @@ void Transform::setMatrix(const glm::mat4& matrix)
 	invalidateWorldMatrix();
 }
 
+// an invalid transform has invalid children already, computing a child computes its parent first
 void Transform::invalidateWorldMatrix()
 {
+	version++;
+
+	bool was_valid = !update_world_matrix;
 	update_world_matrix = true;
+
+	if (was_valid)
+		for (auto* child : node.getChildren())
+			child->getTransform().invalidateWorldMatrix();
+}
+
+uint64_t Transform::getVersion() const
+{
+	return version;
 }
 
 void Transform::updateWorldTransform()
@@ -15,6 +15,7 @@ private:
 	glm::vec3 scale{1.0f, 1.0f, 1.0f};
 	glm::mat4 world_matrix{1.0f};
 	bool      update_world_matrix{true};
+	uint64_t  version{};
 
 	void updateWorldTransform();
 
@@ -46,4 +47,7 @@ public:
 	auto getWorldMatrix() -> glm::mat4;
 	void setMatrix(const glm::mat4& matrix);
 	void invalidateWorldMatrix();
+
+	// bumped whenever the world matrix may have changed, including through a parent
+	auto getVersion() const -> uint64_t;
 };
@@ -0,0 +1,353 @@
+#include "BVH.hpp"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <numeric>
+
+#include "math/Frustum.hpp"
+
+namespace
+{
+constexpr uint32_t bin_count = 16;
+constexpr float    infinity = std::numeric_limits<float>::infinity();
+
+float surfaceArea(const glm::vec3& min, const glm::vec3& max)
+{
+	auto size = glm::max(max - min, glm::vec3(0.0f));
+	return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
+}        // namespace
+
+void BVH::build(std::vector<Instance> new_instances)
+{
+	instances = std::move(new_instances);
+	for (auto& instance : instances)
+		updateBounds(instance);
+
+	rebuild();
+}
+
+void BVH::rebuild()
+{
+	auto count = static_cast<uint32_t>(instances.size());
+
+	order.resize(count);
+	std::iota(order.begin(), order.end(), 0u);
+	leaves.assign(count, 0);
+	nodes.clear();
+	parents.clear();
+	built_cost = 0.0f;
+
+	if (count == 0)
+		return;
+
+	nodes.push_back({.first = 0, .count = count});
+	parents.push_back(0);
+	fitNode(0);
+
+	// splits go depth first without recursion, badly distributed scenes can make deep trees
+	std::vector<uint32_t> pending = {0};
+	while (!pending.empty()) {
+		auto node = pending.back();
+		pending.pop_back();
+
+		split(node);
+		if (nodes[node].count == 0) {
+			pending.push_back(nodes[node].first);
+			pending.push_back(nodes[node].first + 1);
+		}
+	}
+
+	for (uint32_t node = 0; node < nodes.size(); node++) {
+		if (nodes[node].count == 0)
+			continue;
+		for (uint32_t i = nodes[node].first; i < nodes[node].first + nodes[node].count; i++)
+			leaves[order[i]] = node;
+	}
+
+	built_cost = getCost();
+}
+
+uint32_t BVH::update()
+{
+	uint32_t refitted = 0;
+
+	for (uint32_t i = 0; i < instances.size(); i++) {
+		if (!isMoved(instances[i]))
+			continue;
+
+		updateBounds(instances[i]);
+		refitted++;
+
+		// ancestors stop changing as soon as one node keeps its bounds
+		for (uint32_t node = leaves[i];; node = parents[node]) {
+			auto previous = nodes[node];
+			fitNode(node);
+
+			if (node == 0 || (previous.min == nodes[node].min && previous.max == nodes[node].max))
+				break;
+		}
+	}
+
+	return refitted;
+}
+
+void BVH::fitNode(uint32_t index)
+{
+	auto& node = nodes[index];
+
+	if (node.count == 0) {
+		const auto& left = nodes[node.first];
+		const auto& right = nodes[node.first + 1];
+		node.min = glm::min(left.min, right.min);
+		node.max = glm::max(left.max, right.max);
+		return;
+	}
+
+	node.min = glm::vec3(infinity);
+	node.max = glm::vec3(-infinity);
+	for (uint32_t i = node.first; i < node.first + node.count; i++) {
+		node.min = glm::min(node.min, instances[order[i]].min);
+		node.max = glm::max(node.max, instances[order[i]].max);
+	}
+}
+
+// binned surface area heuristic over the instance centers, the node stays a leaf when no split is
+// cheaper and it is small enough
+void BVH::split(uint32_t index)
+{
+	auto first = nodes[index].first;
+	auto count = nodes[index].count;
+	if (count <= 1)
+		return;
+
+	auto center = [&](uint32_t i) {
+		return (instances[order[i]].min + instances[order[i]].max) * 0.5f;
+	};
+
+	auto center_min = glm::vec3(infinity);
+	auto center_max = glm::vec3(-infinity);
+	for (uint32_t i = first; i < first + count; i++) {
+		center_min = glm::min(center_min, center(i));
+		center_max = glm::max(center_max, center(i));
+	}
+
+	struct Bin {
+		glm::vec3 min{infinity};
+		glm::vec3 max{-infinity};
+		uint32_t  count{};
+	};
+
+	float    best_cost = infinity;
+	int      best_axis = -1;
+	uint32_t best_bin = 0;
+
+	for (int axis = 0; axis < 3; axis++) {
+		float extent = center_max[axis] - center_min[axis];
+		if (extent <= 0.0f)
+			continue;
+
+		float scale = bin_count / extent;
+		auto  bin_of = [&](float x) {
+			return std::min(static_cast<uint32_t>((x - center_min[axis]) * scale), bin_count - 1);
+		};
+
+		std::array<Bin, bin_count> bins{};
+		for (uint32_t i = first; i < first + count; i++) {
+			auto& bin = bins[bin_of(center(i)[axis])];
+			bin.min = glm::min(bin.min, instances[order[i]].min);
+			bin.max = glm::max(bin.max, instances[order[i]].max);
+			bin.count++;
+		}
+
+		// the cost of splitting after each bin, swept from both ends
+		std::array<float, bin_count - 1>    left_area{};
+		std::array<uint32_t, bin_count - 1> left_count{};
+		Bin                                 sweep{};
+		for (uint32_t b = 0; b < bin_count - 1; b++) {
+			sweep.min = glm::min(sweep.min, bins[b].min);
+			sweep.max = glm::max(sweep.max, bins[b].max);
+			sweep.count += bins[b].count;
+			left_area[b] = surfaceArea(sweep.min, sweep.max);
+			left_count[b] = sweep.count;
+		}
+
+		sweep = {};
+		for (uint32_t b = bin_count - 1; b > 0; b--) {
+			sweep.min = glm::min(sweep.min, bins[b].min);
+			sweep.max = glm::max(sweep.max, bins[b].max);
+			sweep.count += bins[b].count;
+
+			if (left_count[b - 1] == 0 || sweep.count == 0)
+				continue;
+
+			float cost = left_area[b - 1] * left_count[b - 1] + surfaceArea(sweep.min, sweep.max) * sweep.count;
+			if (cost < best_cost) {
+				best_cost = cost;
+				best_axis = axis;
+				best_bin = b - 1;
+			}
+		}
+	}
+
+	// every center in one spot cannot be split
+	if (best_axis < 0)
+		return;
+
+	float leaf_cost = surfaceArea(nodes[index].min, nodes[index].max) * count;
+	if (best_cost >= leaf_cost && count <= max_leaf_size)
+		return;
+
+	float scale = bin_count / (center_max[best_axis] - center_min[best_axis]);
+	auto  middle = std::partition(order.begin() + first, order.begin() + first + count, [&](uint32_t i) {
+		float x = (instances[i].min[best_axis] + instances[i].max[best_axis]) * 0.5f;
+		return std::min(static_cast<uint32_t>((x - center_min[best_axis]) * scale), bin_count - 1) <= best_bin;
+	});
+
+	auto left_count = static_cast<uint32_t>(middle - (order.begin() + first));
+
+	auto left = static_cast<uint32_t>(nodes.size());
+	nodes.push_back({.first = first, .count = left_count});
+	nodes.push_back({.first = first + left_count, .count = count - left_count});
+	parents.push_back(index);
+	parents.push_back(index);
+
+	nodes[index].first = left;
+	nodes[index].count = 0;
+
+	fitNode(left);
+	fitNode(left + 1);
+}
+
+
+// depth first over the nodes whose box passes the test, leaves test each of their instances
+template <typename Test>
+void BVH::collect(Test&& test, std::vector<uint32_t>& result) const
+{
+	if (nodes.empty())
+		return;
+
+	std::vector<uint32_t> stack = {0};
+	while (!stack.empty()) {
+		const auto& node = nodes[stack.back()];
+		stack.pop_back();
+
+		if (!test(node.min, node.max))
+			continue;
+
+		if (node.count == 0) {
+			stack.push_back(node.first);
+			stack.push_back(node.first + 1);
+			continue;
+		}
+
+		for (uint32_t i = node.first; i < node.first + node.count; i++)
+			if (test(instances[order[i]].min, instances[order[i]].max))
+				result.push_back(order[i]);
+	}
+}
+
+void BVH::queryFrustum(const glm::mat4& view_projection, std::vector<uint32_t>& result) const
+{
+	auto planes = extractFrustumPlanes(view_projection);
+	collect([&](const glm::vec3& min, const glm::vec3& max) { return !isOutside(planes, min, max); }, result);
+}
+
+void BVH::queryOverlap(const glm::vec3& min, const glm::vec3& max, std::vector<uint32_t>& result) const
+{
+	collect([&](const glm::vec3& box_min, const glm::vec3& box_max) { return isOverlapping(box_min, box_max, min, max); }, result);
+}
+
+void BVH::querySphere(const glm::vec3& center, float radius, std::vector<uint32_t>& result) const
+{
+	collect([&](const glm::vec3& min, const glm::vec3& max) { return isTouchingSphere(center, radius, min, max); }, result);
+}
+
+void BVH::queryRay(const glm::vec3& origin, const glm::vec3& direction, float max_distance, std::vector<SpatialHit>& result) const
+{
+	auto inverse_direction = 1.0f / direction;
+
+	std::vector<uint32_t> hits;
+	collect([&](const glm::vec3& min, const glm::vec3& max) {
+		return intersect(origin, inverse_direction, max_distance, min, max).has_value();
+	}, hits);
+
+	for (auto i : hits)
+		result.push_back({i, *intersect(origin, inverse_direction, max_distance, instances[i].min, instances[i].max)});
+}
+
+// nearer children are visited first so farther ones are mostly skipped
+std::optional<SpatialHit> BVH::raycast(const glm::vec3& origin, const glm::vec3& direction, float max_distance) const
+{
+	if (nodes.empty())
+		return std::nullopt;
+
+	auto inverse_direction = 1.0f / direction;
+
+	std::optional<SpatialHit> closest;
+	float                 limit = max_distance;
+
+	std::vector<std::pair<uint32_t, float>> stack;
+	if (auto distance = intersect(origin, inverse_direction, limit, nodes[0].min, nodes[0].max))
+		stack.push_back({0, *distance});
+
+	while (!stack.empty()) {
+		auto [index, distance] = stack.back();
+		stack.pop_back();
+
+		if (distance > limit)
+			continue;
+
+		const auto& node = nodes[index];
+		if (node.count > 0) {
+			for (uint32_t i = node.first; i < node.first + node.count; i++) {
+				const auto& instance = instances[order[i]];
+				if (auto hit = intersect(origin, inverse_direction, limit, instance.min, instance.max)) {
+					closest = SpatialHit{order[i], *hit};
+					limit = *hit;
+				}
+			}
+			continue;
+		}
+
+		auto left = intersect(origin, inverse_direction, limit, nodes[node.first].min, nodes[node.first].max);
+		auto right = intersect(origin, inverse_direction, limit, nodes[node.first + 1].min, nodes[node.first + 1].max);
+
+		if (left && right && *left < *right) {
+			stack.push_back({node.first + 1, *right});
+			stack.push_back({node.first, *left});
+			continue;
+		}
+		if (left)
+			stack.push_back({node.first, *left});
+		if (right)
+			stack.push_back({node.first + 1, *right});
+	}
+
+	return closest;
+}
+
+uint32_t BVH::getNodeCount() const
+{
+	return static_cast<uint32_t>(nodes.size());
+}
+
+float BVH::getCost() const
+{
+	if (nodes.empty())
+		return 0.0f;
+
+	float root_area = std::max(surfaceArea(nodes[0].min, nodes[0].max), std::numeric_limits<float>::min());
+
+	float cost = 0.0f;
+	for (const auto& node : nodes)
+		cost += surfaceArea(node.min, node.max) / root_area * (node.count == 0 ? 1.0f : static_cast<float>(node.count));
+
+	return cost;
+}
+
+bool BVH::isDegraded() const
+{
+	return getCost() > built_cost * degraded_cost;
+}
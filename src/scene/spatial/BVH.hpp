@@ -0,0 +1,66 @@
+#pragma once
+
+#include "SpatialIndex.hpp"
+
+// bounding volume hierarchy built with the surface area heuristic; moving nodes refit their leaves
+// instead of rebuilding the tree, which suits scenes where few things move
+class BVH : public SpatialIndex {
+private:
+	// leaves hold order[first, first + count), interior nodes have count 0 and their children at
+	// first and first + 1
+	struct BVHNode {
+		glm::vec3 min{0.0f};
+		uint32_t  first{};
+		glm::vec3 max{0.0f};
+		uint32_t  count{};
+	};
+
+	std::vector<uint32_t> order;
+	std::vector<BVHNode>  nodes;
+	std::vector<uint32_t> parents;
+	std::vector<uint32_t> leaves;
+
+	float built_cost{};
+
+	void fitNode(uint32_t node);
+	void split(uint32_t node);
+
+	template <typename Test>
+	void collect(Test&& test, std::vector<uint32_t>& result) const;
+
+public:
+	static constexpr uint32_t max_leaf_size = 4;
+	static constexpr float    degraded_cost = 2.0f;
+
+	BVH() = default;
+
+	BVH(const BVH&) = delete;
+	BVH& operator=(const BVH&) = delete;
+
+	BVH(BVH&&) noexcept = default;
+	BVH& operator=(BVH&&) noexcept = default;
+
+	~BVH() override = default;
+
+	void build(std::vector<Instance> instances) override;
+
+	// rebuilds the tree over the current instances, worth it once refits have loosened it
+	void rebuild();
+
+	// refits the leaves of moved instances and their ancestors
+	auto update() -> uint32_t override;
+
+	void queryFrustum(const glm::mat4& view_projection, std::vector<uint32_t>& result) const override;
+	void queryOverlap(const glm::vec3& min, const glm::vec3& max, std::vector<uint32_t>& result) const override;
+	void querySphere(const glm::vec3& center, float radius, std::vector<uint32_t>& result) const override;
+	void queryRay(const glm::vec3& origin, const glm::vec3& direction, float max_distance, std::vector<SpatialHit>& result) const override;
+	auto raycast(const glm::vec3& origin, const glm::vec3& direction, float max_distance) const -> std::optional<SpatialHit> override;
+
+	auto getNodeCount() const -> uint32_t;
+
+	// the surface area heuristic cost of the tree relative to its root, grows as refits loosen it
+	auto getCost() const -> float;
+
+	// refits have at least doubled the cost the tree was built with
+	bool isDegraded() const;
+};
@@ -0,0 +1,211 @@
+#include "LooseOctree.hpp"
+
+#include <cmath>
+#include <limits>
+
+#include "math/Frustum.hpp"
+
+size_t LooseOctree::CellHash::operator()(const glm::ivec3& cell) const
+{
+	// large primes spread neighbouring cells across buckets
+	return static_cast<size_t>(cell.x) * 73856093u ^ static_cast<size_t>(cell.y) * 19349663u ^ static_cast<size_t>(cell.z) * 83492791u;
+}
+
+LooseOctree::LooseOctree(float cell_size, uint32_t level_count) :
+    levels(level_count), cell_size(cell_size), level_count(level_count)
+{}
+
+void LooseOctree::build(std::vector<Instance> new_instances)
+{
+	instances = std::move(new_instances);
+
+	for (auto& level : levels)
+		level.clear();
+	oversized.clear();
+	placements.assign(instances.size(), {});
+
+	for (uint32_t i = 0; i < instances.size(); i++) {
+		updateBounds(instances[i]);
+		insert(i, place(instances[i]));
+	}
+}
+
+uint32_t LooseOctree::update()
+{
+	uint32_t moved = 0;
+
+	for (uint32_t i = 0; i < instances.size(); i++) {
+		if (!isMoved(instances[i]))
+			continue;
+
+		updateBounds(instances[i]);
+		moved++;
+
+		auto placement = place(instances[i]);
+		const auto& current = placements[i];
+		if (placement.level == current.level && placement.cell == current.cell)
+			continue;
+
+		remove(i);
+		insert(i, placement);
+	}
+
+	return moved;
+}
+
+// the smallest level whose cells span the instance's largest side, the loose bounds then contain
+// it wherever its center falls inside the cell
+LooseOctree::Placement LooseOctree::place(const Instance& instance) const
+{
+	auto  size = instance.max - instance.min;
+	float extent = std::max({size.x, size.y, size.z});
+
+	Placement placement{};
+	float     edge = cell_size;
+	while (placement.level < level_count && edge < extent) {
+		edge *= 2.0f;
+		placement.level++;
+	}
+
+	if (placement.level < level_count)
+		placement.cell = glm::ivec3(glm::floor((instance.min + instance.max) * 0.5f / edge));
+
+	return placement;
+}
+
+std::vector<uint32_t>& LooseOctree::getItems(const Placement& placement)
+{
+	return placement.level == level_count ? oversized : levels[placement.level][placement.cell];
+}
+
+void LooseOctree::insert(uint32_t index, Placement placement)
+{
+	auto& items = getItems(placement);
+
+	placement.slot = static_cast<uint32_t>(items.size());
+	placements[index] = placement;
+	items.push_back(index);
+}
+
+// the last item of the cell takes the removed one's slot, empty cells are dropped so queries only
+// walk occupied ones
+void LooseOctree::remove(uint32_t index)
+{
+	const auto& placement = placements[index];
+	auto&       items = getItems(placement);
+
+	auto last = items.back();
+	items[placement.slot] = last;
+	placements[last].slot = placement.slot;
+	items.pop_back();
+
+	if (items.empty() && placement.level < level_count)
+		levels[placement.level].erase(placement.cell);
+}
+
+// per level, looks up the cells a finite range covers when there are fewer of them than occupied
+// cells, otherwise walks the occupied cells
+template <typename Test>
+void LooseOctree::collect(Test&& test, std::vector<uint32_t>& result, const glm::vec3& range_min, const glm::vec3& range_max) const
+{
+	auto test_items = [&](const std::vector<uint32_t>& items) {
+		for (auto i : items)
+			if (test(instances[i].min, instances[i].max))
+				result.push_back(i);
+	};
+
+	test_items(oversized);
+
+	for (uint32_t l = 0; l < level_count; l++) {
+		const auto& level = levels[l];
+		if (level.empty())
+			continue;
+
+		float edge = getCellSize(l);
+		auto  test_cell = [&](const glm::ivec3& cell, const std::vector<uint32_t>& items) {
+			auto min = glm::vec3(cell) * edge - edge * 0.5f;
+			if (test(min, min + edge * 2.0f))
+				test_items(items);
+		};
+
+		// a loose cell reaches half a cell past its own
+		auto first = glm::floor((range_min - edge * 0.5f) / edge);
+		auto last = glm::floor((range_max + edge * 0.5f) / edge);
+		auto span = last - first + 1.0f;
+
+		if (!std::isfinite(span.x * span.y * span.z) || span.x * span.y * span.z > static_cast<float>(level.size())) {
+			for (const auto& [cell, items] : level)
+				test_cell(cell, items);
+			continue;
+		}
+
+		for (int z = static_cast<int>(first.z); z <= static_cast<int>(last.z); z++)
+			for (int y = static_cast<int>(first.y); y <= static_cast<int>(last.y); y++)
+				for (int x = static_cast<int>(first.x); x <= static_cast<int>(last.x); x++)
+					if (auto it = level.find({x, y, z}); it != level.end())
+						test_cell(it->first, it->second);
+	}
+}
+
+void LooseOctree::queryFrustum(const glm::mat4& view_projection, std::vector<uint32_t>& result) const
+{
+	constexpr float infinity = std::numeric_limits<float>::infinity();
+
+	auto planes = extractFrustumPlanes(view_projection);
+	collect([&](const glm::vec3& min, const glm::vec3& max) { return !isOutside(planes, min, max); }, result, glm::vec3(-infinity), glm::vec3(infinity));
+}
+
+void LooseOctree::queryOverlap(const glm::vec3& min, const glm::vec3& max, std::vector<uint32_t>& result) const
+{
+	collect([&](const glm::vec3& box_min, const glm::vec3& box_max) { return isOverlapping(box_min, box_max, min, max); }, result, min, max);
+}
+
+void LooseOctree::querySphere(const glm::vec3& center, float radius, std::vector<uint32_t>& result) const
+{
+	collect([&](const glm::vec3& min, const glm::vec3& max) { return isTouchingSphere(center, radius, min, max); }, result, center - radius, center + radius);
+}
+
+void LooseOctree::queryRay(const glm::vec3& origin, const glm::vec3& direction, float max_distance, std::vector<SpatialHit>& result) const
+{
+	auto inverse_direction = 1.0f / direction;
+
+	// a bounded ray only reaches cells around the segment
+	auto end = origin + direction * max_distance;
+	auto range_min = std::isfinite(max_distance) ? glm::min(origin, end) : glm::vec3(-std::numeric_limits<float>::infinity());
+	auto range_max = std::isfinite(max_distance) ? glm::max(origin, end) : glm::vec3(std::numeric_limits<float>::infinity());
+
+	std::vector<uint32_t> hits;
+	collect([&](const glm::vec3& min, const glm::vec3& max) {
+		return intersect(origin, inverse_direction, max_distance, min, max).has_value();
+	}, hits, range_min, range_max);
+
+	for (auto i : hits)
+		result.push_back({i, *intersect(origin, inverse_direction, max_distance, instances[i].min, instances[i].max)});
+}
+
+std::optional<SpatialHit> LooseOctree::raycast(const glm::vec3& origin, const glm::vec3& direction, float max_distance) const
+{
+	std::vector<SpatialHit> hits;
+	queryRay(origin, direction, max_distance, hits);
+
+	std::optional<SpatialHit> closest;
+	for (const auto& hit : hits)
+		if (!closest || hit.distance < closest->distance)
+			closest = hit;
+
+	return closest;
+}
+
+float LooseOctree::getCellSize(uint32_t level) const
+{
+	return std::ldexp(cell_size, static_cast<int>(level));
+}
+
+uint32_t LooseOctree::getCellCount() const
+{
+	size_t count = 0;
+	for (const auto& level : levels)
+		count += level.size();
+
+	return static_cast<uint32_t>(count);
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <unordered_map>
+
+#include "SpatialIndex.hpp"
+
+// hashed loose octree: an instance lives in the one cell of the level whose cells are at least as
+// large as it is, picked by its center, and the cell's bounds are loosened by half a cell each way
+// to hold it; moving means rehashing the center, so relocation costs O(1) however many things move
+class LooseOctree : public SpatialIndex {
+private:
+	struct CellHash {
+		size_t operator()(const glm::ivec3& cell) const;
+	};
+
+	using CellMap = std::unordered_map<glm::ivec3, std::vector<uint32_t>, CellHash>;
+
+	// level_count places the instance with the oversized ones
+	struct Placement {
+		uint32_t   level{};
+		glm::ivec3 cell{0};
+		uint32_t   slot{};
+	};
+
+	std::vector<CellMap>   levels;
+	std::vector<uint32_t>  oversized;
+	std::vector<Placement> placements;
+
+	float    cell_size{};
+	uint32_t level_count{};
+
+	auto place(const Instance& instance) const -> Placement;
+	auto getItems(const Placement& placement) -> std::vector<uint32_t>&;
+	void insert(uint32_t index, Placement placement);
+	void remove(uint32_t index);
+
+	template <typename Test>
+	void collect(Test&& test, std::vector<uint32_t>& result, const glm::vec3& range_min, const glm::vec3& range_max) const;
+
+public:
+	LooseOctree(float cell_size = 1.0f, uint32_t level_count = 12);
+
+	LooseOctree(const LooseOctree&) = delete;
+	LooseOctree& operator=(const LooseOctree&) = delete;
+
+	LooseOctree(LooseOctree&&) noexcept = default;
+	LooseOctree& operator=(LooseOctree&&) noexcept = default;
+
+	~LooseOctree() override = default;
+
+	void build(std::vector<Instance> instances) override;
+
+	// rehashes moved instances, only those that left their cell touch the tables
+	auto update() -> uint32_t override;
+
+	void queryFrustum(const glm::mat4& view_projection, std::vector<uint32_t>& result) const override;
+	void queryOverlap(const glm::vec3& min, const glm::vec3& max, std::vector<uint32_t>& result) const override;
+	void querySphere(const glm::vec3& center, float radius, std::vector<uint32_t>& result) const override;
+	void queryRay(const glm::vec3& origin, const glm::vec3& direction, float max_distance, std::vector<SpatialHit>& result) const override;
+	auto raycast(const glm::vec3& origin, const glm::vec3& direction, float max_distance) const -> std::optional<SpatialHit> override;
+
+	// the edge of level's cells, twice that of the level below
+	auto getCellSize(uint32_t level) const -> float;
+	auto getCellCount() const -> uint32_t;
+};
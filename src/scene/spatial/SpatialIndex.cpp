@@ -0,0 +1,102 @@
+#include "SpatialIndex.hpp"
+
+#include <algorithm>
+
+#include "scene/base/Scene.hpp"
+#include "scene/components/Mesh.hpp"
+
+std::vector<SpatialIndex::Instance> SpatialIndex::collectInstances(const Scene& scene)
+{
+	std::vector<Instance> result;
+	for (const auto* mesh : scene.getComponents<Mesh>())
+		for (auto* node : mesh->getNodes())
+			result.push_back({node, mesh});
+
+	return result;
+}
+
+// meshes without bounds fall back to their submeshes' and then to the node's origin
+void SpatialIndex::updateBounds(Instance& instance)
+{
+	auto& transform = instance.node->getTransform();
+	instance.version = transform.getVersion();
+
+	const auto& mesh_bounds = instance.mesh->getBounds();
+
+	AABB bounds(mesh_bounds.getMin(), mesh_bounds.getMax());
+	if (bounds.isEmpty()) {
+		bounds.reset();
+		for (const auto* submesh : instance.mesh->getSubmeshes()) {
+			if (submesh->getBounds().isEmpty())
+				continue;
+			bounds.update(submesh->getBounds().getMin());
+			bounds.update(submesh->getBounds().getMax());
+		}
+	}
+
+	auto world = transform.getWorldMatrix();
+	if (bounds.isEmpty()) {
+		instance.min = instance.max = glm::vec3(world[3]);
+		return;
+	}
+
+	bounds.transform(world);
+	instance.min = bounds.getMin();
+	instance.max = bounds.getMax();
+}
+
+bool SpatialIndex::isMoved(const Instance& instance)
+{
+	return instance.node->getTransform().getVersion() != instance.version;
+}
+
+const std::vector<SpatialIndex::Instance>& SpatialIndex::getInstances() const
+{
+	return instances;
+}
+
+const SpatialIndex::Instance& SpatialIndex::getInstance(uint32_t index) const
+{
+	return instances[index];
+}
+
+// outside once the corner furthest along a plane's normal lies behind it
+bool SpatialIndex::isOutside(const std::array<glm::vec4, 6>& planes, const glm::vec3& min, const glm::vec3& max)
+{
+	for (const auto& plane : planes) {
+		glm::vec3 corner = {plane.x >= 0.0f ? max.x : min.x, plane.y >= 0.0f ? max.y : min.y, plane.z >= 0.0f ? max.z : min.z};
+		if (glm::dot(glm::vec3(plane), corner) + plane.w < 0.0f)
+			return true;
+	}
+
+	return false;
+}
+
+bool SpatialIndex::isOverlapping(const glm::vec3& a_min, const glm::vec3& a_max, const glm::vec3& b_min, const glm::vec3& b_max)
+{
+	return glm::all(glm::lessThanEqual(a_min, b_max)) && glm::all(glm::lessThanEqual(b_min, a_max));
+}
+
+bool SpatialIndex::isTouchingSphere(const glm::vec3& center, float radius, const glm::vec3& min, const glm::vec3& max)
+{
+	auto offset = center - glm::clamp(center, min, max);
+	return glm::dot(offset, offset) <= radius * radius;
+}
+
+std::optional<float> SpatialIndex::intersect(const glm::vec3& origin, const glm::vec3& inverse_direction, float max_distance,
+                                             const glm::vec3& min, const glm::vec3& max)
+{
+	auto t0 = (min - origin) * inverse_direction;
+	auto t1 = (max - origin) * inverse_direction;
+
+	auto near = glm::min(t0, t1);
+	auto far = glm::max(t0, t1);
+
+	float enter = std::max({near.x, near.y, near.z, 0.0f});
+	float exit = std::min({far.x, far.y, far.z, max_distance});
+
+	if (enter > exit)
+		return std::nullopt;
+
+	return enter;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+class Node;
+class Mesh;
+class Scene;
+
+struct SpatialHit {
+	uint32_t instance{};
+	float    distance{};
+};
+
+// world space bounds of a scene's mesh instances, queried by shape; implementations differ in how
+// cheaply they follow moving nodes
+class SpatialIndex {
+public:
+	struct Instance {
+		Node*       node{};
+		const Mesh* mesh{};
+		glm::vec3   min{0.0f};
+		glm::vec3   max{0.0f};
+		uint64_t    version{};
+	};
+
+protected:
+	std::vector<Instance> instances;
+
+	// the mesh's local box around the node's world matrix, records the transform version it saw
+	static void updateBounds(Instance& instance);
+	static bool isMoved(const Instance& instance);
+
+public:
+	SpatialIndex() = default;
+
+	SpatialIndex(const SpatialIndex&) = delete;
+	SpatialIndex& operator=(const SpatialIndex&) = delete;
+
+	SpatialIndex(SpatialIndex&&) noexcept = default;
+	SpatialIndex& operator=(SpatialIndex&&) noexcept = default;
+
+	virtual ~SpatialIndex() = default;
+
+	// one instance per node of every mesh
+	static auto collectInstances(const Scene& scene) -> std::vector<Instance>;
+
+	virtual void build(std::vector<Instance> instances) = 0;
+
+	// follows instances whose transform changed since the last call, returns how many
+	virtual auto update() -> uint32_t = 0;
+
+	// instances whose box is at least partly inside the frustum
+	virtual void queryFrustum(const glm::mat4& view_projection, std::vector<uint32_t>& result) const = 0;
+	virtual void queryOverlap(const glm::vec3& min, const glm::vec3& max, std::vector<uint32_t>& result) const = 0;
+	virtual void querySphere(const glm::vec3& center, float radius, std::vector<uint32_t>& result) const = 0;
+
+	// every box the ray enters before max_distance, unordered
+	virtual void queryRay(const glm::vec3& origin, const glm::vec3& direction, float max_distance, std::vector<SpatialHit>& result) const = 0;
+
+	// the box the ray enters first
+	virtual auto raycast(const glm::vec3& origin, const glm::vec3& direction, float max_distance) const -> std::optional<SpatialHit> = 0;
+
+	auto getInstances() const -> const std::vector<Instance>&;
+	auto getInstance(uint32_t index) const -> const Instance&;
+
+	// shared by the implementations, planes as extractFrustumPlanes leaves them
+	static bool isOutside(const std::array<glm::vec4, 6>& planes, const glm::vec3& min, const glm::vec3& max);
+	static bool isOverlapping(const glm::vec3& a_min, const glm::vec3& a_max, const glm::vec3& b_min, const glm::vec3& b_max);
+	static bool isTouchingSphere(const glm::vec3& center, float radius, const glm::vec3& min, const glm::vec3& max);
+
+	// distance at which the ray enters the box, none when it misses or enters past max_distance
+	static auto intersect(const glm::vec3& origin, const glm::vec3& inverse_direction, float max_distance,
+	                      const glm::vec3& min, const glm::vec3& max) -> std::optional<float>;
+};
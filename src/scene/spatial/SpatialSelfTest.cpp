@@ -0,0 +1,312 @@
+#include "SpatialSelfTest.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <format>
+#include <memory>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "BVH.hpp"
+#include "LooseOctree.hpp"
+#include "TriangleBVH.hpp"
+#include "math/Frustum.hpp"
+#include "scene/base/Node.hpp"
+#include "scene/components/Mesh.hpp"
+
+namespace
+{
+constexpr uint32_t box_count = 2000;
+constexpr uint32_t query_count = 200;
+constexpr uint32_t triangle_count = 3000;
+
+// unit boxes placed and stretched by their nodes, a few of them far larger than the rest
+struct Boxes {
+	Mesh                               mesh{"box"};
+	std::vector<std::unique_ptr<Node>> nodes;
+
+	explicit Boxes(std::mt19937& random)
+	{
+		mesh.updateBounds({glm::vec3(-0.5f), glm::vec3(0.5f)});
+		for (uint32_t i = 0; i < box_count; i++) {
+			nodes.push_back(std::make_unique<Node>(i, "box"));
+			place(*nodes.back(), random);
+		}
+	}
+
+	static void place(Node& node, std::mt19937& random)
+	{
+		std::uniform_real_distribution<float>   position(-50.0f, 50.0f);
+		std::uniform_real_distribution<float>   size(0.1f, 4.0f);
+		std::uniform_int_distribution<uint32_t> huge(0, 49);
+
+		auto& transform = node.getTransform();
+		transform.setTranslation({position(random), position(random), position(random)});
+		transform.setScale(huge(random) == 0 ? glm::vec3(30.0f) : glm::vec3(size(random), size(random), size(random)));
+	}
+
+	auto getInstances() const -> std::vector<SpatialIndex::Instance>
+	{
+		std::vector<SpatialIndex::Instance> instances;
+		for (const auto& node : nodes)
+			instances.push_back({node.get(), &mesh});
+		return instances;
+	}
+
+	// every tenth box goes somewhere else at another size, returns how many
+	auto move(std::mt19937& random) -> uint32_t
+	{
+		uint32_t moved = 0;
+		for (uint32_t i = 0; i < nodes.size(); i += 10, moved++)
+			place(*nodes[i], random);
+		return moved;
+	}
+};
+
+// indices of the instances passing the test, ascending like a sorted query result
+template <typename Test>
+std::vector<uint32_t> scan(const std::vector<SpatialIndex::Instance>& instances, Test&& test)
+{
+	std::vector<uint32_t> result;
+	for (uint32_t i = 0; i < instances.size(); i++)
+		if (test(instances[i]))
+			result.push_back(i);
+	return result;
+}
+
+std::vector<uint32_t> sorted(std::vector<uint32_t> indices)
+{
+	std::ranges::sort(indices);
+	return indices;
+}
+
+// Moller-Trumbore against every triangle, hitting both faces like TriangleBVH
+std::optional<TriangleHit> traceTriangles(std::span<const glm::vec3> positions, std::span<const uint32_t> indices, const glm::vec3& origin,
+                                          const glm::vec3& direction, float max_distance)
+{
+	std::optional<TriangleHit> closest;
+	for (uint32_t i = 0; i + 2 < indices.size(); i += 3) {
+		const auto& v0 = positions[indices[i]];
+		auto        e1 = positions[indices[i + 1]] - v0;
+		auto        e2 = positions[indices[i + 2]] - v0;
+
+		auto p = glm::cross(direction, e2);
+		auto det = glm::dot(e1, p);
+		if (det == 0.0f)
+			continue;
+
+		auto s = origin - v0;
+		auto q = glm::cross(s, e1);
+
+		float u = glm::dot(s, p) / det;
+		float v = glm::dot(direction, q) / det;
+		float t = glm::dot(e2, q) / det;
+		if (u < 0.0f || v < 0.0f || u + v > 1.0f || t < 0.0f || t >= (closest ? closest->distance : max_distance))
+			continue;
+
+		closest = TriangleHit{i / 3, t, {u, v}};
+	}
+
+	return closest;
+}
+}        // namespace
+
+SpatialSelfTest::SpatialSelfTest() :
+    SelfTest("Spatial")
+{}
+
+void SpatialSelfTest::run()
+{
+	checkBVH();
+	checkLooseOctree();
+	checkTriangleBVH();
+}
+
+// random frusta, boxes, spheres and rays through and around the instances; the index has to return
+// exactly what testing every instance's box returns
+void SpatialSelfTest::checkQueries(std::string_view structure, const SpatialIndex& index, std::mt19937& random)
+{
+	std::uniform_real_distribution<float> position(-60.0f, 60.0f);
+	std::uniform_real_distribution<float> extent(0.0f, 20.0f);
+	std::uniform_real_distribution<float> axis(-1.0f, 1.0f);
+
+	const auto& instances = index.getInstances();
+	auto        projection = glm::perspectiveRH_ZO(glm::radians(60.0f), 1.5f, 0.1f, 80.0f);
+	float       max_distance = 100.0f;
+
+	uint32_t frustum_misses = 0;
+	uint32_t overlap_misses = 0;
+	uint32_t sphere_misses = 0;
+	uint32_t ray_misses = 0;
+	uint32_t raycast_misses = 0;
+
+	std::vector<uint32_t>   result;
+	std::vector<SpatialHit> hits;
+	for (uint32_t query = 0; query < query_count; query++) {
+		glm::vec3 point = {position(random), position(random), position(random)};
+		glm::vec3 size = {extent(random), extent(random), extent(random)};
+		glm::vec3 direction = glm::normalize(glm::vec3(axis(random), axis(random), axis(random)));
+
+		auto view_projection = projection * glm::lookAt(point, point + direction, glm::vec3(0.0f, 1.0f, 0.0f));
+		auto planes = extractFrustumPlanes(view_projection);
+		result.clear();
+		index.queryFrustum(view_projection, result);
+		frustum_misses += sorted(result) != scan(instances, [&](const auto& instance) { return !SpatialIndex::isOutside(planes, instance.min, instance.max); });
+
+		result.clear();
+		index.queryOverlap(point, point + size, result);
+		overlap_misses += sorted(result) != scan(instances, [&](const auto& instance) { return SpatialIndex::isOverlapping(instance.min, instance.max, point, point + size); });
+
+		result.clear();
+		index.querySphere(point, size.x, result);
+		sphere_misses += sorted(result) != scan(instances, [&](const auto& instance) { return SpatialIndex::isTouchingSphere(point, size.x, instance.min, instance.max); });
+
+		auto inverse_direction = 1.0f / direction;
+		auto expected = scan(instances, [&](const auto& instance) {
+			return SpatialIndex::intersect(point, inverse_direction, max_distance, instance.min, instance.max).has_value();
+		});
+
+		hits.clear();
+		index.queryRay(point, direction, max_distance, hits);
+		result.clear();
+		for (const auto& hit : hits)
+			result.push_back(hit.instance);
+		ray_misses += sorted(result) != expected;
+
+		// ties between boxes entered at the same distance may go either way
+		std::optional<float> nearest;
+		for (auto i : expected) {
+			auto distance = *SpatialIndex::intersect(point, inverse_direction, max_distance, instances[i].min, instances[i].max);
+			nearest = std::min(nearest.value_or(distance), distance);
+		}
+
+		auto hit = index.raycast(point, direction, max_distance);
+		if (hit.has_value() != nearest.has_value())
+			raycast_misses++;
+		else if (hit && (hit->distance != *nearest || !std::ranges::binary_search(expected, hit->instance)))
+			raycast_misses++;
+	}
+
+	check(std::format("{} frustum queries match a linear scan", structure), frustum_misses == 0);
+	check(std::format("{} overlap queries match a linear scan", structure), overlap_misses == 0);
+	check(std::format("{} sphere queries match a linear scan", structure), sphere_misses == 0);
+	check(std::format("{} ray queries match a linear scan", structure), ray_misses == 0);
+	check(std::format("{} raycasts find the nearest box", structure), raycast_misses == 0);
+}
+
+void SpatialSelfTest::checkBVH()
+{
+	std::mt19937 random(1);
+	Boxes        boxes(random);
+
+	BVH empty;
+	empty.build({});
+	check("empty BVH hits nothing", !empty.raycast(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, 1.0f), 100.0f));
+
+	BVH bvh;
+	bvh.build(boxes.getInstances());
+	checkQueries("BVH", bvh, random);
+
+	// refitting keeps the tree's grouping, the queries still have to be exact with stretched nodes
+	auto moved = boxes.move(random);
+	check("BVH refits every moved instance", bvh.update() == moved);
+	check("BVH refits nothing when nothing moved", bvh.update() == 0);
+	checkQueries("refitted BVH", bvh, random);
+
+	bvh.rebuild();
+	checkQueries("rebuilt BVH", bvh, random);
+}
+
+void SpatialSelfTest::checkLooseOctree()
+{
+	std::mt19937 random(1);
+	Boxes        boxes(random);
+
+	// the shallow octree's cells stop at 8 units, so its largest boxes live in the oversized list
+	LooseOctree octree;
+	LooseOctree shallow(0.5f, 5);
+	octree.build(boxes.getInstances());
+	shallow.build(boxes.getInstances());
+	checkQueries("octree", octree, random);
+	checkQueries("shallow octree", shallow, random);
+
+	// moved boxes change cells and, with their new sizes, levels
+	auto moved = boxes.move(random);
+	check("octree relocates every moved instance", octree.update() == moved && shallow.update() == moved);
+	check("octree relocates nothing when nothing moved", octree.update() == 0);
+	checkQueries("relocated octree", octree, random);
+	checkQueries("relocated shallow octree", shallow, random);
+}
+
+void SpatialSelfTest::checkTriangleBVH()
+{
+	std::mt19937                            random(1);
+	std::uniform_real_distribution<float>   position(-20.0f, 20.0f);
+	std::uniform_real_distribution<float>   offset(-1.5f, 1.5f);
+	std::uniform_real_distribution<float>   axis(-1.0f, 1.0f);
+	std::uniform_int_distribution<uint32_t> pick(0, triangle_count - 1);
+
+	std::vector<glm::vec3> positions;
+	std::vector<uint32_t>  indices;
+	for (uint32_t i = 0; i < triangle_count; i++) {
+		glm::vec3 corner = {position(random), position(random), position(random)};
+		positions.push_back(corner);
+		positions.push_back(corner + glm::vec3(offset(random), offset(random), offset(random)));
+		positions.push_back(corner + glm::vec3(offset(random), offset(random), offset(random)));
+		indices.insert(indices.end(), {i * 3, i * 3 + 1, i * 3 + 2});
+	}
+
+	TriangleBVH bvh(positions, indices);
+	check("triangle BVH keeps every triangle", bvh.getTriangleCount() == triangle_count);
+
+	float    max_distance = 60.0f;
+	uint32_t raycast_misses = 0;
+	uint32_t intersect_misses = 0;
+	uint32_t limit_misses = 0;
+	for (uint32_t query = 0; query < query_count; query++) {
+		glm::vec3 origin = glm::vec3(position(random), position(random), position(random)) * 1.5f;
+
+		// half the rays aim at a triangle's center so most of them hit something
+		auto        triangle = pick(random) * 3;
+		const auto* corners = &positions[triangle];
+		auto        target = query % 2 == 0 ? (corners[0] + corners[1] + corners[2]) / 3.0f : origin + glm::vec3(axis(random), axis(random), axis(random));
+		auto        direction = glm::normalize(target - origin);
+
+		auto expected = traceTriangles(positions, indices, origin, direction, max_distance);
+		auto hit = bvh.raycast(origin, direction, max_distance);
+
+		// overlapping triangles at the same distance may go either way
+		if (hit.has_value() != expected.has_value())
+			raycast_misses++;
+		else if (hit && std::abs(hit->distance - expected->distance) > 1e-4f * std::max(1.0f, expected->distance))
+			raycast_misses++;
+		else if (hit && hit->triangle == expected->triangle && glm::length(hit->barycentric - expected->barycentric) > 1e-4f)
+			raycast_misses++;
+
+		intersect_misses += bvh.intersects(origin, direction, max_distance) != expected.has_value();
+
+		// nothing lies before the nearest triangle
+		if (expected)
+			limit_misses += bvh.intersects(origin, direction, expected->distance * 0.5f) || bvh.raycast(origin, direction, expected->distance * 0.5f);
+	}
+
+	check("triangle raycasts find the nearest triangle", raycast_misses == 0);
+	check("triangle intersection tests match a linear scan", intersect_misses == 0);
+	check("triangle rays stop at their maximum distance", limit_misses == 0);
+
+	// triangles with indices past the positions are dropped without renumbering the rest
+	std::vector<glm::vec3> quad = {{-1.0f, -1.0f, 0.0f}, {1.0f, -1.0f, 0.0f}, {1.0f, 1.0f, 0.0f}, {-1.0f, 1.0f, 0.0f}};
+	std::vector<uint32_t>  broken = {0, 1, 7, 0, 2, 3};
+
+	TriangleBVH partial(quad, broken);
+	auto        partial_hit = partial.raycast({-0.5f, 0.5f, -1.0f}, {0.0f, 0.0f, 1.0f}, 10.0f);
+	check("triangle BVH skips out of range indices", partial.getTriangleCount() == 1 && partial_hit && partial_hit->triangle == 1);
+	check("triangle BVH misses beside the kept triangle", !partial.intersects({0.5f, -0.5f, -1.0f}, {0.0f, 0.0f, 1.0f}, 10.0f));
+
+	TriangleBVH empty({}, {});
+	check("empty triangle BVH hits nothing", !empty.intersects(glm::vec3(0.0f), {0.0f, 0.0f, 1.0f}, 10.0f));
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <random>
+#include <string_view>
+
+#include "SelfTest.hpp"
+
+class SpatialIndex;
+
+// the spatial indices against a linear scan over the same boxes, once built and again after the
+// nodes under them move, and the triangle BVH against testing every triangle
+class SpatialSelfTest : public SelfTest {
+private:
+	void checkQueries(std::string_view structure, const SpatialIndex& index, std::mt19937& random);
+	void checkBVH();
+	void checkLooseOctree();
+	void checkTriangleBVH();
+
+public:
+	SpatialSelfTest();
+
+	void run() override;
+};
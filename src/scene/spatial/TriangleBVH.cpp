@@ -0,0 +1,296 @@
+#include "TriangleBVH.hpp"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <numeric>
+
+#include "SpatialIndex.hpp"
+#include "math/Float8.hpp"
+
+namespace
+{
+constexpr uint32_t bin_count = 12;
+constexpr float    infinity = std::numeric_limits<float>::infinity();
+
+float surfaceArea(const glm::vec3& min, const glm::vec3& max)
+{
+	auto size = glm::max(max - min, glm::vec3(0.0f));
+	return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
+}        // namespace
+
+// binned surface area heuristic like BVH, except that leaves must fit a packet
+TriangleBVH::TriangleBVH(std::span<const glm::vec3> positions, std::span<const uint32_t> indices)
+{
+	std::vector<glm::vec3> bounds_min;
+	std::vector<glm::vec3> bounds_max;
+	std::vector<glm::vec3> centers;
+	std::vector<uint32_t>  triangles;
+
+	for (uint32_t i = 0; i + 2 < indices.size(); i += 3) {
+		if (indices[i] >= positions.size() || indices[i + 1] >= positions.size() || indices[i + 2] >= positions.size())
+			continue;
+
+		const auto& a = positions[indices[i]];
+		const auto& b = positions[indices[i + 1]];
+		const auto& c = positions[indices[i + 2]];
+
+		bounds_min.push_back(glm::min(glm::min(a, b), c));
+		bounds_max.push_back(glm::max(glm::max(a, b), c));
+		centers.push_back((bounds_min.back() + bounds_max.back()) * 0.5f);
+		triangles.push_back(i / 3);
+	}
+
+	triangle_count = static_cast<uint32_t>(triangles.size());
+	if (triangle_count == 0)
+		return;
+
+	std::vector<uint32_t> order(triangle_count);
+	std::iota(order.begin(), order.end(), 0u);
+
+	auto fit = [&](TriangleNode& node) {
+		node.min = glm::vec3(infinity);
+		node.max = glm::vec3(-infinity);
+		for (uint32_t i = node.first; i < node.first + node.count; i++) {
+			node.min = glm::min(node.min, bounds_min[order[i]]);
+			node.max = glm::max(node.max, bounds_max[order[i]]);
+		}
+	};
+
+	nodes.push_back({.first = 0, .count = triangle_count});
+	fit(nodes[0]);
+
+	std::vector<uint32_t> pending = {0};
+	while (!pending.empty()) {
+		auto index = pending.back();
+		pending.pop_back();
+
+		// a packet is tested at once whether or not its lanes are full, so anything that fits one stays
+		auto first = nodes[index].first;
+		auto count = nodes[index].count;
+		if (count <= packet_size)
+			continue;
+
+		auto center_min = glm::vec3(infinity);
+		auto center_max = glm::vec3(-infinity);
+		for (uint32_t i = first; i < first + count; i++) {
+			center_min = glm::min(center_min, centers[order[i]]);
+			center_max = glm::max(center_max, centers[order[i]]);
+		}
+
+		struct Bin {
+			glm::vec3 min{infinity};
+			glm::vec3 max{-infinity};
+			uint32_t  count{};
+		};
+
+		float    best_cost = infinity;
+		int      best_axis = -1;
+		uint32_t best_bin = 0;
+
+		for (int axis = 0; axis < 3; axis++) {
+			float extent = center_max[axis] - center_min[axis];
+			if (extent <= 0.0f)
+				continue;
+
+			std::array<Bin, bin_count> bins{};
+			for (uint32_t i = first; i < first + count; i++) {
+				auto  b = std::min(static_cast<uint32_t>((centers[order[i]][axis] - center_min[axis]) * (bin_count / extent)), bin_count - 1);
+				auto& bin = bins[b];
+				bin.min = glm::min(bin.min, bounds_min[order[i]]);
+				bin.max = glm::max(bin.max, bounds_max[order[i]]);
+				bin.count++;
+			}
+
+			std::array<float, bin_count - 1>    left_area{};
+			std::array<uint32_t, bin_count - 1> left_count{};
+			Bin                                 sweep{};
+			for (uint32_t b = 0; b < bin_count - 1; b++) {
+				sweep.min = glm::min(sweep.min, bins[b].min);
+				sweep.max = glm::max(sweep.max, bins[b].max);
+				sweep.count += bins[b].count;
+				left_area[b] = surfaceArea(sweep.min, sweep.max);
+				left_count[b] = sweep.count;
+			}
+
+			sweep = {};
+			for (uint32_t b = bin_count - 1; b > 0; b--) {
+				sweep.min = glm::min(sweep.min, bins[b].min);
+				sweep.max = glm::max(sweep.max, bins[b].max);
+				sweep.count += bins[b].count;
+
+				if (left_count[b - 1] == 0 || sweep.count == 0)
+					continue;
+
+				float cost = left_area[b - 1] * left_count[b - 1] + surfaceArea(sweep.min, sweep.max) * sweep.count;
+				if (cost < best_cost) {
+					best_cost = cost;
+					best_axis = axis;
+					best_bin = b - 1;
+				}
+			}
+		}
+
+		// with every center in one spot the halves are split by position in the list
+		uint32_t left_count = count / 2;
+		if (best_axis >= 0) {
+			float scale = bin_count / (center_max[best_axis] - center_min[best_axis]);
+			auto  middle = std::partition(order.begin() + first, order.begin() + first + count, [&](uint32_t i) {
+				return std::min(static_cast<uint32_t>((centers[i][best_axis] - center_min[best_axis]) * scale), bin_count - 1) <= best_bin;
+			});
+			left_count = static_cast<uint32_t>(middle - (order.begin() + first));
+		}
+
+		auto left = static_cast<uint32_t>(nodes.size());
+		nodes.push_back({.first = first, .count = left_count});
+		nodes.push_back({.first = first + left_count, .count = count - left_count});
+		fit(nodes[left]);
+		fit(nodes[left + 1]);
+
+		nodes[index].first = left;
+		nodes[index].count = 0;
+
+		pending.push_back(left);
+		pending.push_back(left + 1);
+	}
+
+	for (auto& node : nodes) {
+		if (node.count == 0)
+			continue;
+
+		TrianglePacket packet{};
+		for (uint32_t lane = 0; lane < node.count; lane++) {
+			auto triangle = triangles[order[node.first + lane]];
+
+			const auto& v0 = positions[indices[triangle * 3]];
+			auto        e1 = positions[indices[triangle * 3 + 1]] - v0;
+			auto        e2 = positions[indices[triangle * 3 + 2]] - v0;
+
+			for (int axis = 0; axis < 3; axis++) {
+				packet.v0[axis][lane] = v0[axis];
+				packet.e1[axis][lane] = e1[axis];
+				packet.e2[axis][lane] = e2[axis];
+			}
+			packet.triangle[lane] = triangle;
+		}
+
+		node.first = static_cast<uint32_t>(packets.size());
+		packets.push_back(packet);
+	}
+}
+
+std::optional<TriangleHit> TriangleBVH::raycast(const glm::vec3& origin, const glm::vec3& direction, float max_distance) const
+{
+	return trace(origin, direction, max_distance, false);
+}
+
+bool TriangleBVH::intersects(const glm::vec3& origin, const glm::vec3& direction, float max_distance) const
+{
+	return trace(origin, direction, max_distance, true).has_value();
+}
+
+// Moller-Trumbore against the eight triangles of a leaf at once, nearer children first
+std::optional<TriangleHit> TriangleBVH::trace(const glm::vec3& origin, const glm::vec3& direction, float max_distance, bool any) const
+{
+	if (nodes.empty())
+		return std::nullopt;
+
+	auto inverse_direction = 1.0f / direction;
+
+	std::array<Float8, 3> ray_origin = {Float8::broadcast(origin.x), Float8::broadcast(origin.y), Float8::broadcast(origin.z)};
+	std::array<Float8, 3> ray_direction = {Float8::broadcast(direction.x), Float8::broadcast(direction.y), Float8::broadcast(direction.z)};
+
+	auto zero = Float8::broadcast(0.0f);
+	auto one = Float8::broadcast(1.0f);
+
+	std::optional<TriangleHit> closest;
+	float                      limit = max_distance;
+
+	std::vector<std::pair<uint32_t, float>> stack;
+	if (auto distance = SpatialIndex::intersect(origin, inverse_direction, limit, nodes[0].min, nodes[0].max))
+		stack.push_back({0, *distance});
+
+	while (!stack.empty()) {
+		auto [index, distance] = stack.back();
+		stack.pop_back();
+
+		if (distance > limit)
+			continue;
+
+		const auto& node = nodes[index];
+		if (node.count == 0) {
+			const auto& left = nodes[node.first];
+			const auto& right = nodes[node.first + 1];
+
+			auto left_distance = SpatialIndex::intersect(origin, inverse_direction, limit, left.min, left.max);
+			auto right_distance = SpatialIndex::intersect(origin, inverse_direction, limit, right.min, right.max);
+
+			if (left_distance && right_distance && *left_distance < *right_distance) {
+				stack.push_back({node.first + 1, *right_distance});
+				stack.push_back({node.first, *left_distance});
+				continue;
+			}
+			if (left_distance)
+				stack.push_back({node.first, *left_distance});
+			if (right_distance)
+				stack.push_back({node.first + 1, *right_distance});
+			continue;
+		}
+
+		const auto& packet = packets[node.first];
+
+		std::array<Float8, 3> e1 = {Float8::load(packet.e1[0]), Float8::load(packet.e1[1]), Float8::load(packet.e1[2])};
+		std::array<Float8, 3> e2 = {Float8::load(packet.e2[0]), Float8::load(packet.e2[1]), Float8::load(packet.e2[2])};
+
+		auto& d = ray_direction;
+		Float8 p[3] = {d[1] * e2[2] - d[2] * e2[1], d[2] * e2[0] - d[0] * e2[2], d[0] * e2[1] - d[1] * e2[0]};
+
+		auto det = e1[0] * p[0] + e1[1] * p[1] + e1[2] * p[2];
+		auto inverse_det = one / det;
+
+		Float8 s[3] = {ray_origin[0] - Float8::load(packet.v0[0]), ray_origin[1] - Float8::load(packet.v0[1]), ray_origin[2] - Float8::load(packet.v0[2])};
+		Float8 q[3] = {s[1] * e1[2] - s[2] * e1[1], s[2] * e1[0] - s[0] * e1[2], s[0] * e1[1] - s[1] * e1[0]};
+
+		auto u = (s[0] * p[0] + s[1] * p[1] + s[2] * p[2]) * inverse_det;
+		auto v = (d[0] * q[0] + d[1] * q[1] + d[2] * q[2]) * inverse_det;
+		auto t = (e2[0] * q[0] + e2[1] * q[1] + e2[2] * q[2]) * inverse_det;
+
+		// parallel rays and the empty lanes have no determinant, the comparisons against their NaNs fail
+		auto hit = (det * det > zero) & (u >= zero) & (v >= zero) & (one >= u + v) & (t >= zero) & (Float8::broadcast(limit) > t);
+
+		auto lanes = hit.getBits();
+		if (lanes == 0)
+			continue;
+
+		std::array<float, packet_size> distances;
+		std::array<float, packet_size> us;
+		std::array<float, packet_size> vs;
+		t.store(distances.data());
+		u.store(us.data());
+		v.store(vs.data());
+
+		for (uint32_t lane = 0; lane < node.count; lane++) {
+			if (!((lanes >> lane) & 1) || distances[lane] >= limit)
+				continue;
+
+			closest = TriangleHit{packet.triangle[lane], distances[lane], {us[lane], vs[lane]}};
+			limit = distances[lane];
+		}
+
+		if (any)
+			return closest;
+	}
+
+	return closest;
+}
+
+uint32_t TriangleBVH::getTriangleCount() const
+{
+	return triangle_count;
+}
+
+uint32_t TriangleBVH::getNodeCount() const
+{
+	return static_cast<uint32_t>(nodes.size());
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+struct TriangleHit {
+	uint32_t  triangle{};
+	float     distance{};
+	glm::vec2 barycentric{0.0f};
+};
+
+// bounding volume hierarchy over a mesh's triangles in its local space; each leaf stores up to eight
+// triangles side by side so a ray is tested against all of them at once
+class TriangleBVH {
+private:
+	static constexpr uint32_t packet_size = 8;
+
+	// a corner and the two edges leaving it, one lane per triangle; unused lanes have no area
+	struct alignas(32) TrianglePacket {
+		float    v0[3][packet_size]{};
+		float    e1[3][packet_size]{};
+		float    e2[3][packet_size]{};
+		uint32_t triangle[packet_size]{};
+	};
+
+	// leaves have count > 0 triangles in packets[first], interior nodes have their children at first
+	// and first + 1
+	struct TriangleNode {
+		glm::vec3 min{0.0f};
+		uint32_t  first{};
+		glm::vec3 max{0.0f};
+		uint32_t  count{};
+	};
+
+	std::vector<TriangleNode>   nodes;
+	std::vector<TrianglePacket> packets;
+
+	uint32_t triangle_count{};
+
+	// the nearest hit closer than max_distance, or any hit when any is set
+	auto trace(const glm::vec3& origin, const glm::vec3& direction, float max_distance, bool any) const -> std::optional<TriangleHit>;
+
+public:
+	TriangleBVH(std::span<const glm::vec3> positions, std::span<const uint32_t> indices);
+
+	TriangleBVH(const TriangleBVH&) = delete;
+	TriangleBVH& operator=(const TriangleBVH&) = delete;
+
+	TriangleBVH(TriangleBVH&&) noexcept = default;
+	TriangleBVH& operator=(TriangleBVH&&) noexcept = default;
+
+	~TriangleBVH() = default;
+
+	// distances are in units of direction, which need not be normalized, so a ray transformed into
+	// local space keeps its distances
+	auto raycast(const glm::vec3& origin, const glm::vec3& direction, float max_distance) const -> std::optional<TriangleHit>;
+
+	// stops at the first hit, enough for line of sight
+	bool intersects(const glm::vec3& origin, const glm::vec3& direction, float max_distance) const;
+
+	auto getTriangleCount() const -> uint32_t;
+	auto getNodeCount() const -> uint32_t;
+};